@@ -7,10 +7,11 @@
  * - WiFi connectivity with SSID/Password
  * - Numeric keypad input (0-9 + Enter)
  * - SH1106 OLED display (128x64)
- * - REST API communication with backend server
+ * - REST API communication with backend server (network task on core 0)
  * - Active UART communication with Pico microcontroller
  * - Print job status tracking and updates
  * - Real-time message buffering and processing
+ * - Job changes pushed over a Realtime websocket (local index + prefetch)
  * - Echo test mode (press 0-0-0 for diagnostics)
  * 
  * Pin Configuration:
@@ -34,14 +35,29 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SH110X.h>
 #include "config.h"
+#include "connection_pool.h"
+#include "job_json.h"
+#include "status_outbox.h"
+#include "job_index.h"
+#include "file_cache.h"
+#include "http_range.h"
+#include "realtime_client.h"
+#include "oled_diff.h"
+#include "screen_templates.h"
+#include "print_progress.h"
+#include "keypad_driver.h"
+#include "inplace_string.h"
 
 // ============= DISPLAY SETUP =============
 Adafruit_SH1106G display(128, 64, &Wire, -1);
+OledPresenter oled;  // Sends changed bytes of display's buffer from a background task
+ScreenTemplates screens;  // Static text of every screen, rasterized at boot
 
 // ============= GLOBAL STATE VARIABLES =============
-String currentPrintId = "";
+InplaceString<MAX_PRINT_ID_LENGTH> currentPrintId;
 DisplayState currentState = STATE_WELCOME;
 unsigned long lastInteractionTime = 0;
+unsigned long successShownAt = 0;  // STATE_SUCCESS returns to welcome SUCCESS_SCREEN_MS later
 bool wifiConnected = false;
 bool picoConnected = false;
 
@@ -52,6 +68,135 @@ char picoRxBuffer[PICO_RX_BUFFER_SIZE];
 int picoRxIndex = 0;
 unsigned long lastPicoMessageTime = 0;
 
+// ============= NETWORK TASK =============
+// HTTP runs on its own task; loop() posts requests and consumes completions
+// through fixed-size queue items, so it never blocks on the network
+enum NetRequestType {
+  NET_FETCH_JOB,
+  NET_FLUSH_OUTBOX,   // Wake-up only: the update itself is already in the outbox
+  NET_SYNC_INDEX,     // Wake-up: push (re)subscribed, catch up on missed changes
+  NET_PREFETCH,       // Wake-up: push changed a job, look for files to prefetch
+  NET_SEND_FILES      // The Pico is ready for the job's files
+};
+
+enum NetResult {
+  NET_OK,
+  NET_NO_WIFI,
+  NET_NOT_FOUND,      // 404 or success=false
+  NET_EXPIRED,        // 410
+  NET_PARSE_ERROR,
+  NET_HTTP_ERROR
+};
+
+struct NetRequest {
+  NetRequestType type;
+  char printId[MAX_PRINT_ID_LENGTH + 1];
+  int fileCount;      // NET_SEND_FILES
+};
+
+// Pico consumed `bytes` of file `file` ("[Pico] FILE_ACK <file> <bytes>")
+struct PicoFileAck {
+  int file;
+  uint32_t bytes;
+};
+
+// A command line for the Pico, queued by sendToPico()
+struct PicoLine {
+  char text[PICO_COMMAND_MAX + 1];
+};
+
+struct NetResponse {
+  NetRequestType type;
+  char printId[MAX_PRINT_ID_LENGTH + 1];
+  NetResult result;
+  int httpCode;
+  int fileCount;
+  int cachedFiles;    // Of fileCount, already in the on-device cache
+};
+
+// Feeds an HTTP body straight into the job parser; HTTPClient::writeToStream
+// takes care of Content-Length and chunked framing
+class JobJsonSink : public Stream {
+public:
+  explicit JobJsonSink(JobJsonParser& parser) : parser(parser) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t len) override {
+    bytes += len;
+    return parser.feed((const char*)buf, len) ? len : 0;  // 0 aborts the transfer
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override {}
+  size_t bytes = 0;
+
+private:
+  JobJsonParser& parser;
+};
+
+// Collects a response body into a fixed buffer (no String growth)
+class BufferSink : public Stream {
+public:
+  BufferSink(char* buf, size_t size) : buf(buf), size(size) {}
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* data, size_t n) override {
+    if (len + n > size) {
+      overflow = true;
+      return 0;  // Aborts the transfer
+    }
+    memcpy(buf + len, data, n);
+    len += n;
+    return n;
+  }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+  void flush() override {}
+  size_t len = 0;
+  bool overflow = false;
+
+private:
+  char* buf;
+  size_t size;
+};
+
+typedef InplaceString<160> ApiUrl;  // API_BASE_URL plus path and query
+
+QueueHandle_t netRequestQueue = NULL;
+QueueHandle_t netResponseQueue = NULL;
+QueueHandle_t picoFileAckQueue = NULL;  // Latest FILE_ACK (one-slot mailbox) for sendJobFiles
+QueueHandle_t picoTxQueue = NULL;  // Command lines waiting for the Pico link
+SemaphoreHandle_t picoTxMutex = NULL;  // Held to write PICO_SERIAL; sendJobFiles holds it per file
+ConnectionPool apiPool;  // Keep-alive TLS to API_BASE_URL; network task only
+StatusOutbox statusOutbox;  // Undelivered status updates, persisted in NVS
+SemaphoreHandle_t outboxMutex = NULL;
+JobIndex jobIndex;          // PENDING jobs + recent 404/410 IDs, delta-synced
+SemaphoreHandle_t jobIndexMutex = NULL;
+unsigned long nextIndexSync = 0;  // Network task only
+unsigned long lastIndexSync = 0;
+FileCache fileCache;        // Prefetched files of PENDING jobs; network task only
+volatile uint32_t pinnedPrintId = 0;  // Job being printed: its cached files stay
+unsigned long nextPrefetch = 0;
+unsigned long lastPrefetchRequest = 0;
+RealtimeClient realtime;    // Job change push; realtime task only
+unsigned long lastSpinnerTime = 0;
+int spinnerFrame = 0;
+PrintProgress printProgress;  // Page/band reports of the running job
+unsigned long lastProgressDraw = 0;
+int drawnProgressPercent = -1;
+int32_t drawnProgressEta = -1;
+
+// ============= BOOT TIMELINE =============
+// Per-stage startup timestamps (ms since reset), reported as one record
+#define BOOT_STAGE_MAX 10
+struct BootStage {
+  const char* name;
+  unsigned long ms;
+};
+BootStage bootStages[BOOT_STAGE_MAX];
+int bootStageCount = 0;
+bool bootTimelineReported = false;
+
 // ============= BUTTON CONFIGURATION =============
 const int buttonPins[11] = {
   BUTTON_0_PIN, BUTTON_1_PIN, BUTTON_2_PIN, BUTTON_3_PIN, BUTTON_4_PIN,
@@ -63,9 +208,12 @@ const char* buttonLabels[11] = {
   "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "ENTER"
 };
 
+KeypadDriver keypad;        // Edge interrupts + debounce timer -> event queue
+uint32_t keyLatencyMaxUs = 0;  // First edge to handleButtonPress()
+
 // ============= TEST MODE VARIABLES =============
 unsigned long lastButtonTime = 0;
-String debugSequence = "";
+int debugZeroCount = 0;  // Consecutive 0 presses; 0-0-0 runs diagnostics
 
 // ============= FORWARD DECLARATIONS =============
 void initializeDisplay();
@@ -78,14 +226,26 @@ void processPicoMessages();
 void displayWelcomeScreen();
 void displayInputScreen();
 void displayFetchingScreen();
+void displayJobFoundScreen(int fileCount);
 void displayPrintingScreen();
 void displaySuccessScreen();
-void displayErrorScreen(String message);
+void displayErrorScreen(const char* message);
 void displayIdleScreen();
-void fetchPrintJob(String printId);
-void sendToPico(String command);
+void fetchPrintJob(const char* printId);
+void startNetworkTask();
+void networkTask(void* param);
+void realtimeTask(void* param);
+void processNetResponses();
+void updateFetchingSpinner();
+void updatePrintingProgress();
+void drawPrintingProgress();
+void sendToPico(const char* command);
+void flushPicoTx();
 void testPicoCommunication();
-void updatePrintJobStatus(String printId, String status, String errorMsg = "");
+void updatePrintJobStatus(const char* printId, const char* status, const char* errorMsg = "");
+void bootMark(const char* stage);
+void reportBootTimeline();
+void oledPush();
 
 /**
  * ============= SETUP FUNCTION =============
@@ -94,7 +254,10 @@ void updatePrintJobStatus(String printId, String status, String errorMsg = "");
 void setup() {
   // Initialize serial communication with computer
   Serial.begin(115200);
+#if !FAST_BOOT
   delay(1000);
+#endif
+  bootMark("serial");
   
   Serial.println("\n\n========================================");
   Serial.println("[SYSTEM] Printosk ESP32 Kiosk Starting...");
@@ -102,15 +265,32 @@ void setup() {
   Serial.println("[SYSTEM] Version: Final (Feb 1, 2026)");
   Serial.println("[SYSTEM] Commit: dbae7b3");
   
+#if FAST_BOOT
+  // WiFi first: association runs in the background while the display and
+  // keypad come up, so the welcome screen is not held behind it
+  initializeWiFi();
+  bootMark("wifi_begin");
+  startNetworkTask();
+  initializeDisplay();
+  bootMark("display");
+  displayWelcomeScreen();
+  bootMark("ui");
+  initializeButtons();
+  bootMark("buttons");
+  initializeSerial();
+  bootMark("pico_uart");
+#else
   // Initialize all components in order
   initializeDisplay();
   initializeButtons();
   initializeSerial();
   initializeWiFi();
+  startNetworkTask();
   
   // Show welcome screen on display
-  display.clearDisplay();
   displayWelcomeScreen();
+  bootMark("ui");
+#endif
   
   Serial.println("[SYSTEM] Setup Complete!");
   Serial.println("========================================\n");
@@ -125,7 +305,9 @@ void loop() {
   if (WiFi.status() == WL_CONNECTED) {
     if (!wifiConnected) {
       wifiConnected = true;
-      Serial.println("[WiFi] Connected!");
+      Serial.print("[WiFi] Connected! IP Address: ");
+      Serial.println(WiFi.localIP());
+      bootMark("wifi");
     }
   } else {
     if (wifiConnected) {
@@ -135,19 +317,43 @@ void loop() {
     }
   }
   
+  // ===== BOOT TIMELINE =====
+  // Reported once WiFi is up, or after WIFI_CONNECT_TIMEOUT without it
+  if (!bootTimelineReported && (wifiConnected || millis() > WIFI_CONNECT_TIMEOUT)) {
+    reportBootTimeline();
+  }
+  
   // ===== ACTIVE LISTENING FOR PICO =====
   // Process ALL available messages from Pico UART
   // This ensures no messages are missed due to timing
   processPicoMessages();
+  flushPicoTx();
+  
+  // ===== NETWORK COMPLETIONS =====
+  processNetResponses();
+  if (currentState == STATE_FETCHING) {
+    updateFetchingSpinner();
+  } else if (currentState == STATE_PRINTING) {
+    updatePrintingProgress();
+  }
   
   // ===== HANDLE USER INPUT =====
   handleKeypadInput();
   
+  if (currentState == STATE_SUCCESS && millis() - successShownAt >= SUCCESS_SCREEN_MS) {
+    currentState = STATE_WELCOME;
+    displayWelcomeScreen();
+  }
+  
   // ===== AUTO-CLEAR SCREEN ON TIMEOUT =====
-  if (currentState != STATE_WELCOME && currentState != STATE_IDLE) {
+  // Not while fetching (the request has its own API_TIMEOUT) or while the
+  // Pico is still reporting progress
+  bool printingLive = currentState == STATE_PRINTING && printProgress.active() &&
+                      millis() - printProgress.lastReportMs() < DISPLAY_TIMEOUT;
+  if (currentState != STATE_WELCOME && currentState != STATE_IDLE && currentState != STATE_FETCHING &&
+      !printingLive) {
     if (millis() - lastInteractionTime > DISPLAY_TIMEOUT) {
       currentState = STATE_WELCOME;
-      display.clearDisplay();
       displayWelcomeScreen();
     }
   }
@@ -171,15 +377,29 @@ void initializeDisplay() {
     return;
   }
   
+  // Above 400 kHz is outside the SH1106 spec but most modules keep up;
+  // fall back if the panel stops acknowledging
+  Wire.setClock(OLED_I2C_FREQ);
+  Wire.beginTransmission(OLED_I2C_ADDRESS);
+  if (Wire.endTransmission() != 0) {
+    Wire.setClock(OLED_I2C_FREQ_SAFE);
+    Serial.printf("[Display] No ACK at %lu Hz, using 400 kHz\n", (unsigned long)OLED_I2C_FREQ);
+  }
+  oled.begin(&Wire, OLED_I2C_ADDRESS, OLED_TASK_CORE, OLED_TASK_PRIORITY);
+  uint32_t composeUs = screens.begin(&display, display.getBuffer());
+  Serial.printf("[Display] %d screen templates composed in %lu us\n", SCREEN_COUNT, (unsigned long)composeUs);
+  
   // Clear and setup initial display
   display.clearDisplay();
   display.setTextSize(1);
   display.setTextColor(SH110X_WHITE);
   display.setCursor(0, 0);
   display.println("Printosk Initializing...");
-  display.display();
+  oledPush();
   
+#if !FAST_BOOT
   delay(500);
+#endif
   
   Serial.println("[Display] SH1106 Initialized successfully");
 }
@@ -187,8 +407,9 @@ void initializeDisplay() {
 void initializeButtons() {
   Serial.println("[Buttons] Initializing 11-button keypad...");
   
-  for (int i = 0; i < 11; i++) {
-    pinMode(buttonPins[i], INPUT_PULLUP);
+  if (!keypad.begin(buttonPins, 11)) {
+    Serial.println("[Buttons] ERROR: Debounce timer could not be created!");
+    return;
   }
   
   Serial.println("[Buttons] All 11 buttons initialized (0-9 + ENTER)");
@@ -205,13 +426,17 @@ void initializeSerial() {
   Serial.println("[Serial] Connecting to Pico UART1 (GPIO 8 TX, GPIO 9 RX)");
   Serial.println("[Serial] Baud rate: 115200");
   
+#if !FAST_BOOT
   // Small delay for Pico to initialize
   delay(500);
+#endif
   
-  // Send initial handshake
+  // Send initial handshake (a Pico that boots later announces PICO_READY itself)
   Serial.println("[Pico] Sending: ESP_READY");
-  PICO_SERIAL.println("ESP_READY");
+  PICO_SERIAL.println("ESP_READY");  // Before any file transfer can start: written directly
+#if !FAST_BOOT
   delay(100);
+#endif
 }
 
 void initializeWiFi() {
@@ -220,6 +445,10 @@ void initializeWiFi() {
   
   WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
   
+#if FAST_BOOT
+  // loop() picks up the connection when it completes
+  Serial.println("[WiFi] Connecting in background");
+#else
   int attempts = 0;
   while (WiFi.status() != WL_CONNECTED && attempts < 20) {
     delay(500);
@@ -236,27 +465,26 @@ void initializeWiFi() {
     Serial.println("\n[WiFi] ERROR: Failed to connect");
     wifiConnected = false;
   }
+#endif
 }
 
 /**
  * ============= INPUT HANDLING =============
  */
 
+// Handles every press queued since the last call, in order; keys typed
+// while loop() was busy are not lost
 void handleKeypadInput() {
-  // Check each button for press
-  for (int i = 0; i < 11; i++) {
-    if (digitalRead(buttonPins[i]) == LOW) {  // Button pressed (active low)
-      delay(20);  // Debounce
-      if (digitalRead(buttonPins[i]) == LOW) {
-        handleButtonPress(i);
-        
-        // Wait for button release
-        while (digitalRead(buttonPins[i]) == LOW) {
-          delay(10);
-        }
-        delay(20);  // Debounce release
-      }
+  KeyEvent event;
+  while (keypad.read(&event)) {
+    if (event.type != KEY_DOWN) {
+      continue;
+    }
+    uint32_t latency = micros() - event.timeUs;
+    if (latency > keyLatencyMaxUs) {
+      keyLatencyMaxUs = latency;
     }
+    handleButtonPress(event.key);
   }
 }
 
@@ -268,22 +496,22 @@ void handleButtonPress(int buttonIndex) {
   if (buttonIndex == 0) {
     if (currentTime - lastButtonTime > 3000) {
       // Reset sequence if more than 3 seconds elapsed
-      debugSequence = "0";
+      debugZeroCount = 1;
     } else {
       // Add to sequence
-      debugSequence += "0";
+      debugZeroCount++;
     }
     lastButtonTime = currentTime;
     
     // Check if we have 0-0-0 sequence
-    if (debugSequence == "000") {
+    if (debugZeroCount == 3) {
       testPicoCommunication();
-      debugSequence = "";
+      debugZeroCount = 0;
       return;
     }
   } else {
     // Reset sequence on non-zero button
-    debugSequence = "";
+    debugZeroCount = 0;
   }
   
   // ===== NUMERIC BUTTON (0-9) =====
@@ -291,15 +519,13 @@ void handleButtonPress(int buttonIndex) {
     // Transition from welcome to input screen on first digit
     if (currentState == STATE_WELCOME) {
       currentState = STATE_INPUT_ID;
-      currentPrintId = "";
-      display.clearDisplay();
+      currentPrintId.clear();
       displayInputScreen();
     }
     
     // Add digit to Print ID if space available
     if (currentState == STATE_INPUT_ID && currentPrintId.length() < MAX_PRINT_ID_LENGTH) {
       currentPrintId += buttonLabels[buttonIndex];
-      display.clearDisplay();
       displayInputScreen();
     }
   } 
@@ -308,13 +534,10 @@ void handleButtonPress(int buttonIndex) {
     if (currentState == STATE_INPUT_ID && currentPrintId.length() > 0) {
       // Submit print job
       currentState = STATE_FETCHING;
-      display.clearDisplay();
-      displayFetchingScreen();
-      fetchPrintJob(currentPrintId);
+      fetchPrintJob(currentPrintId.c_str());
     } else if (currentState == STATE_WELCOME) {
       // Reset when on welcome screen
-      currentPrintId = "";
-      display.clearDisplay();
+      currentPrintId.clear();
       displayWelcomeScreen();
     }
   }
@@ -325,6 +548,23 @@ void handleButtonPress(int buttonIndex) {
  * Active listener that continuously drains UART buffer
  */
 
+/**
+ * Queue the file transfer the Pico asked for:
+ * "[Pico] [STEP 8] SEND_FILES job=<id> files=<n>"
+ */
+void requestJobFiles(const char* message) {
+  NetRequest request = {};
+  request.type = NET_SEND_FILES;
+  const char* job = strstr(message, "job=");
+  if (job == NULL || sscanf(job, "job=%6[0-9] files=%d", request.printId, &request.fileCount) != 2) {
+    Serial.println("[PRINT] Malformed SEND_FILES, ignored");
+    return;
+  }
+  if (xQueueSend(netRequestQueue, &request, 0) != pdTRUE) {
+    Serial.println("[PRINT] Network queue full; the Pico times the job out");
+  }
+}
+
 void processPicoMessages() {
   // Drain ALL available data from Pico UART
   // This ensures no messages are lost due to timing
@@ -337,25 +577,54 @@ void processPicoMessages() {
         picoRxBuffer[picoRxIndex] = '\0';  // Null terminate string
         lastPicoMessageTime = millis();
         
-        // Print received message to serial monitor
-        Serial.println("[Pico] Received: " + String(picoRxBuffer));
+        // File flow control for sendJobFiles: consumed, too frequent to log
+        int ackFile;
+        unsigned long ackBytes;
+        if (sscanf(picoRxBuffer, "[Pico] FILE_ACK %d %lu", &ackFile, &ackBytes) == 2) {
+          PicoFileAck ack = { ackFile, (uint32_t)ackBytes };
+          xQueueOverwrite(picoFileAckQueue, &ack);
+          picoRxIndex = 0;
+          continue;
+        }
         
-        // Process message content
-        String message = String(picoRxBuffer);
+        // Print received message to serial monitor
+        Serial.printf("[Pico] Received: %s\n", picoRxBuffer);
         
         // Track Pico connection status
-        if (message.indexOf("READY") > -1 || message.indexOf("HEARTBEAT") > -1) {
+        if (strstr(picoRxBuffer, "READY") || strstr(picoRxBuffer, "HEARTBEAT")) {
           picoConnected = true;
         } 
+        // Page/band progress of the running job
+        else if (printProgress.parse(picoRxBuffer, millis(), currentPrintId.c_str())) {
+          // Drawn by updatePrintingProgress(), at most every PRINT_PROGRESS_REDRAW_MS
+        }
+        // Pico is at the files band: stream them from the network task
+        else if (strstr(picoRxBuffer, "SEND_FILES")) {
+          requestJobFiles(picoRxBuffer);
+        }
         // Handle error messages from Pico
-        else if (message.indexOf("ERROR") > -1) {
-          displayErrorScreen("Printer Error: " + message);
-          updatePrintJobStatus(currentPrintId, "ERROR", message);
+        else if (strstr(picoRxBuffer, "ERROR")) {
+          pinnedPrintId = 0;
+          InplaceString<96> error;
+          error.printf("Printer Error: %s", picoRxBuffer);
+          displayErrorScreen(error.c_str());
+          updatePrintJobStatus(currentPrintId.c_str(), "ERROR", picoRxBuffer);
         } 
+        // Cancelled on the Pico (CANCEL command)
+        else if (strstr(picoRxBuffer, "[CANCELLED]")) {
+          pinnedPrintId = 0;
+          displayErrorScreen("Print cancelled");
+          updatePrintJobStatus(currentPrintId.c_str(), "CANCELLED");
+        }
         // Handle job completion
-        else if (message.indexOf("COMPLETE") > -1) {
+        else if (strstr(picoRxBuffer, "COMPLETE")) {
+          pinnedPrintId = 0;  // Its cached files may be evicted now
+          uint16_t ppm = printProgress.pagesPerMinuteX10();
+          if (ppm > 0) {
+            Serial.printf("[Pico] Printed at %u.%u pages/min\n", ppm / 10, ppm % 10);
+          }
           displaySuccessScreen();
-          updatePrintJobStatus(currentPrintId, "COMPLETED");
+          updatePrintJobStatus(currentPrintId.c_str(), "COMPLETED");
         }
         
         // Clear buffer for next message
@@ -378,219 +647,305 @@ void processPicoMessages() {
  * ============= DISPLAY FUNCTIONS =============
  */
 
+// Replaces display.display(): hands the frame to the OLED task, which
+// sends only what changed; drawing the next screen can start at once
+void oledPush() {
+  oled.submit(display.getBuffer());
+}
+
 void displayWelcomeScreen() {
   currentState = STATE_WELCOME;
-  display.clearDisplay();
-  
-  // Title
-  display.setTextSize(2);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(20, 10);
-  display.println("PRINTOSK");
-  
-  // Instructions
-  display.setTextSize(1);
-  display.setCursor(10, 35);
-  display.println("Enter Print ID");
-  display.setCursor(5, 50);
-  display.println("Press 0-9 then ENTER");
-  
-  display.display();
+  screens.show(SCREEN_WELCOME, display.getBuffer());
+  oledPush();
 }
 
 void displayInputScreen() {
   currentState = STATE_INPUT_ID;
-  display.clearDisplay();
+  screens.show(SCREEN_INPUT, display.getBuffer());
   
-  // Header
+  // Entered ID
   display.setTextSize(2);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(20, 10);
-  display.println("PRINT ID");
-  
-  // Display entered ID
-  display.setTextSize(2);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(30, 35);
-  display.println(currentPrintId);
+  display.setCursor(INPUT_ID_X, INPUT_ID_Y);
+  display.print(currentPrintId.c_str());
   
   // Counter
   display.setTextSize(1);
-  display.setCursor(0, 55);
-  display.println(String(currentPrintId.length()) + "/" + String(MAX_PRINT_ID_LENGTH));
+  display.setCursor(INPUT_COUNTER_X, INPUT_COUNTER_Y);
+  display.print(currentPrintId.length());
+  display.print("/");
+  display.print(MAX_PRINT_ID_LENGTH);
   
-  display.display();
+  oledPush();
 }
 
 void displayFetchingScreen() {
   currentState = STATE_FETCHING;
-  display.clearDisplay();
+  screens.show(SCREEN_FETCHING, display.getBuffer());
   
   display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(30, 10);
-  display.println("Fetching Job...");
+  display.setCursor(FETCHING_ID_X, FETCHING_ID_Y);
+  display.print(currentPrintId.c_str());
   
-  display.setCursor(15, 35);
-  display.println("ID: " + currentPrintId);
-  
-  display.display();
+  oledPush();
+  lastSpinnerTime = millis();
+  spinnerFrame = 0;
 }
 
-void displayPrintingScreen() {
-  currentState = STATE_PRINTING;
-  display.clearDisplay();
+// Local index hit: shown at once while the fetch confirms the job
+void displayJobFoundScreen(int fileCount) {
+  currentState = STATE_FETCHING;
+  screens.show(SCREEN_JOB_FOUND, display.getBuffer());
   
   display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(35, 10);
-  display.println("Printing...");
+  display.setCursor(JOB_FOUND_ID_X, JOB_FOUND_ID_Y);
+  display.print(currentPrintId.c_str());
+  display.setCursor(JOB_FOUND_FILES_X, JOB_FOUND_FILES_Y);
+  display.print(fileCount);
+  display.print("  Confirming");
+  
+  oledPush();
+  lastSpinnerTime = millis();
+  spinnerFrame = 0;
+}
+
+// Redraws only the spinner cell; called from loop() while fetching
+void updateFetchingSpinner() {
+  static const char frames[] = { '|', '/', '-', '\\' };
   
-  display.setCursor(20, 35);
-  display.println("Please Wait");
+  if (millis() - lastSpinnerTime < SPINNER_INTERVAL) {
+    return;
+  }
+  lastSpinnerTime = millis();
+  spinnerFrame = (spinnerFrame + 1) % 4;
   
-  display.display();
+  display.fillRect(60, 50, 6, 8, SH110X_BLACK);
+  display.setTextSize(1);
+  display.setCursor(60, 50);
+  display.print(frames[spinnerFrame]);
+  oledPush();
 }
 
-void displaySuccessScreen() {
-  currentState = STATE_SUCCESS;
-  display.clearDisplay();
+void displayPrintingScreen() {
+  currentState = STATE_PRINTING;
+  screens.show(SCREEN_PRINTING, display.getBuffer());
+  display.drawRect(PROGRESS_BAR_X, PROGRESS_BAR_Y, PROGRESS_BAR_W, PROGRESS_BAR_H, SH110X_WHITE);
+  
+  printProgress.start(millis());
+  drawnProgressPercent = -1;
+  drawnProgressEta = -1;
+  drawPrintingProgress();
+  oledPush();
+}
+
+// Bar fill and the page/percent and ETA lines; everything else on the
+// printing screen is static
+void drawPrintingProgress() {
+  uint8_t percent = printProgress.percent();
+  int32_t eta = printProgress.etaSeconds(millis());
   
-  // Success message
-  display.setTextSize(2);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(30, 20);
-  display.println("SUCCESS!");
+  int fill = (PROGRESS_BAR_W - 4) * percent / 100;
+  display.fillRect(PROGRESS_BAR_X + 2, PROGRESS_BAR_Y + 2, PROGRESS_BAR_W - 4, PROGRESS_BAR_H - 4, SH110X_BLACK);
+  display.fillRect(PROGRESS_BAR_X + 2, PROGRESS_BAR_Y + 2, fill, PROGRESS_BAR_H - 4, SH110X_WHITE);
   
-  // Info text
+  char line[22];
   display.setTextSize(1);
-  display.setCursor(10, 50);
-  display.println("Job Completed. Returning...");
+  display.fillRect(0, PROGRESS_TEXT_Y, OLED_WIDTH, 2 * TEXT_GLYPH_HEIGHT + PROGRESS_LINE_GAP, SH110X_BLACK);
+  if (!printProgress.active()) {
+    snprintf(line, sizeof(line), "Please Wait");
+  } else {
+    snprintf(line, sizeof(line), "Page %d/%d  %u%%", printProgress.page, printProgress.pages, (unsigned)percent);
+  }
+  display.setCursor(centeredTextX(line, 1, OLED_WIDTH), PROGRESS_TEXT_Y);
+  display.print(line);
   
-  display.display();
-  delay(3000);
+  if (eta < 0) {
+    snprintf(line, sizeof(line), "ETA --:--");
+  } else {
+    snprintf(line, sizeof(line), "ETA %ld:%02ld", (long)(eta / 60), (long)(eta % 60));
+  }
+  display.setCursor(centeredTextX(line, 1, OLED_WIDTH), PROGRESS_TEXT_Y + TEXT_GLYPH_HEIGHT + PROGRESS_LINE_GAP);
+  display.print(line);
   
-  // Return to welcome screen
-  currentState = STATE_WELCOME;
-  display.clearDisplay();
-  displayWelcomeScreen();
+  drawnProgressPercent = percent;
+  drawnProgressEta = eta;
+}
+
+// Redraws the progress fields when they changed, at most every
+// PRINT_PROGRESS_REDRAW_MS; called from loop() while printing
+void updatePrintingProgress() {
+  if (millis() - lastProgressDraw < PRINT_PROGRESS_REDRAW_MS) {
+    return;
+  }
+  lastProgressDraw = millis();
+  
+  if (printProgress.percent() == drawnProgressPercent &&
+      printProgress.etaSeconds(millis()) == drawnProgressEta) {
+    return;
+  }
+  drawPrintingProgress();
+  oledPush();
+}
+
+void displaySuccessScreen() {
+  currentState = STATE_SUCCESS;
+  screens.show(SCREEN_SUCCESS, display.getBuffer());
+  oledPush();
+  successShownAt = millis();  // loop() returns to the welcome screen
 }
 
-void displayErrorScreen(String message) {
+void displayErrorScreen(const char* message) {
   currentState = STATE_ERROR;
-  display.clearDisplay();
+  screens.show(SCREEN_ERROR, display.getBuffer());
   
-  // Error header
+  // Error message (wraps between header and instructions)
   display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(25, 10);
-  display.println("ERROR!");
-  
-  // Error message
-  display.setCursor(0, 25);
-  display.setTextSize(0);
-  display.println(message);
+  display.setCursor(0, ERROR_MESSAGE_Y);
+  display.print(message);
   
-  // Instructions
-  display.setCursor(10, 50);
-  display.println("Press ENTER to continue");
-  
-  display.display();
+  oledPush();
 }
 
 void displayIdleScreen() {
   currentState = STATE_IDLE;
-  display.clearDisplay();
-  
-  display.setTextSize(1);
-  display.setTextColor(SH110X_WHITE);
-  display.setCursor(20, 30);
-  display.println("Idle - No Input");
-  
-  display.display();
+  screens.show(SCREEN_IDLE, display.getBuffer());
+  oledPush();
 }
 
 /**
  * ============= API & PICO COMMUNICATION =============
  */
 
-void fetchPrintJob(String printId) {
+void fetchPrintJob(const char* printId) {
+  // Local index first: answers from RAM, the network only confirms
+  uint16_t fileCount = 0;
+  uint32_t lookupStart = micros();
+  xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+  JobIndexState indexed = jobIndex.lookup(atoi(printId), millis(), &fileCount);
+  xSemaphoreGive(jobIndexMutex);
+  Serial.printf("[INDEX] Lookup %s: state %d in %lu us\n", printId, indexed,
+                (unsigned long)(micros() - lookupStart));
+  
+  if (indexed == JOB_INDEX_NOT_FOUND) {
+    displayErrorScreen("Print ID not found");
+    return;
+  }
+  if (indexed == JOB_INDEX_EXPIRED) {
+    displayErrorScreen("Job expired");
+    return;
+  }
+  if (indexed == JOB_INDEX_PENDING) {
+    displayJobFoundScreen(fileCount);
+  } else {
+    displayFetchingScreen();
+  }
+  
   if (!wifiConnected) {
     displayErrorScreen("No WiFi Connection");
     return;
   }
   
-  String url = String(API_BASE_URL) + "/print-job/" + printId;
+  NetRequest request = {};
+  request.type = NET_FETCH_JOB;
+  strlcpy(request.printId, printId, sizeof(request.printId));
   
-  HTTPClient http;
-  http.begin(url);
-  http.setTimeout(API_TIMEOUT);
-  
-  Serial.println("[API] Fetching: " + url);
-  Serial.println("[API] Waiting for response...");
-  
-  int httpCode = http.GET();
-  Serial.println("[API] HTTP Code: " + String(httpCode));
-  
-  if (httpCode == HTTP_CODE_OK) {
-    String payload = http.getString();
-    Serial.println("[API] Response received: " + String(payload.length()) + " bytes");
+  if (xQueueSend(netRequestQueue, &request, 0) != pdTRUE) {
+    displayErrorScreen("Network busy");
+    return;
+  }
+  Serial.printf("[API] Fetch queued: %s\n", printId);
+}
+
+/**
+ * Consume network task completions (never blocks)
+ */
+void processNetResponses() {
+  NetResponse response;
+  
+  while (xQueueReceive(netResponseQueue, &response, 0) == pdTRUE) {
+    // Remember definite misses so a retyped ID is answered locally
+    if ((response.result == NET_NOT_FOUND && response.httpCode == 404) || response.result == NET_EXPIRED) {
+      xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+      jobIndex.addNegative(atoi(response.printId),
+                           response.result == NET_EXPIRED ? JOB_INDEX_EXPIRED : JOB_INDEX_NOT_FOUND,
+                           millis());
+      xSemaphoreGive(jobIndexMutex);
+    }
     
-    // Parse JSON response
-    DynamicJsonDocument doc(8192);
-    DeserializationError error = deserializeJson(doc, payload);
+    // Fetch: ignore completions the user has already moved on from
+    if (currentState != STATE_FETCHING || currentPrintId != response.printId) {
+      Serial.printf("[API] Dropping stale fetch result for %s\n", response.printId);
+      continue;
+    }
     
-    if (!error) {
-      if (doc["success"] == true) {
-        JsonObject printJob = doc["printJob"];
-        JsonArray files = doc["files"];
-        
+    switch (response.result) {
+      case NET_OK: {
         Serial.println("[API] Job found!");
         Serial.print("[API] Files: ");
-        Serial.println(files.size());
+        Serial.println(response.fileCount);
+        Serial.printf("[CACHE] %d of %d files already on the kiosk\n", response.cachedFiles, response.fileCount);
         
         // Show printing screen
         currentState = STATE_PRINTING;
-        display.clearDisplay();
         displayPrintingScreen();
         
         // Send print command to Pico
-        String command = "START_PRINT:" + printId + ":" + String(files.size());
-        sendToPico(command);
+        InplaceString<48> command;
+        command.printf("START_PRINT:%s:%d", currentPrintId.c_str(), response.fileCount);
+        sendToPico(command.c_str());
         
         // Update API status
-        updatePrintJobStatus(printId, "PRINTING");
-      } else {
-        displayErrorScreen("Job not found");
+        updatePrintJobStatus(currentPrintId.c_str(), "PRINTING");
+        break;
+      }
+      case NET_NO_WIFI:
+        displayErrorScreen("No WiFi Connection");
+        break;
+      case NET_NOT_FOUND:
+        displayErrorScreen(response.httpCode == 404 ? "Print ID not found" : "Job not found");
+        break;
+      case NET_EXPIRED:
+        displayErrorScreen("Job expired");
+        break;
+      case NET_PARSE_ERROR:
+        displayErrorScreen("Parse error");
+        break;
+      default: {
+        InplaceString<24> message;
+        message.printf("Error: %d", response.httpCode);
+        displayErrorScreen(message.c_str());
+        break;
       }
-    } else {
-      displayErrorScreen("Parse error");
-      Serial.println("[API] JSON error: " + String(error.c_str()));
     }
-  } else if (httpCode == 404) {
-    displayErrorScreen("Print ID not found");
-  } else if (httpCode == 410) {
-    displayErrorScreen("Job expired");
-  } else {
-    displayErrorScreen("Error: " + String(httpCode));
   }
-  
-  http.end();
 }
 
-void sendToPico(String command) {
-  Serial.println("[Pico] DEBUG: Preparing to send: " + command);
-  delay(100);  // Small delay to ensure Pico is ready
-  
-  // Send command with explicit newline
-  PICO_SERIAL.print(command);
-  PICO_SERIAL.print("\n");
-  PICO_SERIAL.flush();      // Force buffer flush
-  
-  delay(50);  // Wait for transmission
-  
-  Serial.println("[Pico] Sent: " + command);
-  Serial.println("[Pico] Buffer flushed");
+/**
+ * Queue a command line for the Pico; flushPicoTx() writes it. Never
+ * blocks, so the UI keeps running while a file is going out.
+ */
+void sendToPico(const char* command) {
+  PicoLine line;
+  strlcpy(line.text, command, sizeof(line.text));
+  if (xQueueSend(picoTxQueue, &line, 0) != pdTRUE) {
+    Serial.printf("[Pico] TX queue full, dropped: %s\n", command);
+  }
+}
+
+/**
+ * Write the queued command lines, unless sendJobFiles is in the middle of
+ * a file: the Pico would take them for file bytes. They go out after it.
+ */
+void flushPicoTx() {
+  if (uxQueueMessagesWaiting(picoTxQueue) == 0 || xSemaphoreTake(picoTxMutex, 0) != pdTRUE) {
+    return;
+  }
+  PicoLine line;
+  while (xQueueReceive(picoTxQueue, &line, 0) == pdTRUE) {
+    PICO_SERIAL.print(line.text);
+    PICO_SERIAL.print("\n");
+    Serial.printf("[Pico] Sent: %s\n", line.text);
+  }
+  xSemaphoreGive(picoTxMutex);
 }
 
 void testPicoCommunication() {
@@ -601,6 +956,7 @@ void testPicoCommunication() {
   Serial.println("2. Sending TEST_ECHO command...");
   
   sendToPico("TEST_ECHO");
+  flushPicoTx();  // loop() is held up below
   
   Serial.println("3. Waiting 5 seconds for Pico responses...");
   for (int i = 0; i < 5; i++) {
@@ -608,58 +964,775 @@ void testPicoCommunication() {
     delay(1000);
   }
   Serial.println("\nTest complete. Check serial output above.");
+  
+  const OledStats& oledStats = oled.getStats();
+  if (oledStats.updates > 0) {
+    Serial.printf("OLED: %lu updates, avg %lu bytes / %lu us, max %lu us (full frame ~1100 bytes)\n",
+                  (unsigned long)oledStats.updates,
+                  (unsigned long)(oledStats.bytes / oledStats.updates),
+                  (unsigned long)(oledStats.totalUs / oledStats.updates),
+                  (unsigned long)oledStats.maxUs);
+    Serial.printf("OLED: UI cost per update max %lu us, %lu frames superseded in flight\n",
+                  (unsigned long)oled.maxSubmitUs, (unsigned long)oled.dropped);
+  }
+  Serial.printf("Keypad: %lu events, %lu dropped, %lu debounce ticks, max press latency %lu us\n",
+                (unsigned long)keypad.events, (unsigned long)keypad.dropped,
+                (unsigned long)keypad.ticks, (unsigned long)keyLatencyMaxUs);
   Serial.println("========================================\n");
 }
 
-void updatePrintJobStatus(String printId, String status, String errorMsg) {
-  if (!wifiConnected) {
-    Serial.println("[API] Cannot update status - WiFi disconnected");
-    return;
+/**
+ * Record a status transition; the network task delivers it
+ * Written to flash before returning, so it survives a reboot or outage.
+ */
+void updatePrintJobStatus(const char* printId, const char* status, const char* errorMsg) {
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  statusOutbox.add(printId, status, errorMsg);
+  xSemaphoreGive(outboxMutex);
+  
+  // A full queue means the task is awake and will see the outbox anyway
+  NetRequest request = {};
+  request.type = NET_FLUSH_OUTBOX;
+  xQueueSend(netRequestQueue, &request, 0);
+}
+
+/**
+ * ============= NETWORK TASK =============
+ * Owns every HTTPClient and the API connection pool; runs on core 0 next
+ * to the WiFi stack
+ */
+
+void startNetworkTask() {
+  outboxMutex = xSemaphoreCreateMutex();
+  jobIndexMutex = xSemaphoreCreateMutex();
+  statusOutbox.begin();
+  netRequestQueue = xQueueCreate(NET_QUEUE_DEPTH, sizeof(NetRequest));
+  netResponseQueue = xQueueCreate(NET_QUEUE_DEPTH, sizeof(NetResponse));
+  picoFileAckQueue = xQueueCreate(1, sizeof(PicoFileAck));
+  picoTxQueue = xQueueCreate(PICO_TX_QUEUE_DEPTH, sizeof(PicoLine));
+  picoTxMutex = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(networkTask, "network", NET_TASK_STACK, NULL,
+                          NET_TASK_PRIORITY, NULL, NET_TASK_CORE);
+  xTaskCreatePinnedToCore(realtimeTask, "realtime", REALTIME_TASK_STACK, NULL,
+                          NET_TASK_PRIORITY, NULL, NET_TASK_CORE);
+}
+
+void httpFetchPrintJob(const NetRequest& request, NetResponse& response) {
+  ApiUrl url;
+  url.printf("%s/print-job/%s", API_BASE_URL, request.printId);
+  
+  HTTPClient http;
+  
+  Serial.printf("[API] Fetching: %s\n", url.c_str());
+  
+  response.httpCode = apiPool.request(http, url.c_str(), [](HTTPClient& h) { return h.GET(); },
+                                      ConnectionPool::RETRY_IF_STALE);
+  Serial.printf("[API] HTTP Code: %d\n", response.httpCode);
+  
+  if (response.httpCode == HTTP_CODE_OK) {
+    // Parse off the socket: only the fields we use are kept, so memory
+    // does not grow with the number of files
+    PrintJob job;
+    JobJsonParser parser(&job);
+    JobJsonSink sink(parser);
+    uint32_t heapBefore = ESP.getFreeHeap();
+    uint32_t parseStart = millis();
+    
+    int streamed = http.writeToStream(&sink);
+    Serial.printf("[API] Response streamed: %u bytes in %lu ms, free heap %u -> %u\n",
+                  (unsigned)sink.bytes, millis() - parseStart, (unsigned)heapBefore, (unsigned)ESP.getFreeHeap());
+    
+    if (streamed < 0 || !parser.finish()) {
+      response.result = NET_PARSE_ERROR;
+      Serial.printf("[API] JSON error at byte %u\n", (unsigned)sink.bytes);
+    } else if (parser.success()) {
+      response.result = NET_OK;
+      response.fileCount = job.file_count;
+    } else {
+      response.result = NET_NOT_FOUND;
+    }
+  } else if (response.httpCode == 404) {
+    response.result = NET_NOT_FOUND;
+  } else if (response.httpCode == 410) {
+    response.result = NET_EXPIRED;
+  } else {
+    response.result = NET_HTTP_ERROR;
   }
   
-  String url = String(API_BASE_URL) + "/print-job/" + printId + "/status";
+  http.end();
+}
+
+int httpUpdateStatus(const OutboxEntry& entry) {
+  ApiUrl url;
+  url.printf("%s/print-job/%s/status", API_BASE_URL, entry.printId);
   
   HTTPClient http;
-  http.begin(url);
-  http.addHeader("Content-Type", "application/json");
   
   // Build JSON payload
-  DynamicJsonDocument doc(256);
-  doc["status"] = status;
-  if (errorMsg.length() > 0) {
-    doc["error_message"] = errorMsg;
+  StaticJsonDocument<256> doc;
+  doc["status"] = entry.status;
+  if (entry.errorMsg[0] != '\0') {
+    doc["error_message"] = entry.errorMsg;
+  }
+  
+  char body[256];
+  size_t length = serializeJson(doc, body, sizeof(body));
+  
+  Serial.printf("[API] Updating status: %s -> %s\n", url.c_str(), entry.status);
+  int httpCode = apiPool.request(http, url.c_str(), [&](HTTPClient& h) {
+    h.addHeader("Content-Type", "application/json");
+    return h.PUT((uint8_t*)body, length);
+  });
+  
+  http.end();
+  return httpCode;
+}
+
+int httpUpdateStatusBatch(const OutboxEntry* entries, int count) {
+  ApiUrl url;
+  url.printf("%s/status-batch", API_BASE_URL);
+  
+  HTTPClient http;
+  
+  // Static: network task only, and too large for its stack next to TLS
+  static StaticJsonDocument<256 * OUTBOX_MAX_BATCH> doc;
+  static char body[256 * OUTBOX_MAX_BATCH];
+  doc.clear();
+  JsonArray updates = doc.createNestedArray("updates");
+  for (int i = 0; i < count; i++) {
+    JsonObject update = updates.createNestedObject();
+    update["print_id"] = entries[i].printId;
+    update["status"] = entries[i].status;
+    if (entries[i].errorMsg[0] != '\0') {
+      update["error_message"] = entries[i].errorMsg;
+    }
   }
   
-  String jsonStr;
-  serializeJson(doc, jsonStr);
+  size_t length = serializeJson(doc, body, sizeof(body));
+  
+  Serial.printf("[API] Updating %d statuses: %s\n", count, url.c_str());
+  int httpCode = apiPool.request(http, url.c_str(), [&](HTTPClient& h) {
+    h.addHeader("Content-Type", "application/json");
+    return h.POST((uint8_t*)body, length);
+  });
+  
+  http.end();
+  return httpCode;
+}
+
+/**
+ * Bring the local job index up to date from the last cursor
+ * Follows "more" for up to JOB_INDEX_SYNC_MAX_PAGES pages.
+ */
+bool syncJobIndex() {
+  static char body[JOB_INDEX_SYNC_BODY_MAX];
+  
+  for (int page = 0; page < JOB_INDEX_SYNC_MAX_PAGES; page++) {
+    ApiUrl url;
+    url.printf("%s/job-index?limit=%d", API_BASE_URL, JOB_INDEX_SYNC_PAGE);
+    xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+    if (jobIndex.cursor[0] != '\0') {
+      url.appendf("&since=%s", jobIndex.cursor);
+    }
+    xSemaphoreGive(jobIndexMutex);
+    
+    HTTPClient http;
+    int httpCode = apiPool.request(http, url.c_str(), [](HTTPClient& h) {
+      h.addHeader("X-Kiosk-Key", KIOSK_DEVICE_KEY);
+      return h.GET();
+    }, ConnectionPool::RETRY_IF_STALE);
+    if (httpCode != HTTP_CODE_OK) {
+      Serial.printf("[INDEX] Sync failed: %d\n", httpCode);
+      http.end();
+      if (httpCode == HTTP_CODE_BAD_REQUEST) {
+        // Cursor rejected (e.g. from an older backend): start over with a full sync
+        xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+        jobIndex.cursor[0] = '\0';
+        xSemaphoreGive(jobIndexMutex);
+      }
+      return false;
+    }
+    BufferSink sink(body, sizeof(body));
+    int streamed = http.writeToStream(&sink);
+    http.end();
+    
+    static StaticJsonDocument<JOB_INDEX_SYNC_DOC_SIZE> doc;  // Network task only
+    if (streamed < 0 || sink.overflow || deserializeJson(doc, body, sink.len) || !doc["success"]) {
+      Serial.printf("[INDEX] Sync response unusable (%u bytes)\n", (unsigned)sink.len);
+      return false;
+    }
+    
+    JsonArray jobs = doc["jobs"].as<JsonArray>();
+    xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+    jobIndex.setServerTime(doc["server_time"], millis());
+    for (JsonObject job : jobs) {
+      if (strcmp(job["status"] | "", "PENDING") == 0) {
+        jobIndex.upsertPending(job["id"], job["files"], job["expires"]);
+      } else {
+        jobIndex.remove(job["id"]);
+      }
+    }
+    jobIndex.prune(millis());
+    strlcpy(jobIndex.cursor, doc["cursor"] | "", sizeof(jobIndex.cursor));
+    int indexed = jobIndex.size();
+    xSemaphoreGive(jobIndexMutex);
+    
+    Serial.printf("[INDEX] Synced %u changes, %d entries\n", (unsigned)jobs.size(), indexed);
+    if (!doc["more"]) {
+      break;
+    }
+  }
+  return true;
+}
+
+/**
+ * Pick the next file to prefetch: the first uncached file of a PENDING job
+ * Also drops cached files of jobs that left PENDING (except the pinned job).
+ */
+bool nextPrefetchTarget(uint32_t* printId, uint8_t* fileIndex, uint32_t* expires, uint32_t* serverNow) {
+  uint32_t stale[CACHE_MAX_ENTRIES];
+  int staleCount = 0;
+  bool found = false;
+  
+  xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+  uint32_t now = millis();
+  for (int i = 0; i < fileCache.size(); i++) {
+    uint32_t id = fileCache.at(i).printId;
+    if (id != pinnedPrintId && jobIndex.lookup(id, now) != JOB_INDEX_PENDING) {
+      stale[staleCount++] = id;
+    }
+  }
+  for (int i = 0; i < jobIndex.size() && !found; i++) {
+    const JobIndexEntry& job = jobIndex.at(i);
+    if (job.state != JOB_INDEX_PENDING) {
+      continue;
+    }
+    for (uint8_t f = 0; f < job.fileCount; f++) {
+      if (!fileCache.known(job.printId, f)) {
+        *printId = job.printId;
+        *fileIndex = f;
+        *expires = job.expires;
+        found = true;
+        break;
+      }
+    }
+  }
+  *serverNow = jobIndex.serverNow(now);
+  xSemaphoreGive(jobIndexMutex);
   
-  Serial.println("[API] Updating status: " + url + " -> " + status);
-  int httpCode = http.PUT(jsonStr);
+  // Flash I/O outside the index lock
+  for (int i = 0; i < staleCount; i++) {
+    fileCache.removeJob(stale[i]);
+  }
+  return found;
+}
+
+/**
+ * Download one file of a PENDING job into the cache
+ * A download that broke off last time continues where it stopped.
+ */
+bool prefetchFile(uint32_t printId, uint8_t fileIndex, uint32_t expires, uint32_t serverNow) {
+  static const char* headerKeys[] = { "X-Content-SHA256", "Content-Range" };
+  ApiUrl url;
+  url.printf("%s/print-job/%lu/download-file?raw=1&fileIndex=%u", API_BASE_URL,
+             (unsigned long)printId, fileIndex);
+  uint32_t offset = fileCache.resumeOffset(printId, fileIndex);
   
+  HTTPClient http;
+  int httpCode = apiPool.request(http, url.c_str(), [offset](HTTPClient& h) {
+    h.collectHeaders(headerKeys, 2);
+    if (offset > 0) {
+      h.addHeader("Range", rangeFrom(offset));
+    }
+    return h.GET();
+  }, ConnectionPool::RETRY_IF_STALE);
   if (httpCode == HTTP_CODE_OK) {
-    Serial.println("[API] Status updated successfully");
-  } else {
-    Serial.println("[API] Status update failed: " + String(httpCode));
+    offset = 0;  // Whole file after all
+  } else if (httpCode != HTTP_CODE_PARTIAL_CONTENT || offset == 0) {
+    Serial.printf("[CACHE] Prefetch %lu/%u failed: %d\n", (unsigned long)printId, fileIndex, httpCode);
+    http.end();
+    return false;
+  }
+  
+  int size = http.getSize();
+  if (offset > 0) {
+    int32_t total = -1;
+    if (contentRangeStart(http.header("Content-Range").c_str(), &total) != (int32_t)offset) {
+      total = -1;
+    }
+    size = total;
+  }
+  char hash[CACHE_HASH_LEN + 1];
+  strlcpy(hash, http.header("X-Content-SHA256").c_str(), sizeof(hash));
+  if (size <= 0 || strlen(hash) < CACHE_HASH_LEN) {
+    Serial.println("[CACHE] Prefetch response without length or hash, skipped");
+    http.end();
+    return false;
+  }
+  
+  bool skipBody = false;
+  if (fileCache.link(printId, fileIndex, hash, size, expires)) {
+    skipBody = true;
+  } else if (size > CACHE_MAX_FILE_BYTES) {
+    // Would hold the network task too long; downloaded on demand instead
+    Serial.printf("[CACHE] %lu/%u: %d bytes, not cached\n", (unsigned long)printId, fileIndex, size);
+    fileCache.markTooLarge(printId, fileIndex, size, expires);
+    skipBody = true;
+  }
+  
+  File file;
+  if (!skipBody) {
+    file = fileCache.beginWrite(printId, fileIndex, hash, size, serverNow, offset);
+    if (!file && offset > 0) {
+      // Content changed under the partial (now dropped): start over next round
+      Serial.printf("[CACHE] %lu/%u: cannot resume at %lu\n", (unsigned long)printId, fileIndex,
+                    (unsigned long)offset);
+      http.getStreamPtr()->stop();
+      http.end();
+      return false;
+    }
+    if (!file) {
+      Serial.printf("[CACHE] %lu/%u: no room for %d bytes\n", (unsigned long)printId, fileIndex, size);
+      fileCache.markTooLarge(printId, fileIndex, size, expires);
+      skipBody = true;
+    }
+  }
+  if (skipBody) {
+    http.getStreamPtr()->stop();  // Not worth reading; the pool reconnects
+    http.end();
+    return true;
+  }
+  
+  uint32_t start = millis();
+  int written = http.writeToStream(&file);
+  http.end();
+  bool ok = fileCache.commit(printId, fileIndex, hash, size, expires, file);
+  Serial.printf("[CACHE] Prefetched %lu/%u: %d of %d bytes from %lu in %lu ms%s\n",
+                (unsigned long)printId, fileIndex, written, size, (unsigned long)offset,
+                millis() - start, ok ? "" : " - kept to resume");
+  return ok;
+}
+
+static const char* fileHeaderKeys[] = { "ETag", "Content-Range" };
+
+/**
+ * One file's bytes to the Pico, paced by its FILE_ACKs so they never
+ * outrun its RX buffer: at most PICO_FILE_WINDOW bytes are unacknowledged
+ */
+struct PicoFileWriter {
+  int file;
+  uint32_t sent = 0;
+  uint32_t acked = 0;
+  bool failed = false;  // The Pico stopped acknowledging
+
+  explicit PicoFileWriter(int file) : file(file) {}
+
+  bool write(const uint8_t* data, size_t len) {
+    while (len > 0) {
+      if (sent - acked >= PICO_FILE_WINDOW && !waitForAck()) {
+        return false;
+      }
+      size_t room = PICO_FILE_WINDOW - (sent - acked);
+      size_t n = len < room ? len : room;
+      PICO_SERIAL.write(data, n);
+      data += n;
+      len -= n;
+      sent += n;
+    }
+    return true;
+  }
+
+  bool waitForAck() {
+    uint32_t start = millis();
+    PicoFileAck ack;
+    while (millis() - start < PICO_FILE_ACK_TIMEOUT_MS) {
+      // Skips acks left over from the previous file
+      if (xQueueReceive(picoFileAckQueue, &ack, pdMS_TO_TICKS(100)) == pdTRUE &&
+          ack.file == file && ack.bytes > acked) {
+        acked = ack.bytes;
+        return true;
+      }
+    }
+    Serial.printf("[PRINT] File %d: no FILE_ACK after %lu bytes\n", file, (unsigned long)acked);
+    failed = true;
+    return false;
+  }
+};
+
+/**
+ * Copy up to `left` body bytes to the Pico; stops early if the connection
+ * closes or goes silent for FILE_STALL_MS, or the Pico stops taking data.
+ * Returns the bytes copied.
+ */
+uint32_t pipeBodyToPico(HTTPClient& http, PicoFileWriter& pico, uint8_t* chunk, size_t chunkSize,
+                        uint32_t left) {
+  WiFiClient* body = http.getStreamPtr();
+  uint32_t copied = 0;
+  uint32_t lastData = millis();
+  while (copied < left && millis() - lastData < FILE_STALL_MS) {
+    size_t n = body->available();
+    if (n == 0) {
+      if (!body->connected()) {
+        break;
+      }
+      delay(1);
+      continue;
+    }
+    if (n > chunkSize) {
+      n = chunkSize;
+    }
+    if (n > left - copied) {
+      n = left - copied;
+    }
+    int got = body->read(chunk, n);
+    if (got > 0) {
+      if (!pico.write(chunk, got)) {
+        break;
+      }
+      copied += got;
+      lastData = millis();
+    }
+  }
+  if (copied < left) {
+    body->stop();  // Broken or stalled: the pool must not reuse it
+  }
+  return copied;
+}
+
+/**
+ * Continue a print file download at the Pico's offset, for the copy named
+ * by etag. Returns the bytes copied to the Pico, or -1 if the server will
+ * not resume that copy (it changed, or the range was refused).
+ */
+int32_t resumeFileToPico(const char* url, const char* etag, PicoFileWriter& pico, uint32_t size,
+                         uint8_t* chunk, size_t chunkSize) {
+  uint32_t offset = pico.sent;
+  HTTPClient http;
+  int httpCode = apiPool.request(http, url, [offset, etag](HTTPClient& h) {
+    h.collectHeaders(fileHeaderKeys, 2);
+    h.addHeader("Range", rangeFrom(offset));
+    h.addHeader("If-Range", etag);
+    return h.GET();
+  }, ConnectionPool::RETRY_IF_STALE);
+  if (httpCode < 0) {
+    http.end();
+    return 0;  // Still unreachable: worth another attempt
+  }
+  if (httpCode != HTTP_CODE_PARTIAL_CONTENT ||
+      contentRangeStart(http.header("Content-Range").c_str()) != (int32_t)offset) {
+    Serial.printf("[PRINT] Resume at %lu refused: %d\n", (unsigned long)offset, httpCode);
+    http.getStreamPtr()->stop();
+    http.end();
+    return -1;
+  }
+  uint32_t copied = pipeBodyToPico(http, pico, chunk, chunkSize, size - offset);
+  http.end();
+  return copied;
+}
+
+/**
+ * One file of a job to the Pico: "FILE:<id>:<index>:<size>\n" and the raw
+ * bytes, paced by its FILE_ACKs. Read from the cache when prefetched,
+ * otherwise downloaded now; a download that breaks off resumes from the
+ * last byte sent, for the same copy of the file (If-Range). Returns
+ * whether every byte went out.
+ */
+bool sendJobFile(const char* printId, uint32_t id, int f, uint8_t* chunk, size_t chunkSize) {
+  InplaceString<48> header;
+  uint32_t start = millis();
+  PicoFileWriter pico(f);
+  File file = fileCache.open(id, f);
+  if (file) {
+    header.printf("FILE:%s:%d:%lu\n", printId, f, (unsigned long)file.size());
+    PICO_SERIAL.print(header.c_str());
+    size_t n;
+    while ((n = file.read(chunk, chunkSize)) > 0 && pico.write(chunk, n)) {
+    }
+    Serial.printf("[PRINT] File %d: %lu of %lu bytes from cache in %lu ms\n", f,
+                  (unsigned long)pico.sent, (unsigned long)file.size(), millis() - start);
+    bool complete = pico.sent == file.size();
+    file.close();
+    return complete;
   }
   
+  ApiUrl url;
+  url.printf("%s/print-job/%s/download-file?raw=1&fileIndex=%d", API_BASE_URL, printId, f);
+  HTTPClient http;
+  int httpCode = apiPool.request(http, url.c_str(), [](HTTPClient& h) {
+    h.collectHeaders(fileHeaderKeys, 2);
+    return h.GET();
+  }, ConnectionPool::RETRY_IF_STALE);
+  int size = httpCode == HTTP_CODE_OK ? http.getSize() : -1;
+  if (size < 0) {
+    Serial.printf("[PRINT] File %d download failed: %d\n", f, httpCode);
+    http.end();
+    return false;
+  }
+  InplaceString<72> etag;
+  etag = http.header("ETag").c_str();
+  header.printf("FILE:%s:%d:%d\n", printId, f, size);
+  PICO_SERIAL.print(header.c_str());
+  pipeBodyToPico(http, pico, chunk, chunkSize, size);
   http.end();
+  
+  // The header promised this copy's size: only the same copy can finish it
+  for (int attempt = 1; pico.sent < (uint32_t)size && !pico.failed && !etag.empty() &&
+                        !etag.truncated() && attempt <= FILE_RESUME_ATTEMPTS; attempt++) {
+    Serial.printf("[PRINT] File %d broke off at %lu of %d, resuming (%d)\n", f,
+                  (unsigned long)pico.sent, size, attempt);
+    delay(FILE_RESUME_BACKOFF_MS * attempt);
+    if (resumeFileToPico(url.c_str(), etag.c_str(), pico, size, chunk, chunkSize) < 0) {
+      break;
+    }
+  }
+  Serial.printf("[PRINT] File %d: %lu of %d bytes downloaded in %lu ms\n", f,
+                (unsigned long)pico.sent, size, millis() - start);
+  return pico.sent == (uint32_t)size;
 }
 
 /**
- * ============= INTERRUPT HANDLER =============
+ * Stream a job's files to the Pico after it asked for them (SEND_FILES)
+ * The link is held for each file from header to last byte, so command
+ * lines queued meanwhile go out between files. Stops at the first
+ * failure; the Pico's data timeout then fails the job.
  */
+void sendJobFiles(const char* printId, int fileCount) {
+  static uint8_t chunk[1024];  // Network task only
+  uint32_t id = atoi(printId);
+  
+  for (int f = 0; f < fileCount; f++) {
+    xSemaphoreTake(picoTxMutex, portMAX_DELAY);
+    bool sent = sendJobFile(printId, id, f, chunk, sizeof(chunk));
+    xSemaphoreGive(picoTxMutex);
+    if (!sent) {
+      return;
+    }
+  }
+}
 
-void IRAM_ATTR handleButtonInterrupt() {
-  // Check which button is pressed
-  for (int i = 0; i < 11; i++) {
-    if (digitalRead(buttonPins[i]) == LOW) {
-      delay(50);  // Debounce
-      if (digitalRead(buttonPins[i]) == LOW) {
-        handleButtonPress(i);
-        delay(200);  // Debounce delay
+/**
+ * Send whatever the outbox has due (rate limit and backoff permitting)
+ */
+void deliverStatusOutbox() {
+  OutboxEntry batch[OUTBOX_MAX_BATCH];
+  
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  int count = statusOutbox.takeBatch(batch, OUTBOX_MAX_BATCH, millis());
+  xSemaphoreGive(outboxMutex);
+  if (count == 0) {
+    return;
+  }
+  
+  int httpCode = count == 1 ? httpUpdateStatus(batch[0]) : httpUpdateStatusBatch(batch, count);
+  
+  xSemaphoreTake(outboxMutex, portMAX_DELAY);
+  if (httpCode == HTTP_CODE_OK) {
+    Serial.printf("[API] Status updated successfully (%d)\n", count);
+    statusOutbox.delivered(batch, count);
+  } else if (httpCode >= 400 && httpCode < 500 && httpCode != 429) {
+    // Unknown job or invalid status: retrying cannot help
+    Serial.printf("[API] Status update rejected: %d, dropped\n", httpCode);
+    statusOutbox.delivered(batch, count);
+  } else {
+    Serial.printf("[API] Status update failed: %d\n", httpCode);
+    statusOutbox.failed(millis());
+  }
+  xSemaphoreGive(outboxMutex);
+}
+
+void networkTask(void* param) {
+  NetRequest request;
+  bool cacheReady = fileCache.begin();  // May format on first boot: kept off setup()
+  
+  while (true) {
+    // Sleep until a request arrives or the outbox, index sync or prefetch is due
+    xSemaphoreTake(outboxMutex, portMAX_DELAY);
+    uint32_t waitMs = statusOutbox.msUntilDue(millis());
+    xSemaphoreGive(outboxMutex);
+    bool online = WiFi.status() == WL_CONNECTED;
+    if (!online && waitMs < OUTBOX_OFFLINE_POLL_MS) {
+      waitMs = OUTBOX_OFFLINE_POLL_MS;
+    }
+    if (online) {
+      if (!realtime.subscribed() && (long)(nextIndexSync - millis()) > JOB_INDEX_SYNC_INTERVAL_MS) {
+        nextIndexSync = millis() + JOB_INDEX_SYNC_INTERVAL_MS;  // Push lost: poll again
+      }
+      long syncWait = min((long)(nextIndexSync - millis()), (long)(nextPrefetch - millis()));
+      waitMs = min(waitMs, (uint32_t)max(syncWait, 0L));
+    }
+    TickType_t waitTicks = waitMs == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(waitMs);
+    
+    bool received = xQueueReceive(netRequestQueue, &request, waitTicks) == pdTRUE;
+    
+    // Push wake-ups pull the schedule in, never past the rate budget
+    if (received && request.type == NET_SYNC_INDEX &&
+        (long)(nextIndexSync - (lastIndexSync + JOB_INDEX_SYNC_MIN_GAP_MS)) > 0) {
+      nextIndexSync = lastIndexSync + JOB_INDEX_SYNC_MIN_GAP_MS;
+    }
+    if (received && request.type == NET_PREFETCH &&
+        (long)(nextPrefetch - (lastPrefetchRequest + PREFETCH_INTERVAL_MS)) > 0) {
+      nextPrefetch = lastPrefetchRequest + PREFETCH_INTERVAL_MS;
+    }
+    
+    if (received && request.type == NET_SEND_FILES) {
+      sendJobFiles(request.printId, request.fileCount);
+    }
+    
+    if (received && request.type == NET_FETCH_JOB) {
+      NetResponse response = {};
+      response.type = request.type;
+      memcpy(response.printId, request.printId, sizeof(response.printId));
+      
+      if (WiFi.status() != WL_CONNECTED) {
+        response.result = NET_NO_WIFI;
+        apiPool.reset();  // Sockets did not survive the disconnect
+        Serial.println("[API] Request skipped - WiFi disconnected");
+      } else {
+        httpFetchPrintJob(request, response);
+      }
+      
+      if (response.result == NET_OK) {
+        // The user is about to print this job: keep its cached files
+        pinnedPrintId = atoi(request.printId);
+        for (int f = 0; f < response.fileCount; f++) {
+          response.cachedFiles += fileCache.has(pinnedPrintId, f) ? 1 : 0;
+        }
+      }
+      
+      // loop() drains this every pass; waiting here only if it stalls
+      xQueueSend(netResponseQueue, &response, portMAX_DELAY);
+    }
+    
+    // Fetches go first; index sync and status updates ride along under
+    // the rate limit
+    if (WiFi.status() == WL_CONNECTED) {
+      if ((long)(millis() - nextIndexSync) >= 0) {
+        syncJobIndex();
+        lastIndexSync = millis();
+        // Push keeps the index current; polling only catches what it missed
+        nextIndexSync = lastIndexSync + (realtime.subscribed() ? JOB_INDEX_SYNC_PUSH_INTERVAL_MS
+                                                               : JOB_INDEX_SYNC_INTERVAL_MS);
+      }
+      deliverStatusOutbox();
+      if (cacheReady && (long)(millis() - nextPrefetch) >= 0) {
+        uint32_t printId, expires, serverNow;
+        uint8_t fileIndex;
+        if (nextPrefetchTarget(&printId, &fileIndex, &expires, &serverNow)) {
+          lastPrefetchRequest = millis();
+          prefetchFile(printId, fileIndex, expires, serverNow);
+        }
+        nextPrefetch = millis() + PREFETCH_INTERVAL_MS;
       }
     }
   }
 }
 
+/**
+ * ============= REALTIME PUSH =============
+ * Job changes from the kiosk-jobs broadcast channel: same fields as a
+ * job-index row ({ id, status, files, expires })
+ */
+
+void onRealtimeEvent(const char* event, JsonObjectConst job) {
+  if (strcmp(event, "job") != 0) {
+    return;
+  }
+  uint32_t printId = job["id"];
+  const char* status = job["status"] | "";
+  
+  xSemaphoreTake(jobIndexMutex, portMAX_DELAY);
+  if (strcmp(status, "PENDING") == 0) {
+    jobIndex.upsertPending(printId, job["files"], job["expires"]);
+  } else {
+    jobIndex.remove(printId);
+  }
+  xSemaphoreGive(jobIndexMutex);
+  Serial.printf("[RT] Job %06lu -> %s\n", (unsigned long)printId, status);
+  
+  // Prefetch new files, drop files of jobs that left PENDING
+  NetRequest request = {};
+  request.type = NET_PREFETCH;
+  xQueueSend(netRequestQueue, &request, 0);
+}
+
+void onRealtimeSubscribed() {
+  NetRequest request = {};
+  request.type = NET_SYNC_INDEX;
+  xQueueSend(netRequestQueue, &request, 0);
+}
+
+/**
+ * Access token for the private kiosk-jobs channel (realtime task)
+ * Uses its own connection: apiPool belongs to the network task.
+ */
+bool fetchRealtimeToken(char* token, size_t size, uint32_t* ttlSeconds) {
+  static WiFiClientSecure tls;       // Realtime task only
+  static char body[REALTIME_TOKEN_MAX + 128];
+  tls.setInsecure();                 // As apiPool: no CA bundle configured yet
+  
+  ApiUrl url;
+  url.printf("%s/realtime-token", API_BASE_URL);
+  HTTPClient http;
+  if (!http.begin(tls, url.c_str())) {
+    return false;
+  }
+  http.addHeader("X-Kiosk-Key", KIOSK_DEVICE_KEY);
+  int httpCode = http.GET();
+  if (httpCode != HTTP_CODE_OK) {
+    Serial.printf("[RT] Token request failed: %d\n", httpCode);
+    http.end();
+    return false;
+  }
+  BufferSink sink(body, sizeof(body));
+  int streamed = http.writeToStream(&sink);
+  http.end();
+  
+  StaticJsonDocument<256> doc;
+  if (streamed < 0 || sink.overflow || deserializeJson(doc, body, sink.len) || !doc["success"]) {
+    Serial.println("[RT] Token response unusable");
+    return false;
+  }
+  const char* value = doc["access_token"] | "";
+  if (value[0] == '\0' || strlcpy(token, value, size) >= size) {
+    return false;
+  }
+  *ttlSeconds = doc["expires_in"] | 0;
+  return true;
+}
+
+void realtimeTask(void* param) {
+  realtime.begin(REALTIME_URL, REALTIME_TOPIC, onRealtimeEvent, onRealtimeSubscribed,
+                 REALTIME_PRIVATE ? fetchRealtimeToken : NULL);
+  
+  while (true) {
+    if (WiFi.status() != WL_CONNECTED) {
+      realtime.stop();
+      delay(OUTBOX_OFFLINE_POLL_MS);
+      continue;
+    }
+    realtime.poll();
+  }
+}
+
+/**
+ * ============= BOOT TIMELINE =============
+ */
+
+void bootMark(const char* stage) {
+  if (!bootTimelineReported && bootStageCount < BOOT_STAGE_MAX) {
+    bootStages[bootStageCount].name = stage;
+    bootStages[bootStageCount].ms = millis();
+    bootStageCount++;
+  }
+}
+
+void reportBootTimeline() {
+  bootTimelineReported = true;
+  Serial.print("[BOOT] BOOT_TIMELINE");
+  for (int i = 0; i < bootStageCount; i++) {
+    Serial.printf(" %s=%lu", bootStages[i].name, bootStages[i].ms);
+  }
+  Serial.println(" (ms)");
+}
+
 // ============= END OF ESP32 FIRMWARE =============
@@ -7,13 +7,78 @@
 
 // API Configuration
 #define API_BASE_URL "https://printosk.vercel.app/api/kiosk"
+#define KIOSK_DEVICE_KEY "YOUR_KIOSK_DEVICE_KEY"  // X-Kiosk-Key; the backend's KIOSK_DEVICE_KEY
 #define API_TIMEOUT 30000  // 30 seconds
+#define CONN_POOL_TIMEOUT_MS API_TIMEOUT  // Per-request timeout on pooled connections
+
+// Network task: all HTTP runs here, off the UI loop
+#define NET_TASK_CORE 0             // Arduino loop() runs on core 1
+#define NET_TASK_PRIORITY 1
+#define NET_TASK_STACK 12288        // TLS handshake runs on this stack
+#define NET_QUEUE_DEPTH 4           // Pending requests / unconsumed completions
+#define SPINNER_INTERVAL 200        // Fetching screen animation (ms)
+#define PRINT_PROGRESS_REDRAW_MS 500  // Printing screen: bar/ETA refresh limit
+
+// Status outbox: updates persist in NVS and are coalesced per job, then sent
+// in batches under a token bucket. The backend allows 10 requests/minute per
+// device (docs/API_SPECIFICATION.md): status updates get 4, the job index
+// sync 1, prefetch 2, fetches the rest.
+#define OUTBOX_CAPACITY 16          // Distinct jobs with undelivered states
+#define OUTBOX_MAX_BATCH 8          // Updates per request
+#define OUTBOX_RATE_PER_MIN 4
+#define OUTBOX_BURST 3
+#define OUTBOX_BACKOFF_MIN_MS 2000  // Doubles per failure...
+#define OUTBOX_BACKOFF_MAX_MS 300000  // ...up to 5 minutes
+#define OUTBOX_OFFLINE_POLL_MS 1000 // WiFi check interval while updates wait
+
+// Local job index: PENDING Print IDs kept in RAM, delta-synced by updated_at
+#define JOB_INDEX_CAPACITY 256
+#define JOB_INDEX_SYNC_INTERVAL_MS 60000
+#define JOB_INDEX_SYNC_PAGE 50        // Jobs per sync request
+#define JOB_INDEX_SYNC_MAX_PAGES 2    // Per interval, to stay inside the rate limit
+#define JOB_INDEX_SYNC_BODY_MAX 4096  // ~70 bytes per job
+#define JOB_INDEX_SYNC_DOC_SIZE 6144
+#define JOB_INDEX_NOT_FOUND_TTL_MS 60000
+#define JOB_INDEX_EXPIRED_TTL_MS 3600000
+#define JOB_INDEX_SYNC_PUSH_INTERVAL_MS 600000  // While realtime push is subscribed
+#define JOB_INDEX_SYNC_MIN_GAP_MS 60000  // Catch-up syncs after each resubscribe: the sync's 1/minute
+
+// File prefetch: files of indexed PENDING jobs are downloaded to LittleFS
+// ahead of ENTER, one per interval, deduplicated by content hash
+#define CACHE_MAX_BYTES (1024UL * 1024UL)  // Fits the default 1.4 MB data partition
+#define CACHE_MAX_ENTRIES 32
+#define CACHE_MAX_FILE_BYTES (256UL * 1024UL)  // Larger files download on demand
+#define PREFETCH_INTERVAL_MS 30000
+
+// Print files downloaded on demand resume with Range/If-Range when the body
+// breaks off. The Pico allows 30 s between file bytes (FILE_DATA_TIMEOUT_MS),
+// so a stall must be noticed and resumed well inside that.
+#define FILE_STALL_MS 5000          // Body silent this long: reconnect
+#define FILE_RESUME_ATTEMPTS 3      // Range requests per file
+#define FILE_RESUME_BACKOFF_MS 1000 // Times the attempt number
+
+// Realtime push: job changes arrive on a Supabase Realtime broadcast channel
+// (backend/supabase/migrations/002_kiosk_job_broadcast.sql) as they happen.
+// For offline testing point REALTIME_URL at firmware/tools/realtime_standin.py:
+// "ws://<pc-ip>:4000/realtime/v1/websocket?apikey=test&vsn=1.0.0" and set REALTIME_PRIVATE 0
+#define REALTIME_URL "wss://YOUR_PROJECT.supabase.co/realtime/v1/websocket?apikey=YOUR_ANON_KEY&vsn=1.0.0"
+#define REALTIME_TOPIC "realtime:kiosk-jobs"
+#define REALTIME_PRIVATE 1          // Join with a token from /api/kiosk/realtime-token (X-Kiosk-Key)
+#define REALTIME_TASK_STACK 10240   // TLS handshake + one parsed message
+#define REALTIME_HEARTBEAT_MS 25000
+#define REALTIME_BACKOFF_MIN_MS 1000
+#define REALTIME_BACKOFF_MAX_MS 60000
 
 // Hardware Pins - ESP32 DevKit V1
 // OLED I2C (SSD1306)
 #define OLED_SDA_PIN 21
 #define OLED_SCL_PIN 22
 #define OLED_I2C_ADDRESS 0x3C
+#define OLED_I2C_FREQ 1000000       // Page-diff pushes (oled_diff.h); SH1106 spec is 400 kHz
+#define OLED_I2C_FREQ_SAFE 400000   // Used if the panel does not ACK at OLED_I2C_FREQ
+#define OLED_STATS_LOG 0            // 1: log bytes and us of every display update
+#define OLED_TASK_CORE 1            // With loop(): it blocks in the I2C driver, not the CPU
+#define OLED_TASK_PRIORITY 2        // Above loop() so a submitted frame starts at once
 
 // Keypad Pins (GPIO for numeric buttons 0-9)
 #define BUTTON_0_PIN 13
@@ -27,6 +92,9 @@
 #define BUTTON_8_PIN 4
 #define BUTTON_9_PIN 5
 #define BUTTON_ENTER_PIN 15
+#define KEYPAD_DEBOUNCE_TICK_MS 2   // Sampling period while a button is changing
+#define KEYPAD_DEBOUNCE_SAMPLES 8   // Equal samples for a press/release (16 ms)
+#define KEYPAD_QUEUE_DEPTH 32       // Type-ahead events (power of two)
 
 // Serial Communication with Pico
 // Using Serial2 (UART2) with GPIO 16 (RX) and GPIO 17 (TX)
@@ -34,13 +102,29 @@
 #define PICO_SERIAL Serial2
 #define PICO_TX_PIN 17
 #define PICO_RX_PIN 16
-#define PICO_BAUD_RATE 115200
+#define PICO_BAUD_RATE 115200  // Must match the Pico ESP32_LINK_BAUD (PIO link: up to 3000000)
+
+// File data to the Pico is flow controlled: it sends FILE_ACK every 256
+// bytes it consumes (FILE_ACK_BYTES), and at most PICO_FILE_WINDOW bytes go
+// out unacknowledged: at least FILE_ACK_BYTES, and inside its 1 KB RX buffer.
+#define PICO_FILE_WINDOW 512
+#define PICO_FILE_ACK_TIMEOUT_MS 10000  // The Pico stopped taking file data
+
+// Command lines from loop() wait here while a file is going out: a line
+// written inside file data would be taken for file bytes
+#define PICO_TX_QUEUE_DEPTH 4
+#define PICO_COMMAND_MAX 48
 
 // Application Settings
 #define MAX_PRINT_ID_LENGTH 6
 #define DISPLAY_TIMEOUT 30000  // Auto-clear screen after 30 seconds
+#define SUCCESS_SCREEN_MS 3000  // Then back to the welcome screen
 #define MAX_RETRIES 3
 
+// Boot
+#define FAST_BOOT 1                 // No fixed delays; WiFi connects in the background
+#define WIFI_CONNECT_TIMEOUT 10000  // Boot timeline is reported by then at the latest
+
 // Display States
 enum DisplayState {
   STATE_WELCOME,
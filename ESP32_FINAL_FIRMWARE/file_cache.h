@@ -0,0 +1,408 @@
+/**
+ * Printosk - On-Device Print File Cache (ESP32, Arduino, LittleFS)
+ * Files of PENDING jobs downloaded ahead of time, so ENTER does not wait
+ * for the download
+ *
+ * Blobs are stored once per content hash (/cache/<hash>.bin); the manifest
+ * (/cache/manifest) maps (Print ID, file index) to a blob. Two jobs
+ * uploading the same document share one blob.
+ *
+ * Space is bounded by CACHE_MAX_BYTES. Eviction drops entries whose job
+ * has expired first, then the job expiring soonest, then least recently
+ * used.
+ *
+ *   cache.begin();
+ *   if (!cache.has(id, 0) && !cache.link(id, 0, hash, size, expires)) {
+ *     File f = cache.beginWrite(id, 0, hash, size, now, 0);  // Makes room
+ *     ... write body ...
+ *     cache.commit(id, 0, hash, size, expires, f);
+ *   }
+ *   File f = cache.open(id, 0);
+ *
+ * A download that breaks off is kept as the partial (/cache/partial.tmp,
+ * one at a time, survives reboots); resumeOffset() says where a Range
+ * request for the same file should continue.
+ *
+ * Not thread-safe: the network task owns it.
+ */
+
+#ifndef PRINTOSK_FILE_CACHE_H
+#define PRINTOSK_FILE_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include "inplace_string.h"
+
+#ifndef CACHE_MAX_BYTES
+#define CACHE_MAX_BYTES (1024UL * 1024UL)
+#endif
+
+#ifndef CACHE_MAX_ENTRIES
+#define CACHE_MAX_ENTRIES 32
+#endif
+
+#define CACHE_HASH_LEN 16           // Hex digits of SHA-256 kept as the blob name
+#define CACHE_PARTIAL_PATH "/cache/partial.tmp"
+#define CACHE_PARTIAL_INFO "/cache/partial"
+
+typedef InplaceString<sizeof("/cache/.bin") - 1 + CACHE_HASH_LEN> CachePath;
+
+struct CacheEntry {
+  uint32_t printId;
+  uint32_t size;
+  uint32_t expires;                 // Job expiry, server epoch seconds
+  uint32_t lastUsed;                // LRU clock (no wall clock needed)
+  uint8_t fileIndex;
+  bool tooLarge;                    // Known not to fit; never downloaded
+  char hash[CACHE_HASH_LEN + 1];
+};
+
+class FileCache {
+public:
+  bool begin() {
+    if (!LittleFS.begin(true)) {
+      Serial.println("[CACHE] LittleFS mount failed - cache disabled");
+      return false;
+    }
+    LittleFS.mkdir("/cache");
+    mounted = true;
+
+    count = 0;
+    File f = LittleFS.open("/cache/manifest", "r");
+    if (f) {
+      size_t bytes = f.read((uint8_t*)entries, sizeof(entries));
+      count = bytes / sizeof(CacheEntry);
+      f.close();
+    }
+    for (int i = 0; i < count; i++) {
+      if (entries[i].lastUsed >= useClock) {
+        useClock = entries[i].lastUsed + 1;
+      }
+    }
+    // Drop entries whose blob did not survive (power loss mid-write)
+    for (int i = count - 1; i >= 0; i--) {
+      if (!entries[i].tooLarge && !LittleFS.exists(blobPath(entries[i].hash).c_str())) {
+        removeAt(i);
+      }
+    }
+
+    // A partial without its record (power lost mid-download) is useless
+    size_t got = 0;
+    File p = LittleFS.open(CACHE_PARTIAL_INFO, "r");
+    if (p) {
+      got = p.read((uint8_t*)&partial, sizeof(partial));
+      p.close();
+    }
+    if (got != sizeof(partial) || !LittleFS.exists(CACHE_PARTIAL_PATH)) {
+      LittleFS.remove(CACHE_PARTIAL_PATH);
+      clearPartial();
+    }
+    Serial.printf("[CACHE] %d files, %lu bytes cached\n", count, (unsigned long)usedBytes());
+    return true;
+  }
+
+  /**
+   * True if the file is cached or known to be too large to cache
+   */
+  bool known(uint32_t printId, uint8_t fileIndex) const {
+    return find(printId, fileIndex) >= 0;
+  }
+
+  /**
+   * True if the file can be read from flash
+   */
+  bool has(uint32_t printId, uint8_t fileIndex, uint32_t* size = NULL) const {
+    int i = find(printId, fileIndex);
+    if (i < 0 || entries[i].tooLarge) {
+      return false;
+    }
+    if (size != NULL) {
+      *size = entries[i].size;
+    }
+    return true;
+  }
+
+  /**
+   * Reuse an existing blob with the same content; false if there is none
+   */
+  bool link(uint32_t printId, uint8_t fileIndex, const char* hash, uint32_t size, uint32_t expires) {
+    for (int i = 0; i < count; i++) {
+      if (!entries[i].tooLarge && strcmp(entries[i].hash, hash) == 0) {
+        add(printId, fileIndex, hash, size, expires, false);
+        Serial.printf("[CACHE] %06lu/%u: same content as %06lu/%u, linked\n",
+                      (unsigned long)printId, fileIndex,
+                      (unsigned long)entries[i].printId, entries[i].fileIndex);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Remember that a file will not fit, so it is not fetched again
+   */
+  void markTooLarge(uint32_t printId, uint8_t fileIndex, uint32_t size, uint32_t expires) {
+    add(printId, fileIndex, "", size, expires, true);
+  }
+
+  /**
+   * Bytes of this file already on flash from a download that broke off
+   * (0 if none); hash, if given, is set to the content they belong to
+   */
+  uint32_t resumeOffset(uint32_t printId, uint8_t fileIndex, char* hash = NULL) const {
+    if (partial.bytes == 0 || partial.printId != printId || partial.fileIndex != fileIndex) {
+      return 0;
+    }
+    if (hash != NULL) {
+      strlcpy(hash, partial.hash, CACHE_HASH_LEN + 1);
+    }
+    return partial.bytes;
+  }
+
+  /**
+   * Make room for size bytes and open the partial file
+   * offset is where the body starts: resumeOffset() when the server
+   * honoured a Range request for the same content, else 0. Any other
+   * partial is discarded. Returns a closed File if it cannot fit.
+   */
+  File beginWrite(uint32_t printId, uint8_t fileIndex, const char* hash, uint32_t size,
+                  uint32_t nowEpoch, uint32_t offset) {
+    bool resuming = offset > 0 && offset == partial.bytes && partial.printId == printId &&
+                    partial.fileIndex == fileIndex && strcmp(partial.hash, hash) == 0;
+    if (!resuming) {
+      LittleFS.remove(CACHE_PARTIAL_PATH);
+      clearPartial();
+      if (offset > 0) {
+        return File();   // Body continues a partial we no longer have
+      }
+    }
+    if (!mounted || !makeRoom(size, nowEpoch, resuming ? offset : 0)) {
+      return File();
+    }
+    partial.printId = printId;
+    partial.fileIndex = fileIndex;
+    partial.size = size;
+    strlcpy(partial.hash, hash, sizeof(partial.hash));
+    return LittleFS.open(CACHE_PARTIAL_PATH, resuming ? "a" : "w");
+  }
+
+  /**
+   * Finish a download started with beginWrite
+   * The blob only becomes visible once complete (written == size); a short
+   * file stays the partial for resumeOffset().
+   */
+  bool commit(uint32_t printId, uint8_t fileIndex, const char* hash, uint32_t size,
+              uint32_t expires, File& file) {
+    size_t written = file.size();
+    file.close();
+    if (written < size) {
+      partial.bytes = written;
+      savePartial();
+      return false;
+    }
+    bool ok = written == size;
+    if (ok) {
+      LittleFS.remove(blobPath(hash).c_str());
+      ok = LittleFS.rename(CACHE_PARTIAL_PATH, blobPath(hash).c_str());
+    }
+    LittleFS.remove(CACHE_PARTIAL_PATH);
+    clearPartial();
+    if (ok) {
+      add(printId, fileIndex, hash, size, expires, false);
+    }
+    return ok;
+  }
+
+  /**
+   * Open a cached file for reading (closed File if not cached)
+   */
+  File open(uint32_t printId, uint8_t fileIndex) {
+    int i = find(printId, fileIndex);
+    if (i < 0 || entries[i].tooLarge) {
+      return File();
+    }
+    entries[i].lastUsed = useClock++;   // Persisted with the next manifest write
+    return LittleFS.open(blobPath(entries[i].hash).c_str(), "r");
+  }
+
+  /**
+   * Drop every file of a job, deleting blobs nobody else references
+   */
+  void removeJob(uint32_t printId) {
+    if (partial.bytes > 0 && partial.printId == printId) {
+      LittleFS.remove(CACHE_PARTIAL_PATH);
+      clearPartial();
+    }
+    bool changed = false;
+    for (int i = count - 1; i >= 0; i--) {
+      if (entries[i].printId == printId) {
+        removeAt(i);
+        changed = true;
+      }
+    }
+    if (changed) {
+      save();
+    }
+  }
+
+  int size() const { return count; }
+  const CacheEntry& at(int i) const { return entries[i]; }
+
+  uint32_t usedBytes() const {
+    uint32_t total = 0;
+    for (int i = 0; i < count; i++) {
+      if (!entries[i].tooLarge && firstWithHash(entries[i].hash) == i) {
+        total += entries[i].size;
+      }
+    }
+    return total;
+  }
+
+private:
+  // The download that broke off, kept for a Range resume
+  struct Partial {
+    uint32_t printId;
+    uint32_t size;
+    uint32_t bytes;                 // On flash; 0 = no partial
+    uint8_t fileIndex;
+    char hash[CACHE_HASH_LEN + 1];
+  };
+
+  CacheEntry entries[CACHE_MAX_ENTRIES];
+  int count = 0;
+  uint32_t useClock = 1;
+  bool mounted = false;
+  Partial partial = {};
+
+  static CachePath blobPath(const char* hash) {
+    CachePath path;
+    path.printf("/cache/%s.bin", hash);
+    return path;
+  }
+
+  void clearPartial() {
+    memset(&partial, 0, sizeof(partial));
+    LittleFS.remove(CACHE_PARTIAL_INFO);
+  }
+
+  void savePartial() {
+    File f = LittleFS.open(CACHE_PARTIAL_INFO, "w");
+    if (f) {
+      f.write((const uint8_t*)&partial, sizeof(partial));
+      f.close();
+    }
+  }
+
+  int find(uint32_t printId, uint8_t fileIndex) const {
+    for (int i = 0; i < count; i++) {
+      if (entries[i].printId == printId && entries[i].fileIndex == fileIndex) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  int firstWithHash(const char* hash) const {
+    for (int i = 0; i < count; i++) {
+      if (!entries[i].tooLarge && strcmp(entries[i].hash, hash) == 0) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  void add(uint32_t printId, uint8_t fileIndex, const char* hash, uint32_t size,
+           uint32_t expires, bool tooLarge) {
+    int i = find(printId, fileIndex);
+    if (i >= 0 && strcmp(entries[i].hash, hash) != 0) {
+      removeAt(i);   // Content changed: may free the old blob
+      i = -1;
+    }
+    if (i < 0) {
+      if (count == CACHE_MAX_ENTRIES) {
+        removeAt(victim(UINT32_MAX, hash));
+      }
+      i = count++;
+    }
+    CacheEntry& e = entries[i];
+    memset(&e, 0, sizeof(e));
+    e.printId = printId;
+    e.fileIndex = fileIndex;
+    e.size = size;
+    e.expires = expires;
+    e.lastUsed = useClock++;
+    e.tooLarge = tooLarge;
+    strlcpy(e.hash, hash, sizeof(e.hash));
+    save();
+  }
+
+  void removeAt(int i) {
+    char hash[CACHE_HASH_LEN + 1];
+    bool hadBlob = !entries[i].tooLarge;
+    strlcpy(hash, entries[i].hash, sizeof(hash));
+    memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(CacheEntry));
+    count--;
+    if (hadBlob && firstWithHash(hash) < 0) {
+      LittleFS.remove(blobPath(hash).c_str());
+    }
+  }
+
+  // Entry to evict: expired job first, then soonest expiry, then LRU
+  // Entries sharing keepHash (the blob being linked or written) are spared.
+  int victim(uint32_t nowEpoch, const char* keepHash) const {
+    int best = -1;
+    for (int i = 0; i < count; i++) {
+      const CacheEntry& e = entries[i];
+      if (keepHash[0] != '\0' && strcmp(e.hash, keepHash) == 0) {
+        continue;
+      }
+      if (best < 0) {
+        best = i;
+        continue;
+      }
+      const CacheEntry& b = entries[best];
+      if (e.expires <= nowEpoch && b.expires > nowEpoch) {
+        best = i;
+      } else if ((e.expires <= nowEpoch) == (b.expires <= nowEpoch) &&
+                 (e.expires < b.expires || (e.expires == b.expires && e.lastUsed < b.lastUsed))) {
+        best = i;
+      }
+    }
+    return best < 0 ? 0 : best;
+  }
+
+  // alreadyWritten: bytes of the file already on flash as the partial
+  bool makeRoom(uint32_t size, uint32_t nowEpoch, uint32_t alreadyWritten) {
+    uint32_t limit = CACHE_MAX_BYTES;
+    uint32_t fsFree = LittleFS.totalBytes() - LittleFS.usedBytes() + usedBytes() + alreadyWritten;
+    if (fsFree < limit) {
+      limit = fsFree;
+    }
+    if (size > limit) {
+      return false;
+    }
+    bool changed = false;
+    while (count > 0 && usedBytes() + size > limit) {
+      int i = victim(nowEpoch, "");
+      Serial.printf("[CACHE] Evicting %06lu/%u (%lu bytes)\n", (unsigned long)entries[i].printId,
+                    entries[i].fileIndex, (unsigned long)entries[i].size);
+      removeAt(i);
+      changed = true;
+    }
+    if (changed) {
+      save();
+    }
+    return true;
+  }
+
+  void save() {
+    File f = LittleFS.open("/cache/manifest", "w");
+    if (f) {
+      f.write((const uint8_t*)entries, count * sizeof(CacheEntry));
+      f.close();
+    }
+  }
+};
+
+#endif // PRINTOSK_FILE_CACHE_H
@@ -0,0 +1,130 @@
+/**
+ * Printosk - Fixed-Capacity Strings (ESP32, Arduino)
+ * A string that lives entirely inside its object (stack, global or
+ * struct member), for the text the kiosk builds over and over: Print IDs,
+ * URLs, Pico commands, log lines
+ *
+ * Arduino String grows on the heap with every +=; after days of uptime
+ * the heap is a patchwork of small holes and a TLS handshake can no
+ * longer find the contiguous block it needs. InplaceString never
+ * allocates: writes that do not fit are cut at the capacity and flagged.
+ *
+ *   InplaceString<6> id;
+ *   id += "4";                                        // Like String +=
+ *   InplaceString<48> command;
+ *   command.printf("START_PRINT:%s:%d", id.c_str(), files);
+ *   if (command.truncated()) { ... }
+ */
+
+#ifndef PRINTOSK_INPLACE_STRING_H
+#define PRINTOSK_INPLACE_STRING_H
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+template <size_t N>
+class InplaceString {
+public:
+  InplaceString() { clear(); }
+
+  InplaceString(const char* text) {
+    clear();
+    append(text);
+  }
+
+  InplaceString& operator=(const char* text) {
+    clear();
+    return append(text);
+  }
+
+  void clear() {
+    len = 0;
+    cut = false;
+    buf[0] = '\0';
+  }
+
+  InplaceString& append(const char* text) {
+    size_t n = strlen(text);
+    if (n > N - len) {
+      n = N - len;
+      cut = true;
+    }
+    memcpy(buf + len, text, n);
+    len += n;
+    buf[len] = '\0';
+    return *this;
+  }
+
+  InplaceString& append(char c) {
+    if (len < N) {
+      buf[len++] = c;
+      buf[len] = '\0';
+    } else {
+      cut = true;
+    }
+    return *this;
+  }
+
+  InplaceString& operator+=(const char* text) { return append(text); }
+  InplaceString& operator+=(char c) { return append(c); }
+
+  /**
+   * Replace the contents with printf-style output; returns the length
+   */
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    clear();
+    vappendf(format, args);
+    va_end(args);
+    return len;
+  }
+
+  /**
+   * Append printf-style output; returns the length
+   */
+  size_t appendf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    va_list args;
+    va_start(args, format);
+    vappendf(format, args);
+    va_end(args);
+    return len;
+  }
+
+  const char* c_str() const { return buf; }
+  size_t length() const { return len; }
+  bool empty() const { return len == 0; }
+  bool full() const { return len == N; }
+  static size_t capacity() { return N; }
+
+  /**
+   * Some write since the last clear did not fit
+   */
+  bool truncated() const { return cut; }
+
+  bool operator==(const char* text) const { return strcmp(buf, text) == 0; }
+  bool operator!=(const char* text) const { return strcmp(buf, text) != 0; }
+
+private:
+  char buf[N + 1];
+  size_t len;
+  bool cut;
+
+  void vappendf(const char* format, va_list args) {
+    int n = vsnprintf(buf + len, N + 1 - len, format, args);
+    if (n < 0) {
+      buf[len] = '\0';
+      cut = true;
+      return;
+    }
+    if ((size_t)n > N - len) {
+      len = N;
+      cut = true;
+    } else {
+      len += n;
+    }
+  }
+};
+
+#endif // PRINTOSK_INPLACE_STRING_H
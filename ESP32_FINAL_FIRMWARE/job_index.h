@@ -0,0 +1,198 @@
+/**
+ * Printosk - Local Job Index (ESP32, Arduino)
+ * Compact copy of the backend's PENDING jobs keyed on the 6-digit Print ID,
+ * so ENTER can answer from RAM before the network confirms
+ *
+ * Entries are kept sorted by Print ID (binary search, ~8 compares for 256
+ * entries). Besides PENDING jobs it holds negative entries for IDs the
+ * backend answered 404/410 for, which expire after a TTL.
+ *
+ *   index.upsertPending(123456, 2, expiresEpoch);   // From a delta sync
+ *   index.addNegative(654321, JOB_INDEX_NOT_FOUND, millis());
+ *   JobIndexState s = index.lookup(123456, millis(), &files);
+ *
+ * Not thread-safe: callers on different tasks hold a mutex around each call.
+ */
+
+#ifndef PRINTOSK_JOB_INDEX_H
+#define PRINTOSK_JOB_INDEX_H
+
+#include <Arduino.h>
+
+#ifndef JOB_INDEX_CAPACITY
+#define JOB_INDEX_CAPACITY 256
+#endif
+
+#ifndef JOB_INDEX_NOT_FOUND_TTL_MS
+#define JOB_INDEX_NOT_FOUND_TTL_MS 60000     // The ID may be issued later
+#endif
+
+#ifndef JOB_INDEX_EXPIRED_TTL_MS
+#define JOB_INDEX_EXPIRED_TTL_MS 3600000     // Expired jobs stay expired
+#endif
+
+enum JobIndexState : uint8_t {
+  JOB_INDEX_MISS,          // Unknown: ask the backend
+  JOB_INDEX_PENDING,       // Known PENDING job; the fetch only confirms
+  JOB_INDEX_NOT_FOUND,     // Backend said 404 recently
+  JOB_INDEX_EXPIRED        // Backend said 410 recently
+};
+
+struct JobIndexEntry {
+  uint32_t printId;
+  uint32_t expires;        // PENDING: server epoch seconds; negative: millis() deadline
+  uint16_t fileCount;
+  JobIndexState state;
+};
+
+class JobIndex {
+public:
+  /**
+   * Look up a Print ID; fileCount is set for PENDING hits
+   */
+  JobIndexState lookup(uint32_t printId, uint32_t nowMs, uint16_t* fileCount = NULL) const {
+    int i = find(printId);
+    if (i < 0 || expired(entries[i], nowMs)) {
+      return JOB_INDEX_MISS;
+    }
+    if (fileCount != NULL) {
+      *fileCount = entries[i].fileCount;
+    }
+    return entries[i].state;
+  }
+
+  /**
+   * Record a PENDING job (replaces any negative entry for the ID)
+   */
+  void upsertPending(uint32_t printId, uint16_t fileCount, uint32_t expiresEpoch) {
+    JobIndexEntry* e = slotFor(printId);
+    e->expires = expiresEpoch;
+    e->fileCount = fileCount;
+    e->state = JOB_INDEX_PENDING;
+  }
+
+  /**
+   * Record a 404/410 answer for the negative-entry TTL
+   */
+  void addNegative(uint32_t printId, JobIndexState state, uint32_t nowMs) {
+    JobIndexEntry* e = slotFor(printId);
+    e->expires = nowMs + (state == JOB_INDEX_EXPIRED ? JOB_INDEX_EXPIRED_TTL_MS : JOB_INDEX_NOT_FOUND_TTL_MS);
+    e->fileCount = 0;
+    e->state = state;
+  }
+
+  /**
+   * The job left PENDING (printing, completed, cancelled...)
+   */
+  void remove(uint32_t printId) {
+    int i = find(printId);
+    if (i >= 0) {
+      removeAt(i);
+    }
+  }
+
+  /**
+   * Anchor server time: epoch seconds as reported by the last sync
+   */
+  void setServerTime(uint32_t epoch, uint32_t nowMs) {
+    serverEpoch = epoch;
+    serverEpochAtMs = nowMs;
+  }
+
+  /**
+   * Drop every expired entry
+   */
+  void prune(uint32_t nowMs) {
+    for (int i = count - 1; i >= 0; i--) {
+      if (expired(entries[i], nowMs)) {
+        removeAt(i);
+      }
+    }
+  }
+
+  int size() const { return count; }
+  const JobIndexEntry& at(int i) const { return entries[i]; }
+
+  /**
+   * Current server time in epoch seconds (0 before the first sync)
+   */
+  uint32_t serverNow(uint32_t nowMs) const {
+    return serverEpoch == 0 ? 0 : serverEpoch + (nowMs - serverEpochAtMs) / 1000;
+  }
+
+  // Delta sync position (opaque to the kiosk; "" means a full sync)
+  char cursor[32] = "";
+
+private:
+  JobIndexEntry entries[JOB_INDEX_CAPACITY];
+  int count = 0;
+  uint32_t serverEpoch = 0;
+  uint32_t serverEpochAtMs = 0;
+
+  bool expired(const JobIndexEntry& e, uint32_t nowMs) const {
+    if (e.state != JOB_INDEX_PENDING) {
+      return (int32_t)(nowMs - e.expires) >= 0;
+    }
+    // Without a server time yet, trust the last sync
+    return serverEpoch != 0 && serverNow(nowMs) >= e.expires;
+  }
+
+  // Index of printId, or -1
+  int find(uint32_t printId) const {
+    int lo = 0, hi = count - 1;
+    while (lo <= hi) {
+      int mid = (lo + hi) / 2;
+      if (entries[mid].printId == printId) {
+        return mid;
+      }
+      if (entries[mid].printId < printId) {
+        lo = mid + 1;
+      } else {
+        hi = mid - 1;
+      }
+    }
+    return -1;
+  }
+
+  void removeAt(int i) {
+    memmove(&entries[i], &entries[i + 1], (count - i - 1) * sizeof(JobIndexEntry));
+    count--;
+  }
+
+  // Existing entry for printId, or a new one inserted in order
+  JobIndexEntry* slotFor(uint32_t printId) {
+    int i = find(printId);
+    if (i >= 0) {
+      return &entries[i];
+    }
+    if (count == JOB_INDEX_CAPACITY) {
+      evictOne();
+    }
+
+    int pos = 0;
+    while (pos < count && entries[pos].printId < printId) {
+      pos++;
+    }
+    memmove(&entries[pos + 1], &entries[pos], (count - pos) * sizeof(JobIndexEntry));
+    count++;
+    entries[pos].printId = printId;
+    return &entries[pos];
+  }
+
+  // Negative entries go first, then the PENDING job closest to expiry
+  void evictOne() {
+    int victim = 0;
+    for (int i = 0; i < count; i++) {
+      if (entries[i].state != JOB_INDEX_PENDING) {
+        removeAt(i);
+        return;
+      }
+      if (entries[i].expires < entries[victim].expires) {
+        victim = i;
+      }
+    }
+    removeAt(victim);
+  }
+};
+
+#endif // PRINTOSK_JOB_INDEX_H
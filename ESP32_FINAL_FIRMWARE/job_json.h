@@ -0,0 +1,325 @@
+/**
+ * Printosk - Streaming Job JSON Parser
+ * Extracts the kiosk fetch response (GET /api/kiosk/print-job/:id) into a
+ * fixed PrintJob struct while the body streams in, without buffering it:
+ *
+ *   { "success": true,
+ *     "printJob": { "id": "...", "print_id_numeric": 123456, "status": "...",
+ *                   "color_mode": ..., "paper_size": "...",
+ *                   "duplex_mode": ..., "copies": 1, ... },
+ *     "files": [ { "page_count": 3, ... }, ... ] }
+ *
+ * files is never stored: elements are counted into file_count and their
+ * page_count summed into total_pages, so memory use is sizeof(JobJsonParser)
+ * (no heap) however many files the job has. Unknown keys and nested values
+ * are skipped.
+ *
+ *   PrintJob job;
+ *   JobJsonParser parser(&job);
+ *   parser.feed(chunk, len);  // any chunking, repeatedly
+ *   if (parser.finish() && parser.success()) { ... }
+ *
+ * Plain C++ (no Arduino dependency) so it can be exercised on a host.
+ *
+ * Edit the firmware/common version; firmware/tools/sync_common_headers.sh
+ * copies it into ESP32_FINAL_FIRMWARE/ (the Arduino IDE only builds files
+ * inside the sketch folder).
+ */
+
+#ifndef PRINTOSK_JOB_JSON_H
+#define PRINTOSK_JOB_JSON_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Structure for print job data
+struct PrintJob {
+  char id[37];              // UUID string
+  int print_id_numeric;     // 6-digit Print ID
+  char job_title[256];
+  bool color_mode;
+  int copies;
+  char paper_size[20];
+  bool double_sided;
+  char status[20];
+  int total_pages;
+  int file_count;
+};
+
+#ifndef JOB_JSON_MAX_DEPTH
+#define JOB_JSON_MAX_DEPTH 8
+#endif
+
+class JobJsonParser {
+public:
+  explicit JobJsonParser(PrintJob* job) : job(job) {
+    memset(job, 0, sizeof(*job));
+  }
+
+  /**
+   * Parse the next chunk; false once the input is malformed
+   */
+  bool feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len && !failed; i++) {
+      failed = !step(data[i]);
+    }
+    return !failed;
+  }
+
+  /**
+   * End of input; true if exactly one complete JSON document was seen
+   */
+  bool finish() {
+    if (!failed && state == S_LITERAL && depth == 0) {
+      complete = true;
+    }
+    return complete && !failed;
+  }
+
+  // "success": true at the top level
+  bool success() const { return successFlag; }
+
+private:
+  enum Section : uint8_t { SEC_OTHER, SEC_ROOT, SEC_PRINT_JOB, SEC_FILES, SEC_FILE };
+  enum State : uint8_t {
+    S_VALUE,        // Expecting a value
+    S_AFTER_VALUE,  // Expecting ',' or a closing bracket
+    S_KEY,          // Expecting a key (or '}' right after '{')
+    S_COLON,
+    S_STRING,
+    S_ESCAPE,
+    S_UNICODE,
+    S_LITERAL,      // Number, true, false, null
+    S_DONE
+  };
+
+  struct Frame {
+    bool isObject;
+    Section section;
+  };
+
+  PrintJob* job;
+  Frame stack[JOB_JSON_MAX_DEPTH];
+  uint8_t depth = 0;
+  State state = S_VALUE;
+  bool allowClose = false;     // Empty container: '}' / ']' may follow the opener
+  bool inKey = false;          // S_STRING is reading a key
+  uint8_t unicodeLeft = 0;
+  char key[24];
+  uint8_t keyLen = 0;
+  bool keyOverflow = false;    // Longer than any key of interest
+  char value[64];
+  uint8_t valueLen = 0;
+  bool complete = false;
+  bool failed = false;
+  bool successFlag = false;
+
+  static bool isSpace(char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+  bool keyIs(const char* name) const { return !keyOverflow && strcmp(key, name) == 0; }
+
+  void append(char c) {
+    if (inKey) {
+      if (keyLen < sizeof(key) - 1) {
+        key[keyLen++] = c;
+      } else {
+        keyOverflow = true;
+      }
+    } else if (valueLen < sizeof(value) - 1) {
+      value[valueLen++] = c;   // Longer values are truncated
+    }
+  }
+
+  Section sectionFor(bool isObject) {
+    if (depth == 0) {
+      return isObject ? SEC_ROOT : SEC_OTHER;
+    }
+    const Frame& parent = stack[depth - 1];
+    if (parent.section == SEC_ROOT && parent.isObject) {
+      if (isObject && keyIs("printJob")) return SEC_PRINT_JOB;
+      if (!isObject && keyIs("files")) return SEC_FILES;
+    }
+    if (parent.section == SEC_FILES && isObject) {
+      job->file_count++;
+      return SEC_FILE;
+    }
+    return SEC_OTHER;
+  }
+
+  bool open(bool isObject) {
+    if (depth == JOB_JSON_MAX_DEPTH) {
+      return false;
+    }
+    Section section = sectionFor(isObject);
+    stack[depth++] = { isObject, section };
+    state = isObject ? S_KEY : S_VALUE;
+    allowClose = true;
+    return true;
+  }
+
+  void close() {
+    depth--;
+    if (depth == 0) {
+      complete = true;
+      state = S_DONE;
+    } else {
+      state = S_AFTER_VALUE;
+    }
+  }
+
+  void copyValue(char* dst, size_t size) const {
+    size_t n = valueLen < size - 1 ? valueLen : size - 1;
+    memcpy(dst, value, n);
+    dst[n] = '\0';
+  }
+
+  // A string or literal value finished; value[] holds it
+  void onScalar(bool isString) {
+    value[valueLen] = '\0';
+    if (depth == 0) {
+      complete = true;
+      state = S_DONE;
+      return;
+    }
+    state = S_AFTER_VALUE;
+
+    const Frame& frame = stack[depth - 1];
+    if (!frame.isObject) {
+      return;
+    }
+
+    switch (frame.section) {
+      case SEC_ROOT:
+        if (keyIs("success")) successFlag = !isString && strcmp(value, "true") == 0;
+        break;
+      case SEC_PRINT_JOB:
+        if (keyIs("id")) copyValue(job->id, sizeof(job->id));
+        else if (keyIs("print_id_numeric")) job->print_id_numeric = atoi(value);
+        else if (keyIs("status")) copyValue(job->status, sizeof(job->status));
+        else if (keyIs("paper_size")) copyValue(job->paper_size, sizeof(job->paper_size));
+        else if (keyIs("copies")) job->copies = atoi(value);
+        // Boolean in the Supabase schema, enum string in the kiosk API
+        else if (keyIs("color_mode")) job->color_mode = strcmp(value, "true") == 0 || strcmp(value, "COLOR") == 0;
+        else if (keyIs("duplex_mode")) job->double_sided = strcmp(value, "true") == 0 || strstr(value, "_EDGE") != NULL;
+        break;
+      case SEC_FILE:
+        if (keyIs("page_count") && !isString) job->total_pages += atoi(value);
+        break;
+      default:
+        break;
+    }
+  }
+
+  bool step(char c) {
+    switch (state) {
+      case S_VALUE:
+        if (isSpace(c)) return true;
+        if (c == ']' && allowClose && depth > 0 && !stack[depth - 1].isObject) {
+          close();
+          return true;
+        }
+        allowClose = false;
+        if (c == '{') return open(true);
+        if (c == '[') return open(false);
+        valueLen = 0;
+        if (c == '"') {
+          inKey = false;
+          state = S_STRING;
+          return true;
+        }
+        if (c == '-' || (c >= '0' && c <= '9') || c == 't' || c == 'f' || c == 'n') {
+          append(c);
+          state = S_LITERAL;
+          return true;
+        }
+        return false;
+
+      case S_LITERAL:
+        if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '.' || c == '-' || c == '+' || c == 'E') {
+          append(c);
+          return true;
+        }
+        onScalar(false);
+        return step(c);   // The terminator belongs to the enclosing container
+
+      case S_STRING:
+        if (c == '"') {
+          if (inKey) {
+            key[keyLen] = '\0';
+            inKey = false;
+            state = S_COLON;
+          } else {
+            onScalar(true);
+          }
+        } else if (c == '\\') {
+          state = S_ESCAPE;
+        } else {
+          append(c);
+        }
+        return true;
+
+      case S_ESCAPE:
+        if (c == 'u') {
+          append('?');     // Non-ASCII is not needed by any field of interest
+          unicodeLeft = 4;
+          state = S_UNICODE;
+          return true;
+        }
+        append(c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c == 'b' ? '\b' : c == 'f' ? '\f' : c);
+        state = S_STRING;
+        return true;
+
+      case S_UNICODE:
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))) {
+          return false;
+        }
+        if (--unicodeLeft == 0) {
+          state = S_STRING;
+        }
+        return true;
+
+      case S_KEY:
+        if (isSpace(c)) return true;
+        if (c == '}' && allowClose) {
+          close();
+          return true;
+        }
+        if (c != '"') return false;
+        allowClose = false;
+        inKey = true;
+        keyLen = 0;
+        keyOverflow = false;
+        state = S_STRING;
+        return true;
+
+      case S_COLON:
+        if (isSpace(c)) return true;
+        if (c != ':') return false;
+        state = S_VALUE;
+        return true;
+
+      case S_AFTER_VALUE: {
+        if (isSpace(c)) return true;
+        bool inObject = stack[depth - 1].isObject;
+        if (c == ',') {
+          state = inObject ? S_KEY : S_VALUE;
+          allowClose = false;
+          return true;
+        }
+        if ((c == '}' && inObject) || (c == ']' && !inObject)) {
+          close();
+          return true;
+        }
+        return false;
+      }
+
+      case S_DONE:
+        return isSpace(c);
+    }
+    return false;
+  }
+};
+
+#endif // PRINTOSK_JOB_JSON_H
@@ -0,0 +1,202 @@
+/**
+ * Printosk - Interrupt-Driven Keypad (ESP32, Arduino)
+ * Direct-wired buttons (active low, internal pull-ups) read through edge
+ * interrupts and a debounce timer, delivered as timestamped events through
+ * a lock-free queue
+ *
+ * An edge on any button arms a FreeRTOS software timer. Each tick shifts
+ * every button's level into an 8-bit history; a button is down once
+ * KEYPAD_DEBOUNCE_SAMPLES ticks in a row read pressed, and up once as
+ * many read released. The timer stops when every button has settled, so
+ * an idle or held keypad costs nothing.
+ *
+ *   keypad.begin(pins, 11);
+ *   KeyEvent event;
+ *   while (keypad.read(&event)) {            // loop(): never waits
+ *     if (event.type == KEY_DOWN) { ... event.key, event.timeUs ... }
+ *   }
+ *
+ * Events queue up while loop() is busy (type-ahead) and come out in the
+ * order they happened. The queue has one producer (the timer task) and one
+ * consumer (loop()), so it needs no lock.
+ */
+
+#ifndef PRINTOSK_KEYPAD_DRIVER_H
+#define PRINTOSK_KEYPAD_DRIVER_H
+
+#include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/timers.h>
+
+#ifndef KEYPAD_MAX_KEYS
+#define KEYPAD_MAX_KEYS 16
+#endif
+
+#ifndef KEYPAD_QUEUE_DEPTH
+#define KEYPAD_QUEUE_DEPTH 32       // Power of two
+#endif
+
+#ifndef KEYPAD_DEBOUNCE_TICK_MS
+#define KEYPAD_DEBOUNCE_TICK_MS 2
+#endif
+
+#ifndef KEYPAD_DEBOUNCE_SAMPLES
+#define KEYPAD_DEBOUNCE_SAMPLES 8   // 1-8; x tick = debounce time
+#endif
+
+// An edge older than this when its button settles was a glitch, not the
+// start of the change
+#define KEYPAD_EDGE_MAX_AGE_US (4000UL * KEYPAD_DEBOUNCE_SAMPLES * KEYPAD_DEBOUNCE_TICK_MS)
+
+// History of a button that read pressed on every one of the last samples
+#define KEYPAD_SETTLED ((uint8_t)(0xFF >> (8 - KEYPAD_DEBOUNCE_SAMPLES)))
+
+enum KeyEventType : uint8_t {
+  KEY_DOWN,
+  KEY_UP
+};
+
+struct KeyEvent {
+  uint8_t key;                      // Index into the pins passed to begin()
+  KeyEventType type;
+  uint32_t timeUs;                  // First edge of the change (micros())
+};
+
+class KeypadDriver {
+public:
+  bool begin(const int* pins, uint8_t count) {
+    this->count = count < KEYPAD_MAX_KEYS ? count : KEYPAD_MAX_KEYS;
+    TickType_t period = pdMS_TO_TICKS(KEYPAD_DEBOUNCE_TICK_MS);
+    timer = xTimerCreate("keypad", period > 0 ? period : 1, pdFALSE, this, tick);
+    if (timer == NULL) {
+      return false;
+    }
+    for (uint8_t i = 0; i < this->count; i++) {
+      this->pins[i] = pins[i];
+      pinMode(pins[i], INPUT_PULLUP);
+      history[i] = 0;
+      down[i] = false;
+      edgeUs[i] = 0;
+      slots[i].self = this;
+      slots[i].index = i;
+      attachInterruptArg(digitalPinToInterrupt(pins[i]), onEdge, &slots[i], CHANGE);
+    }
+    // Buttons already held at boot are picked up on the first tick
+    armed = true;
+    xTimerStart(timer, 0);
+    return true;
+  }
+
+  /**
+   * Next event in order of occurrence; false if none is waiting
+   */
+  bool read(KeyEvent* event) {
+    uint32_t head = __atomic_load_n(&queueHead, __ATOMIC_ACQUIRE);
+    if (queueTail == head) {
+      return false;
+    }
+    *event = queue[queueTail % KEYPAD_QUEUE_DEPTH];
+    __atomic_store_n(&queueTail, queueTail + 1, __ATOMIC_RELEASE);
+    return true;
+  }
+
+  bool isDown(uint8_t key) const { return key < count && down[key]; }
+
+  uint32_t events = 0;              // Queued since boot
+  uint32_t dropped = 0;             // Lost to a full queue
+  uint32_t ticks = 0;               // Debounce timer runs
+
+private:
+  struct Slot {
+    KeypadDriver* self;
+    uint8_t index;
+  };
+
+  uint8_t count = 0;
+  int pins[KEYPAD_MAX_KEYS];
+  Slot slots[KEYPAD_MAX_KEYS];
+  uint8_t history[KEYPAD_MAX_KEYS];  // Timer task only
+  bool down[KEYPAD_MAX_KEYS];        // Debounced state; timer task writes
+  volatile uint32_t edgeUs[KEYPAD_MAX_KEYS];  // First edge since the last event, 0 if none
+  volatile bool armed = false;
+  TimerHandle_t timer = NULL;
+
+  KeyEvent queue[KEYPAD_QUEUE_DEPTH];
+  uint32_t queueHead = 0;           // Written by the timer task only
+  uint32_t queueTail = 0;           // Written by read() only
+
+  /**
+   * Edge ISR: note when the change began and make sure the timer runs
+   */
+  static void IRAM_ATTR onEdge(void* arg) {
+    Slot* slot = (Slot*)arg;
+    KeypadDriver* self = slot->self;
+    uint32_t now = micros();
+    uint32_t first = self->edgeUs[slot->index];
+    if (first == 0 || now - first > KEYPAD_EDGE_MAX_AGE_US) {
+      self->edgeUs[slot->index] = now | 1;   // Never 0
+    }
+    if (!self->armed) {
+      self->armed = true;
+      BaseType_t woken = pdFALSE;
+      xTimerStartFromISR(self->timer, &woken);
+      if (woken == pdTRUE) {
+        portYIELD_FROM_ISR();
+      }
+    }
+  }
+
+  /**
+   * Debounce tick (timer task): sample, emit settled changes, re-arm until
+   * every button is stable
+   */
+  static void tick(TimerHandle_t timer) {
+    KeypadDriver* self = (KeypadDriver*)pvTimerGetTimerID(timer);
+    // Cleared before sampling: an edge after this re-arms, one before it is
+    // in the samples below
+    self->armed = false;
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    self->ticks++;
+
+    bool settled = true;
+    for (uint8_t i = 0; i < self->count; i++) {
+      uint8_t level = digitalRead(self->pins[i]) == LOW ? 1 : 0;
+      uint8_t h = (uint8_t)(((self->history[i] << 1) | level) & KEYPAD_SETTLED);
+      self->history[i] = h;
+
+      if (!self->down[i] && h == KEYPAD_SETTLED) {
+        self->down[i] = true;
+        self->emit(i, KEY_DOWN);
+      } else if (self->down[i] && h == 0) {
+        self->down[i] = false;
+        self->emit(i, KEY_UP);
+      } else if (h != (self->down[i] ? KEYPAD_SETTLED : 0)) {
+        settled = false;
+      }
+    }
+
+    if (!settled) {
+      self->armed = true;
+      xTimerStart(timer, 0);
+    }
+  }
+
+  void emit(uint8_t key, KeyEventType type) {
+    uint32_t now = micros();
+    uint32_t at = edgeUs[key];
+    edgeUs[key] = 0;
+    uint32_t tail = __atomic_load_n(&queueTail, __ATOMIC_ACQUIRE);
+    if (queueHead - tail >= KEYPAD_QUEUE_DEPTH) {
+      dropped++;
+      return;
+    }
+    KeyEvent& event = queue[queueHead % KEYPAD_QUEUE_DEPTH];
+    event.key = key;
+    event.type = type;
+    event.timeUs = (at != 0 && now - at <= KEYPAD_EDGE_MAX_AGE_US) ? at : now;
+    __atomic_store_n(&queueHead, queueHead + 1, __ATOMIC_RELEASE);
+    events++;
+  }
+};
+
+#endif // PRINTOSK_KEYPAD_DRIVER_H
@@ -0,0 +1,247 @@
+/**
+ * Printosk - Page-Diff OLED Refresh (ESP32, Arduino, SH1106)
+ * Sends only the bytes of the framebuffer that changed since the last
+ * push, instead of the full 1 KB that Adafruit's display() transfers
+ *
+ * The panel is 8 pages of 128 columns, one byte per column per page. A
+ * shadow copy holds what the panel shows; each push compares the drawn
+ * buffer against it page by page and sends each changed column span with
+ * its own page/column address. Spans separated by fewer unchanged bytes
+ * than a new address costs are merged.
+ *
+ *   display.clearDisplay();
+ *   ... draw with Adafruit_GFX ...
+ *   oled.push(display.getBuffer());   // Instead of display.display()
+ *
+ * Typing a digit changes 3 pages x 12 columns: ~60 bytes on the bus
+ * instead of ~1100.
+ *
+ * OledPresenter runs the pushes on a background task, so the UI never
+ * waits for the bus:
+ *
+ *   presenter.begin(&Wire, 0x3C, 1, 2);
+ *   ... draw ...
+ *   presenter.submit(display.getBuffer());   // ~1 KB memcpy, returns at once
+ *
+ * OledDiff alone is not thread-safe: one task owns it.
+ */
+
+#ifndef PRINTOSK_OLED_DIFF_H
+#define PRINTOSK_OLED_DIFF_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#ifndef OLED_DIFF_MERGE_GAP
+#define OLED_DIFF_MERGE_GAP 7       // Bytes a new span costs: 2 addresses + 4 command/control
+#endif
+
+#ifndef OLED_I2C_CHUNK
+#define OLED_I2C_CHUNK 127          // Data bytes per transaction (Wire buffer is 128)
+#endif
+
+#ifndef OLED_STATS_LOG
+#define OLED_STATS_LOG 0            // 1: log bytes and us of every transfer
+#endif
+
+#define OLED_WIDTH 128
+#define OLED_PAGES 8
+#define OLED_FRAME_BYTES (OLED_WIDTH * OLED_PAGES)
+#define OLED_SH1106_COLUMN_OFFSET 2  // 128 visible columns centred in 132 of RAM
+
+struct OledStats {
+  uint32_t updates;
+  uint32_t bytes;                   // On the bus, all updates (address bytes included)
+  uint32_t lastBytes;
+  uint32_t lastUs;
+  uint32_t maxUs;
+  uint32_t totalUs;
+};
+
+class OledDiff {
+public:
+  void begin(TwoWire* wire, uint8_t address) {
+    this->wire = wire;
+    this->address = address;
+    invalidate();
+  }
+
+  /**
+   * Forget what the panel shows: the next push sends every byte
+   */
+  void invalidate() {
+    full = true;
+  }
+
+  /**
+   * Transfer what changed in buffer (Adafruit page layout, 1024 bytes)
+   * Returns the bytes put on the bus.
+   */
+  uint32_t push(const uint8_t* buffer) {
+    uint32_t start = micros();
+    uint32_t bytes = 0;
+
+    for (uint8_t page = 0; page < OLED_PAGES; page++) {
+      const uint8_t* now = buffer + page * OLED_WIDTH;
+      uint8_t* shown = shadow[page];
+      int col = 0;
+      while (col < OLED_WIDTH) {
+        if (!full && now[col] == shown[col]) {
+          col++;
+          continue;
+        }
+        // Extend the span while gaps stay cheaper than a new address
+        int end = col;
+        int gap = 0;
+        for (int c = col + 1; c < OLED_WIDTH && gap <= OLED_DIFF_MERGE_GAP; c++) {
+          if (full || now[c] != shown[c]) {
+            end = c;
+            gap = 0;
+          } else {
+            gap++;
+          }
+        }
+        bytes += sendSpan(page, col, now + col, end - col + 1);
+        memcpy(shown + col, now + col, end - col + 1);
+        col = end + 1;
+      }
+    }
+    full = false;
+
+    uint32_t us = micros() - start;
+    stats.updates++;
+    stats.bytes += bytes;
+    stats.lastBytes = bytes;
+    stats.lastUs = us;
+    stats.totalUs += us;
+    if (us > stats.maxUs) {
+      stats.maxUs = us;
+    }
+    return bytes;
+  }
+
+  const OledStats& getStats() const { return stats; }
+
+private:
+  TwoWire* wire = NULL;
+  uint8_t address = 0x3C;
+  bool full = true;
+  uint8_t shadow[OLED_PAGES][OLED_WIDTH];
+  OledStats stats = {};
+
+  uint32_t sendSpan(uint8_t page, uint8_t col, const uint8_t* data, uint8_t len) {
+    uint8_t ramCol = col + OLED_SH1106_COLUMN_OFFSET;
+    wire->beginTransmission(address);
+    wire->write(0x00);                       // Command stream
+    wire->write(0xB0 | page);                // Page address
+    wire->write(0x10 | (ramCol >> 4));       // Column high nibble
+    wire->write(ramCol & 0x0F);              // Column low nibble
+    wire->endTransmission();
+    uint32_t bytes = 5;
+
+    while (len > 0) {
+      uint8_t n = len < OLED_I2C_CHUNK ? len : OLED_I2C_CHUNK;
+      wire->beginTransmission(address);
+      wire->write(0x40);                     // Data stream
+      wire->write(data, n);
+      wire->endTransmission();
+      bytes += n + 2;
+      data += n;
+      len -= n;
+    }
+    return bytes;
+  }
+};
+
+/**
+ * Double-buffered background transfer
+ * submit() copies the finished frame into the pending buffer and wakes the
+ * task; the task moves the newest pending frame into its front buffer and
+ * diffs that against the panel while the UI draws the next one. Frames
+ * submitted during a transfer replace each other: only the latest is
+ * sent, so a slow bus never queues up stale screens.
+ *
+ * The ESP32 I2C driver is interrupt-driven and blocks the calling task on
+ * a semaphore, so the transfer costs the UI core only its ISR time.
+ */
+class OledPresenter {
+public:
+  bool begin(TwoWire* wire, uint8_t address, BaseType_t core, UBaseType_t priority) {
+    diff.begin(wire, address);
+    lock = xSemaphoreCreateMutex();
+    if (lock == NULL) {
+      return false;
+    }
+    return xTaskCreatePinnedToCore(task, "oled", 3072, this, priority, &handle, core) == pdPASS;
+  }
+
+  /**
+   * Hand over a finished frame; never waits for the bus
+   */
+  void submit(const uint8_t* frame) {
+    if (handle == NULL) {
+      return;   // begin() failed or was never called
+    }
+    uint32_t start = micros();
+    xSemaphoreTake(lock, portMAX_DELAY);   // Held only for the copy
+    if (fresh) {
+      dropped++;
+    }
+    memcpy(pending, frame, OLED_FRAME_BYTES);
+    fresh = true;
+    xSemaphoreGive(lock);
+    xTaskNotifyGive(handle);
+
+    lastSubmitUs = micros() - start;
+    if (lastSubmitUs > maxSubmitUs) {
+      maxSubmitUs = lastSubmitUs;
+    }
+  }
+
+  const OledStats& getStats() const { return diff.getStats(); }
+
+  uint32_t dropped = 0;             // Frames replaced before they were sent
+  uint32_t lastSubmitUs = 0;        // UI-side cost of an update
+  uint32_t maxSubmitUs = 0;
+
+private:
+  OledDiff diff;
+  SemaphoreHandle_t lock = NULL;
+  TaskHandle_t handle = NULL;
+  uint8_t pending[OLED_FRAME_BYTES];
+  uint8_t front[OLED_FRAME_BYTES];
+  bool fresh = false;
+
+  static void task(void* param) {
+    OledPresenter* self = (OledPresenter*)param;
+    while (true) {
+      ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+      xSemaphoreTake(self->lock, portMAX_DELAY);
+      bool have = self->fresh;
+      if (have) {
+        memcpy(self->front, self->pending, OLED_FRAME_BYTES);
+        self->fresh = false;
+      }
+      xSemaphoreGive(self->lock);
+      if (!have) {
+        continue;
+      }
+
+      uint32_t bytes = self->diff.push(self->front);
+#if OLED_STATS_LOG
+      if (bytes > 0) {
+        Serial.printf("[OLED] %lu bytes in %lu us\n", (unsigned long)bytes,
+                      (unsigned long)self->diff.getStats().lastUs);
+      }
+#else
+      (void)bytes;
+#endif
+    }
+  }
+};
+
+#endif // PRINTOSK_OLED_DIFF_H
@@ -0,0 +1,138 @@
+/**
+ * Printosk - Print Progress and ETA (ESP32, Arduino)
+ * Tracks the page/band progress reports of the running job and estimates
+ * the time left from the measured print rate
+ *
+ * The Pico reports after each band it hands to the printer:
+ *
+ *   [Pico] PROGRESS job=123456 page=2/5 band=3/7
+ *
+ * page is the page being printed (1-based), band the bands of it done.
+ * Once a page has completed the ETA comes from the measured pages per
+ * minute; within the first page it comes from the band rate.
+ *
+ *   progress.start(millis());
+ *   if (progress.parse(line, millis(), jobId)) { ... redraw ... }
+ *   int eta = progress.etaSeconds(millis());   // -1 until measurable
+ *
+ * Not thread-safe: loop() owns it.
+ */
+
+#ifndef PRINTOSK_PRINT_PROGRESS_H
+#define PRINTOSK_PRINT_PROGRESS_H
+
+#include <Arduino.h>
+
+class PrintProgress {
+public:
+  void start(uint32_t nowMs) {
+    startMs = nowMs;
+    reportMs = nowMs;
+    reports = 0;
+    page = 0;
+    pages = 0;
+    band = 0;
+    bands = 0;
+    pagesDone = 0;
+    pagesDoneMs = 0;
+    remainingMs = -1;
+  }
+
+  /**
+   * Take a PROGRESS line; false if line is not a progress report (of job,
+   * when given)
+   */
+  bool parse(const char* line, uint32_t nowMs, const char* job = NULL) {
+    const char* p = strstr(line, "PROGRESS ");
+    char reported[32];
+    int pg, pgs, bd, bds;
+    if (p == NULL ||
+        sscanf(p, "PROGRESS job=%31s page=%d/%d band=%d/%d", reported, &pg, &pgs, &bd, &bds) != 5 ||
+        pgs < 1 || pg < 1 || pg > pgs || bds < 1 || bd < 0 || bd > bds) {
+      return false;
+    }
+    if (job != NULL && strcmp(job, reported) != 0) {
+      return false;
+    }
+    update(pg, pgs, bd, bds, nowMs);
+    return true;
+  }
+
+  void update(int page, int pages, int band, int bands, uint32_t nowMs) {
+    this->page = page;
+    this->pages = pages;
+    this->band = band;
+    this->bands = bands;
+    reportMs = nowMs;
+    reports++;
+
+    int done = page - 1 + (band == bands ? 1 : 0);
+    if (done > pagesDone) {
+      pagesDone = done;
+      pagesDoneMs = nowMs - startMs;
+    }
+    // Remaining work in bands, assuming every page has as many as this one
+    uint32_t bandsLeft = (uint32_t)(pages - page) * bands + (bands - band);
+    if (bandsLeft == 0) {
+      remainingMs = 0;
+    } else if (pagesDone > 0) {
+      // Measured pages per minute
+      remainingMs = (int32_t)((uint64_t)pagesDoneMs * bandsLeft / ((uint32_t)pagesDone * bands));
+    } else if (band > 0) {
+      // First page: band rate
+      remainingMs = (int32_t)((uint64_t)(nowMs - startMs) * bandsLeft / band);
+    } else {
+      remainingMs = -1;
+    }
+  }
+
+  bool active() const { return reports > 0; }
+
+  /**
+   * Job done, 0-100
+   */
+  uint8_t percent() const {
+    if (pages == 0) {
+      return 0;
+    }
+    return (uint8_t)(((page - 1) * bands + band) * 100L / ((long)pages * bands));
+  }
+
+  /**
+   * Seconds left, counting down between reports; -1 while unknown
+   */
+  int32_t etaSeconds(uint32_t nowMs) const {
+    if (remainingMs < 0) {
+      return -1;
+    }
+    int32_t left = remainingMs - (int32_t)(nowMs - reportMs);
+    return left > 0 ? (left + 999) / 1000 : 0;
+  }
+
+  /**
+   * Measured pages per minute (x10 for one decimal), 0 before a page completes
+   */
+  uint16_t pagesPerMinuteX10() const {
+    if (pagesDone <= 0 || pagesDoneMs == 0) {
+      return 0;
+    }
+    return (uint16_t)((uint64_t)pagesDone * 600000UL / pagesDoneMs);
+  }
+
+  uint32_t lastReportMs() const { return reportMs; }
+
+  int page = 0;                     // Page being printed, 1-based
+  int pages = 0;
+  int band = 0;                     // Bands of page done
+  int bands = 0;
+
+private:
+  uint32_t startMs = 0;
+  uint32_t reportMs = 0;
+  uint32_t reports = 0;
+  int pagesDone = 0;
+  uint32_t pagesDoneMs = 0;         // Since start, when the last of pagesDone completed
+  int32_t remainingMs = -1;         // At reportMs; -1 unknown
+};
+
+#endif // PRINTOSK_PRINT_PROGRESS_H
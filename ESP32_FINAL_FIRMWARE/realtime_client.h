@@ -0,0 +1,549 @@
+/**
+ * Printosk - Realtime Push Client (ESP32, Arduino)
+ * Minimal websocket client for one Supabase Realtime broadcast channel, so
+ * job changes reach the kiosk as they happen instead of at the next poll
+ *
+ * Speaks just enough RFC 6455 (masked client frames, ping/pong, close) and
+ * of the Phoenix channel protocol Realtime uses (phx_join, heartbeat,
+ * phx_reply, broadcast) to receive events. Every (re)connect joins the
+ * topic again; onSubscribed tells the caller, which catches up on events
+ * missed while disconnected. Failed connects back off exponentially from
+ * REALTIME_BACKOFF_MIN_MS to _MAX_MS.
+ *
+ * With fetchToken the channel is private: the join carries an access token
+ * (config.private), and a fresh one is pushed ("access_token" event) when
+ * three quarters of its lifetime have passed.
+ * Without, the join is public (realtime_standin.py).
+ *
+ *   realtime.begin(REALTIME_URL, "realtime:kiosk-jobs", onEvent, onSubscribed, fetchToken);
+ *   while (true) {
+ *     realtime.poll();   // Connects, joins, heartbeats, dispatches one frame
+ *   }
+ *
+ * ws:// URLs use a plain socket (firmware/tools/realtime_standin.py for
+ * offline testing), wss:// a TLS one.
+ *
+ * Not thread-safe: one task owns it. subscribed() may be read anywhere.
+ */
+
+#ifndef PRINTOSK_REALTIME_CLIENT_H
+#define PRINTOSK_REALTIME_CLIENT_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WiFiClient.h>
+#include <WiFiClientSecure.h>
+
+#ifndef REALTIME_HEARTBEAT_MS
+#define REALTIME_HEARTBEAT_MS 25000     // Realtime drops sockets silent for 60 s
+#endif
+
+#ifndef REALTIME_BACKOFF_MIN_MS
+#define REALTIME_BACKOFF_MIN_MS 1000
+#endif
+
+#ifndef REALTIME_BACKOFF_MAX_MS
+#define REALTIME_BACKOFF_MAX_MS 60000
+#endif
+
+#ifndef REALTIME_CONNECT_TIMEOUT_MS
+#define REALTIME_CONNECT_TIMEOUT_MS 10000
+#endif
+
+#ifndef REALTIME_POLL_MS
+#define REALTIME_POLL_MS 50             // Sleep when there is nothing to read
+#endif
+
+#ifndef REALTIME_FRAME_MAX
+#define REALTIME_FRAME_MAX 1024         // Larger messages are skipped
+#endif
+
+#ifndef REALTIME_TOKEN_MAX
+#define REALTIME_TOKEN_MAX 512          // Access token (JWT) with terminator
+#endif
+
+#ifndef REALTIME_TOKEN_RETRY_MS
+#define REALTIME_TOKEN_RETRY_MS 60000   // After a failed refresh while joined
+#endif
+
+#define REALTIME_SEND_MAX (384 + REALTIME_TOKEN_MAX)  // Join is the largest message sent
+
+typedef void (*RealtimeEventHandler)(const char* event, JsonObjectConst payload);
+typedef void (*RealtimeSubscribedHandler)();
+// Fills token (size bytes) and its lifetime; false if none could be had
+typedef bool (*RealtimeTokenHandler)(char* token, size_t size, uint32_t* ttlSeconds);
+
+class RealtimeClient {
+public:
+  /**
+   * Set the endpoint and channel; nothing connects until poll()
+   */
+  bool begin(const char* url, const char* topic, RealtimeEventHandler onEvent,
+             RealtimeSubscribedHandler onSubscribed, RealtimeTokenHandler fetchToken = NULL) {
+    this->topic = topic;
+    this->onEvent = onEvent;
+    this->onSubscribed = onSubscribed;
+    this->fetchToken = fetchToken;
+    if (!parseUrl(url)) {
+      Serial.println("[RT] Invalid URL - push disabled");
+      return false;
+    }
+    if (secure) {
+      // As with the API connection pool: no CA bundle configured yet
+      tlsClient.setInsecure();
+      client = &tlsClient;
+    } else {
+      client = &plainClient;
+    }
+    return true;
+  }
+
+  /**
+   * One step: (re)connect when due, heartbeat, handle at most one frame
+   * Sleeps REALTIME_POLL_MS when there is nothing to do.
+   */
+  void poll() {
+    if (client == NULL) {
+      delay(REALTIME_BACKOFF_MAX_MS);
+      return;
+    }
+    uint32_t now = millis();
+
+    if (state == RT_IDLE || !client->connected()) {
+      if (state != RT_IDLE) {
+        disconnect("connection lost", true);
+      } else if ((int32_t)(now - nextConnect) >= 0) {
+        connect();
+      } else {
+        delay(REALTIME_POLL_MS);
+      }
+      return;
+    }
+
+    if (now - lastHeartbeat >= REALTIME_HEARTBEAT_MS) {
+      if (heartbeatRef != 0) {
+        disconnect("heartbeat unanswered", true);
+        return;
+      }
+      heartbeatRef = nextRef++;
+      snprintf(message, sizeof(message),
+               "{\"topic\":\"phoenix\",\"event\":\"heartbeat\",\"payload\":{},\"ref\":\"%lu\"}",
+               (unsigned long)heartbeatRef);
+      sendFrame(WS_TEXT, (const uint8_t*)message, strlen(message));
+      lastHeartbeat = now;
+    }
+
+    if (state == RT_JOINED && fetchToken != NULL && (int32_t)(now - tokenRefresh) >= 0) {
+      refreshToken();
+      return;
+    }
+
+    if (client->available() < 2) {
+      delay(REALTIME_POLL_MS);
+      return;
+    }
+    readFrame();
+  }
+
+  /**
+   * Drop the connection (WiFi went down); poll() reconnects right away
+   */
+  void stop() {
+    if (state != RT_IDLE) {
+      disconnect("stopped", false);
+    }
+    nextConnect = millis();
+  }
+
+  bool subscribed() const { return state == RT_JOINED; }
+
+  uint32_t connects = 0;
+  uint32_t events = 0;
+
+private:
+  enum State : uint8_t { RT_IDLE, RT_JOINING, RT_JOINED };
+
+  enum Opcode : uint8_t {
+    WS_CONTINUATION = 0x0,
+    WS_TEXT = 0x1,
+    WS_CLOSE = 0x8,
+    WS_PING = 0x9,
+    WS_PONG = 0xA
+  };
+
+  WiFiClient plainClient;
+  WiFiClientSecure tlsClient;
+  Client* client = NULL;
+  bool secure = false;
+  char host[64] = "";
+  uint16_t port = 0;
+  char path[256] = "";
+  const char* topic = "";
+  RealtimeEventHandler onEvent = NULL;
+  RealtimeSubscribedHandler onSubscribed = NULL;
+  RealtimeTokenHandler fetchToken = NULL;
+  char accessToken[REALTIME_TOKEN_MAX] = "";
+  uint32_t tokenRefresh = 0;         // millis() at which to push a fresh token
+
+  volatile State state = RT_IDLE;
+  uint32_t nextConnect = 0;
+  uint32_t backoffMs = REALTIME_BACKOFF_MIN_MS;
+  uint32_t lastHeartbeat = 0;
+  uint32_t nextRef = 1;
+  uint32_t joinRef = 0;
+  uint32_t heartbeatRef = 0;        // Unanswered heartbeat, 0 = none
+  bool skippingFragments = false;
+
+  char frame[REALTIME_FRAME_MAX + 1];
+  char message[REALTIME_SEND_MAX];
+  uint8_t out[REALTIME_SEND_MAX + 8];
+
+  // ws[s]://host[:port]/path?query
+  bool parseUrl(const char* url) {
+    const char* rest;
+    if (strncmp(url, "wss://", 6) == 0) {
+      secure = true;
+      port = 443;
+      rest = url + 6;
+    } else if (strncmp(url, "ws://", 5) == 0) {
+      secure = false;
+      port = 80;
+      rest = url + 5;
+    } else {
+      return false;
+    }
+    const char* slash = strchr(rest, '/');
+    size_t hostLen = slash ? (size_t)(slash - rest) : strlen(rest);
+    const char* colon = (const char*)memchr(rest, ':', hostLen);
+    if (colon != NULL) {
+      port = atoi(colon + 1);
+      hostLen = colon - rest;
+    }
+    if (hostLen == 0 || hostLen >= sizeof(host)) {
+      return false;
+    }
+    memcpy(host, rest, hostLen);
+    host[hostLen] = '\0';
+    strlcpy(path, slash ? slash : "/", sizeof(path));
+    return true;
+  }
+
+  void connect() {
+    connects++;
+    // A token still inside its refresh time is reused across reconnects
+    bool tokenDue = accessToken[0] == '\0' || (int32_t)(millis() - tokenRefresh) >= 0;
+    if (fetchToken != NULL && tokenDue && !takeToken()) {
+      disconnect("no access token", true);
+      return;
+    }
+    Serial.printf("[RT] Connecting to %s:%u\n", host, port);
+    if (!client->connect(host, port) || !handshake()) {
+      disconnect("connect failed", true);
+      return;
+    }
+
+    state = RT_JOINING;
+    lastHeartbeat = millis();
+    heartbeatRef = 0;
+    skippingFragments = false;
+    join();
+  }
+
+  bool handshake() {
+    uint8_t nonce[16];
+    for (int i = 0; i < 16; i += 4) {
+      uint32_t r = esp_random();
+      memcpy(nonce + i, &r, 4);
+    }
+    char key[25];
+    base64(nonce, sizeof(nonce), key);
+
+    char line[160];
+    client->print("GET ");
+    client->print(path);
+    snprintf(message, sizeof(message),
+             " HTTP/1.1\r\nHost: %s\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+             "Sec-WebSocket-Key: %s\r\nSec-WebSocket-Version: 13\r\n\r\n",
+             host, key);
+    client->print(message);
+
+    uint32_t deadline = millis() + REALTIME_CONNECT_TIMEOUT_MS;
+    if (readLine(line, sizeof(line), deadline) < 0 || strstr(line, " 101") == NULL) {
+      Serial.printf("[RT] Upgrade refused: %s\n", line);
+      return false;
+    }
+    // Skip the remaining headers
+    int n;
+    while ((n = readLine(line, sizeof(line), deadline)) > 0) {
+    }
+    return n == 0;
+  }
+
+  /**
+   * Fetch a token into accessToken and schedule its refresh
+   */
+  bool takeToken() {
+    uint32_t ttlSeconds = 0;
+    if (!fetchToken(accessToken, sizeof(accessToken), &ttlSeconds) || ttlSeconds == 0) {
+      accessToken[0] = '\0';
+      return false;
+    }
+    tokenRefresh = millis() + ttlSeconds * 750;
+    return true;
+  }
+
+  /**
+   * Push a fresh token to the joined channel before the current one expires
+   * If that fails, retry later; once it has expired Realtime closes the
+   * channel, the rejoin is refused and the reconnect fetches a new one.
+   */
+  void refreshToken() {
+    if (!takeToken()) {
+      Serial.println("[RT] Token refresh failed");
+      tokenRefresh = millis() + REALTIME_TOKEN_RETRY_MS;
+      return;
+    }
+    snprintf(message, sizeof(message),
+             "{\"topic\":\"%s\",\"event\":\"access_token\",\"payload\":{\"access_token\":\"%s\"},"
+             "\"ref\":\"%lu\",\"join_ref\":\"%lu\"}",
+             topic, accessToken, (unsigned long)nextRef++, (unsigned long)joinRef);
+    sendFrame(WS_TEXT, (const uint8_t*)message, strlen(message));
+  }
+
+  void join() {
+    joinRef = nextRef++;
+    bool isPrivate = accessToken[0] != '\0';
+    int n = snprintf(message, sizeof(message),
+             "{\"topic\":\"%s\",\"event\":\"phx_join\",\"payload\":{\"config\":{"
+             "\"broadcast\":{\"self\":false,\"ack\":false},\"presence\":{\"key\":\"\"},"
+             "\"postgres_changes\":[],\"private\":%s}",
+             topic, isPrivate ? "true" : "false");
+    if (isPrivate) {
+      n += snprintf(message + n, sizeof(message) - n, ",\"access_token\":\"%s\"", accessToken);
+    }
+    snprintf(message + n, sizeof(message) - n, "},\"ref\":\"%lu\",\"join_ref\":\"%lu\"}",
+             (unsigned long)joinRef, (unsigned long)joinRef);
+    sendFrame(WS_TEXT, (const uint8_t*)message, strlen(message));
+  }
+
+  void disconnect(const char* reason, bool backoff) {
+    client->stop();
+    if (state == RT_JOINED) {
+      backoffMs = REALTIME_BACKOFF_MIN_MS;   // Was healthy: retry soon
+    }
+    state = RT_IDLE;
+    if (backoff) {
+      nextConnect = millis() + backoffMs + random(backoffMs / 2);
+      Serial.printf("[RT] %s, retry in %lu ms\n", reason, (unsigned long)backoffMs);
+      backoffMs = backoffMs * 2 > REALTIME_BACKOFF_MAX_MS ? REALTIME_BACKOFF_MAX_MS : backoffMs * 2;
+    } else {
+      Serial.printf("[RT] %s\n", reason);
+    }
+  }
+
+  void readFrame() {
+    uint32_t deadline = millis() + REALTIME_CONNECT_TIMEOUT_MS;
+    uint8_t header[8];
+    if (!readExact(header, 2, deadline)) {
+      disconnect("short frame", true);
+      return;
+    }
+    bool fin = header[0] & 0x80;
+    uint8_t opcode = header[0] & 0x0F;
+    uint32_t len = header[1] & 0x7F;
+    if (header[1] & 0x80) {
+      disconnect("masked server frame", true);
+      return;
+    }
+    if (len == 126) {
+      if (!readExact(header, 2, deadline)) {
+        disconnect("short frame", true);
+        return;
+      }
+      len = (header[0] << 8) | header[1];
+    } else if (len == 127) {
+      if (!readExact(header, 8, deadline) || header[0] | header[1] | header[2] | header[3]) {
+        disconnect("oversized frame", true);
+        return;
+      }
+      len = ((uint32_t)header[4] << 24) | ((uint32_t)header[5] << 16) | (header[6] << 8) | header[7];
+    }
+
+    if (len > REALTIME_FRAME_MAX) {
+      Serial.printf("[RT] Skipping %lu byte message\n", (unsigned long)len);
+      skippingFragments = !fin;
+      if (!skip(len, deadline)) {
+        disconnect("short frame", true);
+      }
+      return;
+    }
+    if (!readExact((uint8_t*)frame, len, deadline)) {
+      disconnect("short frame", true);
+      return;
+    }
+    frame[len] = '\0';
+
+    switch (opcode) {
+      case WS_TEXT:
+        // Realtime does not fragment messages this small; drop any that are
+        skippingFragments = !fin;
+        if (fin) {
+          handleMessage(len);
+        }
+        break;
+      case WS_CONTINUATION:
+        skippingFragments = skippingFragments && !fin;
+        break;
+      case WS_PING:
+        sendFrame(WS_PONG, (const uint8_t*)frame, len);
+        break;
+      case WS_CLOSE:
+        disconnect("closed by server", true);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void handleMessage(size_t len) {
+    StaticJsonDocument<REALTIME_FRAME_MAX> doc;
+    if (deserializeJson(doc, frame, len)) {
+      return;
+    }
+    const char* event = doc["event"] | "";
+    uint32_t ref = strtoul(doc["ref"] | "0", NULL, 10);
+
+    if (strcmp(event, "phx_reply") == 0) {
+      if (ref != 0 && ref == heartbeatRef) {
+        heartbeatRef = 0;
+      } else if (ref != 0 && ref == joinRef) {
+        if (strcmp(doc["payload"]["status"] | "", "ok") != 0) {
+          accessToken[0] = '\0';   // Expired or revoked: fetch another
+          disconnect("join refused", true);
+          return;
+        }
+        state = RT_JOINED;
+        backoffMs = REALTIME_BACKOFF_MIN_MS;
+        Serial.printf("[RT] Subscribed to %s\n", topic);
+        if (onSubscribed != NULL) {
+          onSubscribed();
+        }
+      }
+      return;
+    }
+
+    if (strcmp(doc["topic"] | "", topic) != 0) {
+      return;
+    }
+    if (strcmp(event, "broadcast") == 0) {
+      events++;
+      if (onEvent != NULL) {
+        onEvent(doc["payload"]["event"] | "", doc["payload"]["payload"]);
+      }
+    } else if (strcmp(event, "phx_close") == 0 || strcmp(event, "phx_error") == 0) {
+      // Channel dropped but the socket is fine: join again
+      Serial.printf("[RT] Channel %s, rejoining\n", event);
+      state = RT_JOINING;
+      join();
+    }
+  }
+
+  bool sendFrame(uint8_t opcode, const uint8_t* data, size_t len) {
+    if (len > REALTIME_SEND_MAX) {
+      return false;
+    }
+    size_t h = 0;
+    out[h++] = 0x80 | opcode;
+    if (len < 126) {
+      out[h++] = 0x80 | len;
+    } else {
+      out[h++] = 0x80 | 126;
+      out[h++] = len >> 8;
+      out[h++] = len & 0xFF;
+    }
+    uint32_t maskWord = esp_random();
+    uint8_t* mask = out + h;
+    memcpy(mask, &maskWord, 4);
+    h += 4;
+    for (size_t i = 0; i < len; i++) {
+      out[h + i] = data[i] ^ mask[i & 3];
+    }
+    // One write: one TLS record
+    return client->write(out, h + len) == h + len;
+  }
+
+  bool readExact(uint8_t* buf, size_t len, uint32_t deadline) {
+    size_t got = 0;
+    while (got < len) {
+      int n = client->read(buf + got, len - got);
+      if (n > 0) {
+        got += n;
+      } else if (!client->connected() || (int32_t)(millis() - deadline) >= 0) {
+        return false;
+      } else {
+        delay(1);
+      }
+    }
+    return true;
+  }
+
+  bool skip(uint32_t len, uint32_t deadline) {
+    while (len > 0) {
+      uint32_t chunk = len < REALTIME_FRAME_MAX ? len : REALTIME_FRAME_MAX;
+      if (!readExact((uint8_t*)frame, chunk, deadline)) {
+        return false;
+      }
+      len -= chunk;
+    }
+    return true;
+  }
+
+  // Line without CRLF; its length, or -1 on timeout
+  int readLine(char* buf, size_t size, uint32_t deadline) {
+    size_t n = 0;
+    buf[0] = '\0';
+    while ((int32_t)(millis() - deadline) < 0) {
+      int c = client->read();
+      if (c < 0) {
+        if (!client->connected()) {
+          return -1;
+        }
+        delay(1);
+        continue;
+      }
+      if (c == '\n') {
+        if (n > 0 && buf[n - 1] == '\r') {
+          n--;
+        }
+        buf[n] = '\0';
+        return n;
+      }
+      if (n < size - 1) {
+        buf[n++] = c;
+        buf[n] = '\0';
+      }
+    }
+    return -1;
+  }
+
+  static void base64(const uint8_t* in, size_t len, char* out) {
+    static const char table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t o = 0;
+    for (size_t i = 0; i < len; i += 3) {
+      uint32_t v = in[i] << 16;
+      if (i + 1 < len) {
+        v |= in[i + 1] << 8;
+      }
+      if (i + 2 < len) {
+        v |= in[i + 2];
+      }
+      out[o++] = table[(v >> 18) & 0x3F];
+      out[o++] = table[(v >> 12) & 0x3F];
+      out[o++] = i + 1 < len ? table[(v >> 6) & 0x3F] : '=';
+      out[o++] = i + 2 < len ? table[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+  }
+};
+
+#endif // PRINTOSK_REALTIME_CLIENT_H
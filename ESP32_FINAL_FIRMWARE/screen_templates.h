@@ -0,0 +1,185 @@
+/**
+ * Printosk - Precomposed Screen Templates (ESP32, Arduino, SH1106)
+ * The static text of every screen, rasterized once so a screen change is a
+ * 1 KB memcpy plus the few dynamic fields, instead of drawing every glyph
+ * through Adafruit_GFX again
+ *
+ * Layout is fixed at compile time: each line is a constexpr (text, x, y,
+ * size) entry, centred lines get their x from text_layout.h, and a
+ * static_assert rejects any line that would run off the 128x64 panel (and
+ * wrap). The pixels are drawn by the installed Adafruit_GFX font at boot
+ * (~8 KB of RAM for all screens), so the templates always match the glyphs
+ * the dynamic fields are drawn with.
+ *
+ *   screens.begin(&display, display.getBuffer());   // Once, after display.begin()
+ *   ...
+ *   screens.show(SCREEN_FETCHING, display.getBuffer());
+ *   display.setCursor(FETCHING_ID_X, FETCHING_ID_Y);
+ *   display.print(currentPrintId.c_str());
+ *   oledPush();
+ */
+
+#ifndef PRINTOSK_SCREEN_TEMPLATES_H
+#define PRINTOSK_SCREEN_TEMPLATES_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include "oled_diff.h"
+#include "text_layout.h"
+
+#define OLED_HEIGHT (OLED_PAGES * 8)
+
+enum ScreenId {
+  SCREEN_WELCOME,
+  SCREEN_INPUT,
+  SCREEN_FETCHING,
+  SCREEN_JOB_FOUND,
+  SCREEN_PRINTING,
+  SCREEN_SUCCESS,
+  SCREEN_ERROR,
+  SCREEN_IDLE,
+  SCREEN_COUNT
+};
+
+struct TemplateText {
+  const char* text;
+  int16_t x;
+  int16_t y;
+  uint8_t size;
+};
+
+#define CENTERED_TEXT(text, y, size) { text, centeredTextX(text, size, OLED_WIDTH), y, size }
+
+// ============= STATIC TEXT =============
+constexpr TemplateText WELCOME_TEXT[] = {
+  CENTERED_TEXT("PRINTOSK", 10, 2),
+  CENTERED_TEXT("Enter Print ID", 35, 1),
+  CENTERED_TEXT("Press 0-9 then ENTER", 50, 1),
+};
+
+constexpr TemplateText INPUT_TEXT[] = {
+  CENTERED_TEXT("PRINT ID", 10, 2),
+};
+
+constexpr TemplateText FETCHING_TEXT[] = {
+  CENTERED_TEXT("Fetching Job...", 10, 1),
+  { "ID:", 15, 35, 1 },
+};
+
+constexpr TemplateText JOB_FOUND_TEXT[] = {
+  CENTERED_TEXT("Job Found!", 10, 1),
+  { "ID:", 15, 25, 1 },
+  { "Files:", 15, 35, 1 },
+};
+
+constexpr TemplateText PRINTING_TEXT[] = {
+  CENTERED_TEXT("Printing...", 10, 1),
+};
+
+constexpr TemplateText SUCCESS_TEXT[] = {
+  CENTERED_TEXT("SUCCESS!", 20, 2),
+  CENTERED_TEXT("Job Completed", 50, 1),
+};
+
+constexpr TemplateText ERROR_TEXT[] = {
+  CENTERED_TEXT("ERROR!", 10, 1),
+  CENTERED_TEXT("ENTER to continue", 50, 1),
+};
+
+constexpr TemplateText IDLE_TEXT[] = {
+  CENTERED_TEXT("Idle - No Input", 30, 1),
+};
+
+// ============= DYNAMIC FIELDS =============
+// Drawn over the template by the display functions
+#define INPUT_ID_X 30
+#define INPUT_ID_Y 35
+#define INPUT_COUNTER_X 0
+#define INPUT_COUNTER_Y 55
+#define FETCHING_ID_X (15 + textWidth("ID: ", 1))
+#define FETCHING_ID_Y 35
+#define JOB_FOUND_ID_X (15 + textWidth("ID: ", 1))
+#define JOB_FOUND_ID_Y 25
+#define JOB_FOUND_FILES_X (15 + textWidth("Files: ", 1))
+#define JOB_FOUND_FILES_Y 35
+#define PROGRESS_BAR_X 4
+#define PROGRESS_BAR_Y 24
+#define PROGRESS_BAR_W 120
+#define PROGRESS_BAR_H 10
+#define PROGRESS_TEXT_Y 40
+#define PROGRESS_LINE_GAP 2
+#define ERROR_MESSAGE_Y 25
+
+template <size_t N>
+constexpr bool templateFits(const TemplateText (&texts)[N], size_t i = 0) {
+  return i == N || (texts[i].x >= 0 && texts[i].y >= 0 &&
+                    texts[i].x + textWidth(texts[i].text, texts[i].size) <= OLED_WIDTH &&
+                    texts[i].y + TEXT_GLYPH_HEIGHT * texts[i].size <= OLED_HEIGHT &&
+                    templateFits(texts, i + 1));
+}
+
+static_assert(templateFits(WELCOME_TEXT), "Welcome screen text does not fit");
+static_assert(templateFits(INPUT_TEXT), "Input screen text does not fit");
+static_assert(templateFits(FETCHING_TEXT), "Fetching screen text does not fit");
+static_assert(templateFits(JOB_FOUND_TEXT), "Job found screen text does not fit");
+static_assert(templateFits(PRINTING_TEXT), "Printing screen text does not fit");
+static_assert(templateFits(SUCCESS_TEXT), "Success screen text does not fit");
+static_assert(templateFits(ERROR_TEXT), "Error screen text does not fit");
+static_assert(templateFits(IDLE_TEXT), "Idle screen text does not fit");
+
+struct ScreenTemplate {
+  const TemplateText* texts;
+  uint8_t count;
+};
+
+#define SCREEN_TEMPLATE(texts) { texts, sizeof(texts) / sizeof(texts[0]) }
+
+// In ScreenId order
+constexpr ScreenTemplate SCREEN_TEMPLATES[SCREEN_COUNT] = {
+  SCREEN_TEMPLATE(WELCOME_TEXT),
+  SCREEN_TEMPLATE(INPUT_TEXT),
+  SCREEN_TEMPLATE(FETCHING_TEXT),
+  SCREEN_TEMPLATE(JOB_FOUND_TEXT),
+  SCREEN_TEMPLATE(PRINTING_TEXT),
+  SCREEN_TEMPLATE(SUCCESS_TEXT),
+  SCREEN_TEMPLATE(ERROR_TEXT),
+  SCREEN_TEMPLATE(IDLE_TEXT),
+};
+
+class ScreenTemplates {
+public:
+  /**
+   * Rasterize every template through gfx, whose framebuffer is buffer
+   * Leaves buffer cleared. Returns the time taken in microseconds.
+   */
+  uint32_t begin(Adafruit_GFX* gfx, uint8_t* buffer) {
+    uint32_t start = micros();
+    gfx->setTextWrap(false);
+    gfx->setTextColor(1);
+    for (uint8_t id = 0; id < SCREEN_COUNT; id++) {
+      memset(buffer, 0, OLED_FRAME_BYTES);
+      const ScreenTemplate& screen = SCREEN_TEMPLATES[id];
+      for (uint8_t i = 0; i < screen.count; i++) {
+        gfx->setTextSize(screen.texts[i].size);
+        gfx->setCursor(screen.texts[i].x, screen.texts[i].y);
+        gfx->print(screen.texts[i].text);
+      }
+      memcpy(frames[id], buffer, OLED_FRAME_BYTES);
+    }
+    gfx->setTextWrap(true);
+    memset(buffer, 0, OLED_FRAME_BYTES);
+    return micros() - start;
+  }
+
+  /**
+   * Replace the whole of buffer with the template of id
+   */
+  void show(ScreenId id, uint8_t* buffer) const {
+    memcpy(buffer, frames[id], OLED_FRAME_BYTES);
+  }
+
+private:
+  uint8_t frames[SCREEN_COUNT][OLED_FRAME_BYTES] = {};
+};
+
+#endif // PRINTOSK_SCREEN_TEMPLATES_H
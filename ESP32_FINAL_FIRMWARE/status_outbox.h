@@ -0,0 +1,220 @@
+/**
+ * Printosk - Durable Status Outbox (ESP32, Arduino)
+ * Job status transitions waiting to reach the backend, kept in NVS so a
+ * reboot or a WiFi outage does not lose them
+ *
+ * - Coalescing: one entry per Print ID; a newer state replaces an
+ *   undelivered older one (PRINTING -> COMPLETED sends only COMPLETED)
+ * - Batching: everything due goes out in one request (up to OUTBOX_MAX_BATCH)
+ * - Rate limit: token bucket, OUTBOX_RATE_PER_MIN with OUTBOX_BURST burst
+ * - Retry: exponential backoff from OUTBOX_BACKOFF_MIN_MS to _MAX_MS
+ *
+ *   outbox.begin();                            // Reload what survived a reboot
+ *   outbox.add("123456", "COMPLETED", "");
+ *   int n = outbox.takeBatch(batch, OUTBOX_MAX_BATCH, millis());
+ *   if (n > 0) { ok ? outbox.delivered(batch, n) : outbox.failed(millis()); }
+ *
+ * Not thread-safe: callers on different tasks hold a mutex around each
+ * call (not across the HTTP request; delivered() copes with adds made
+ * meanwhile).
+ */
+
+#ifndef PRINTOSK_STATUS_OUTBOX_H
+#define PRINTOSK_STATUS_OUTBOX_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#ifndef OUTBOX_CAPACITY
+#define OUTBOX_CAPACITY 16          // Distinct jobs with undelivered states
+#endif
+
+#ifndef OUTBOX_MAX_BATCH
+#define OUTBOX_MAX_BATCH 8          // Entries per request
+#endif
+
+#ifndef OUTBOX_RATE_PER_MIN
+#define OUTBOX_RATE_PER_MIN 6       // Requests per minute
+#endif
+
+#ifndef OUTBOX_BURST
+#define OUTBOX_BURST 3              // Requests allowed back to back
+#endif
+
+#ifndef OUTBOX_BACKOFF_MIN_MS
+#define OUTBOX_BACKOFF_MIN_MS 2000
+#endif
+
+#ifndef OUTBOX_BACKOFF_MAX_MS
+#define OUTBOX_BACKOFF_MAX_MS 300000
+#endif
+
+struct OutboxEntry {
+  char printId[8];
+  char status[12];
+  char errorMsg[96];
+};
+
+class StatusOutbox {
+public:
+  /**
+   * Load persisted entries; the bucket starts full
+   */
+  void begin() {
+    prefs.begin("outbox", false);
+    count = 0;
+    size_t bytes = prefs.getBytesLength("entries");
+    if (bytes > 0 && bytes <= sizeof(entries) && bytes % sizeof(OutboxEntry) == 0) {
+      prefs.getBytes("entries", entries, bytes);
+      count = bytes / sizeof(OutboxEntry);
+    }
+    tokensMilli = OUTBOX_BURST * 1000;
+    lastRefill = millis();
+    nextAttempt = 0;
+    failures = 0;
+    if (count > 0) {
+      Serial.printf("[OUTBOX] %d status update(s) restored from flash\n", count);
+    }
+  }
+
+  /**
+   * Queue a transition, replacing any undelivered state of the same job
+   */
+  void add(const char* printId, const char* status, const char* errorMsg) {
+    int slot = -1;
+    for (int i = 0; i < count; i++) {
+      if (strcmp(entries[i].printId, printId) == 0) {
+        Serial.printf("[OUTBOX] %s: %s superseded by %s\n", printId, entries[i].status, status);
+        slot = i;
+        break;
+      }
+    }
+    if (slot < 0) {
+      if (count == OUTBOX_CAPACITY) {
+        // Oldest first: it has had the longest chance to be delivered
+        Serial.printf("[OUTBOX] Full, dropping %s %s\n", entries[0].printId, entries[0].status);
+        memmove(&entries[0], &entries[1], (count - 1) * sizeof(OutboxEntry));
+        count--;
+      }
+      slot = count++;
+    }
+
+    OutboxEntry& e = entries[slot];
+    memset(&e, 0, sizeof(e));
+    strlcpy(e.printId, printId, sizeof(e.printId));
+    strlcpy(e.status, status, sizeof(e.status));
+    strlcpy(e.errorMsg, errorMsg, sizeof(e.errorMsg));
+    save();
+  }
+
+  int pending() const { return count; }
+
+  /**
+   * Copy the entries to send now into out and spend a token
+   * Returns 0 while empty, backing off or out of tokens.
+   */
+  int takeBatch(OutboxEntry* out, int max, uint32_t now) {
+    refill(now);
+    if (count == 0 || (int32_t)(now - nextAttempt) < 0 || tokensMilli < 1000) {
+      return 0;
+    }
+    tokensMilli -= 1000;
+    int n = count < max ? count : max;
+    memcpy(out, entries, n * sizeof(OutboxEntry));
+    return n;
+  }
+
+  /**
+   * The n entries returned by takeBatch reached the backend
+   * An entry superseded while the request was in flight stays queued.
+   */
+  void delivered(const OutboxEntry* sent, int n) {
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < count; j++) {
+        if (memcmp(&entries[j], &sent[i], sizeof(OutboxEntry)) == 0) {
+          memmove(&entries[j], &entries[j + 1], (count - j - 1) * sizeof(OutboxEntry));
+          count--;
+          break;
+        }
+      }
+    }
+    failures = 0;
+    nextAttempt = 0;
+    save();
+  }
+
+  /**
+   * The last batch failed; retry after the next backoff step
+   */
+  void failed(uint32_t now) {
+    uint32_t backoff = OUTBOX_BACKOFF_MIN_MS;
+    for (uint8_t i = 0; i < failures && backoff < OUTBOX_BACKOFF_MAX_MS; i++) {
+      backoff *= 2;
+    }
+    if (backoff > OUTBOX_BACKOFF_MAX_MS) {
+      backoff = OUTBOX_BACKOFF_MAX_MS;
+    }
+    if (failures < 255) {
+      failures++;
+    }
+    nextAttempt = now + backoff;
+    Serial.printf("[OUTBOX] Delivery failed (%u in a row), retry in %lu ms\n",
+                  failures, (unsigned long)backoff);
+  }
+
+  /**
+   * Time until takeBatch can return entries; UINT32_MAX while empty
+   */
+  uint32_t msUntilDue(uint32_t now) {
+    if (count == 0) {
+      return UINT32_MAX;
+    }
+    refill(now);
+    uint32_t wait = (int32_t)(nextAttempt - now) > 0 ? nextAttempt - now : 0;
+    if (tokensMilli < 1000) {
+      uint32_t tokenWait = (1000 - tokensMilli) * 60 / OUTBOX_RATE_PER_MIN + 1;
+      wait = tokenWait > wait ? tokenWait : wait;
+    }
+    return wait;
+  }
+
+private:
+  Preferences prefs;
+  OutboxEntry entries[OUTBOX_CAPACITY];
+  int count = 0;
+  uint32_t tokensMilli = 0;   // Thousandths of a request
+  uint32_t lastRefill = 0;
+  uint32_t nextAttempt = 0;
+  uint8_t failures = 0;
+
+  void refill(uint32_t now) {
+    if ((int32_t)(now - lastRefill) <= 0) {
+      return;
+    }
+    if (now - lastRefill >= 60000u * OUTBOX_BURST / OUTBOX_RATE_PER_MIN) {
+      tokensMilli = OUTBOX_BURST * 1000;   // Idle long enough to be full
+      lastRefill = now;
+      return;
+    }
+    uint32_t earned = (now - lastRefill) * OUTBOX_RATE_PER_MIN / 60;
+    if (earned == 0) {
+      return;
+    }
+    // Advance only by the time actually converted, so no fraction is lost
+    lastRefill += earned * 60 / OUTBOX_RATE_PER_MIN;
+    tokensMilli += earned;
+    if (tokensMilli > OUTBOX_BURST * 1000) {
+      tokensMilli = OUTBOX_BURST * 1000;
+    }
+  }
+
+  void save() {
+    if (count == 0) {
+      prefs.remove("entries");
+    } else {
+      prefs.putBytes("entries", entries, count * sizeof(OutboxEntry));
+    }
+  }
+};
+
+#endif // PRINTOSK_STATUS_OUTBOX_H
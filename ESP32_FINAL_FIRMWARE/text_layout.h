@@ -0,0 +1,45 @@
+/**
+ * Printosk - Compile-Time Text Layout (Adafruit_GFX classic font)
+ * Width and centred position of a string, usable in constexpr tables and
+ * static_asserts as well as at runtime
+ *
+ * The built-in 5x7 font advances 6 pixels per character at size 1 (5
+ * columns plus one of spacing) and is 8 pixels tall, each scaled by the
+ * text size:
+ *
+ *   constexpr int16_t x = centeredTextX("PRINTOSK", 2, 128);   // 16
+ *   static_assert(textFits("Press 0-9 then ENTER", 1, 128), "too wide");
+ *
+ * Edit the firmware/common version; firmware/tools/sync_common_headers.sh
+ * copies it into ESP32_FINAL_FIRMWARE/ (the Arduino IDE only builds files
+ * inside the sketch folder).
+ */
+
+#ifndef PRINTOSK_TEXT_LAYOUT_H
+#define PRINTOSK_TEXT_LAYOUT_H
+
+#include <stdint.h>
+
+#define TEXT_GLYPH_WIDTH 6
+#define TEXT_GLYPH_HEIGHT 8
+
+constexpr int16_t textLength(const char* text) {
+  return *text ? 1 + textLength(text + 1) : 0;
+}
+
+constexpr int16_t textWidth(const char* text, uint8_t size) {
+  return textLength(text) * TEXT_GLYPH_WIDTH * size;
+}
+
+constexpr bool textFits(const char* text, uint8_t size, int16_t width) {
+  return textWidth(text, size) <= width;
+}
+
+/**
+ * Left edge that centres text in width; 0 if it does not fit
+ */
+constexpr int16_t centeredTextX(const char* text, uint8_t size, int16_t width) {
+  return textFits(text, size, width) ? (width - textWidth(text, size)) / 2 : 0;
+}
+
+#endif // PRINTOSK_TEXT_LAYOUT_H
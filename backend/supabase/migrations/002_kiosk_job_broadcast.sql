@@ -0,0 +1,65 @@
+-- Printosk: Kiosk Job Broadcast
+-- Created: 2026-10-18
+-- Pushes print job changes to kiosks over Supabase Realtime
+
+-- ============================================================================
+-- FUNCTION: Broadcast a job change to the kiosk-jobs channel
+-- ============================================================================
+-- Kiosks subscribe to the private broadcast topic 'kiosk-jobs' and keep
+-- their local Print ID index current from it. The payload carries the same
+-- fields as a GET /api/kiosk/job-index row and nothing else (no user data):
+--   { id, status, files, expires }   -- expires in epoch seconds
+-- Like job-index it lists every open Print ID, so only kiosk devices may
+-- receive it (policy below).
+CREATE OR REPLACE FUNCTION broadcast_kiosk_job_change()
+RETURNS TRIGGER
+LANGUAGE plpgsql
+SECURITY DEFINER
+AS $$
+BEGIN
+  -- Only changes a kiosk index can see
+  IF TG_OP = 'UPDATE'
+     AND OLD.status = NEW.status
+     AND OLD.file_count IS NOT DISTINCT FROM NEW.file_count
+     AND OLD.expires_at IS NOT DISTINCT FROM NEW.expires_at THEN
+    RETURN NEW;
+  END IF;
+
+  PERFORM realtime.send(
+    jsonb_build_object(
+      'id', NEW.print_id_numeric,
+      'status', NEW.status,
+      'files', COALESCE(NEW.file_count, 0),
+      'expires', floor(extract(epoch FROM NEW.expires_at))::BIGINT
+    ),
+    'job',          -- event
+    'kiosk-jobs',   -- topic
+    TRUE            -- private channel: realtime.messages RLS applies
+  );
+  RETURN NEW;
+END;
+$$;
+
+CREATE TRIGGER trigger_broadcast_kiosk_job_change
+  AFTER INSERT OR UPDATE OF status, file_count, expires_at ON print_jobs
+  FOR EACH ROW
+  EXECUTE FUNCTION broadcast_kiosk_job_change();
+
+-- ============================================================================
+-- POLICY: Only kiosk devices may join kiosk-jobs
+-- ============================================================================
+-- Kiosks join with a short-lived token from GET /api/kiosk/realtime-token
+-- (X-Kiosk-Key), which carries the kiosk_device claim. The anon key alone,
+-- as shipped to browsers, is refused.
+CREATE POLICY "Kiosk devices receive job broadcasts"
+  ON realtime.messages
+  FOR SELECT
+  TO authenticated
+  USING (
+    realtime.topic() = 'kiosk-jobs'
+    AND realtime.messages.extension = 'broadcast'
+    AND COALESCE((auth.jwt() ->> 'kiosk_device')::BOOLEAN, FALSE)
+  );
+
+COMMENT ON FUNCTION broadcast_kiosk_job_change() IS
+  'Realtime push of job changes to kiosks (private topic kiosk-jobs, event job). Kiosks fall back to polling /api/kiosk/job-index.';
@@ -0,0 +1,63 @@
+/**
+ * Printosk - Boot Timeline
+ * Per-stage startup timestamps, reported as one record so boot-time
+ * regressions show up in the logs.
+ *
+ * Header-only; the caller supplies the clock (microseconds since reset):
+ *   boot_timeline_mark(&timeline, "uart", time_us_32());
+ *   ...
+ *   boot_timeline_format(&timeline, line, sizeof(line));
+ *   // "BOOT_TIMELINE uart=0.8 printer=1.1 ready=1.4 (ms)"
+ */
+
+#ifndef PRINTOSK_BOOT_TIMELINE_H
+#define PRINTOSK_BOOT_TIMELINE_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef BOOT_TIMELINE_MAX_STAGES
+#define BOOT_TIMELINE_MAX_STAGES 12
+#endif
+
+typedef struct {
+  const char* name;        // Static string
+  uint32_t us;             // Microseconds since reset when the stage finished
+} boot_stage_t;
+
+typedef struct {
+  boot_stage_t stages[BOOT_TIMELINE_MAX_STAGES];
+  uint8_t count;
+} boot_timeline_t;
+
+/** Record the end of a stage (ignored once the table is full) */
+static inline void boot_timeline_mark(boot_timeline_t* t, const char* name, uint32_t now_us) {
+  if (t->count < BOOT_TIMELINE_MAX_STAGES) {
+    t->stages[t->count].name = name;
+    t->stages[t->count].us = now_us;
+    t->count++;
+  }
+}
+
+/**
+ * Format "BOOT_TIMELINE name=ms.d ... (ms)"
+ * Returns the string length (truncated to fit len).
+ */
+static inline int boot_timeline_format(const boot_timeline_t* t, char* buf, size_t len) {
+  int n = snprintf(buf, len, "BOOT_TIMELINE");
+  for (uint8_t i = 0; i < t->count && n >= 0 && (size_t)n < len; i++) {
+    n += snprintf(buf + n, len - (size_t)n, " %s=%lu.%lu",
+                  t->stages[i].name,
+                  (unsigned long)(t->stages[i].us / 1000),
+                  (unsigned long)(t->stages[i].us % 1000 / 100));
+  }
+  if (n >= 0 && (size_t)n < len) {
+    n += snprintf(buf + n, len - (size_t)n, " (ms)");
+  }
+  if (n < 0) {
+    return 0;
+  }
+  return (size_t)n < len ? n : (int)len - 1;
+}
+
+#endif // PRINTOSK_BOOT_TIMELINE_H
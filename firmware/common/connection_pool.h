@@ -0,0 +1,177 @@
+/**
+ * Printosk - HTTPS Connection Pool (ESP32, Arduino)
+ * One keep-alive TLS connection per backend host, shared by every request
+ *
+ * A fresh HTTPClient per call costs a full TLS handshake (0.5-1.5 s on an
+ * ESP32) each time. Requests here go through a pooled WiFiClientSecure with
+ * HTTP keep-alive, so only the first request to a host (or the first after
+ * the server closes the socket) pays for the handshake.
+ *
+ *   HTTPClient http;
+ *   int code = pool.request(http, url, [](HTTPClient& h) { return h.GET(); },
+ *                           ConnectionPool::RETRY_IF_STALE);
+ *   String body = http.getString();
+ *   http.end();   // Returns the connection to the pool (socket stays open)
+ *
+ * A request on a reused connection that fails at the transport level (the
+ * server closed it while idle) can be retried once on a fresh connection.
+ * The caller opts in with RETRY_IF_STALE, for idempotent requests only:
+ * a POST or PUT may have reached the server before the socket dropped.
+ *
+ * Not thread-safe: use one pool per task (the network task owns it).
+ *
+ * Edit the firmware/common version; firmware/tools/sync_common_headers.sh
+ * copies it into ESP32_FINAL_FIRMWARE/ (the Arduino IDE only builds files
+ * inside the sketch folder).
+ */
+
+#ifndef PRINTOSK_CONNECTION_POOL_H
+#define PRINTOSK_CONNECTION_POOL_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+
+#ifndef CONN_POOL_SIZE
+#define CONN_POOL_SIZE 2            // Hosts kept open at once
+#endif
+
+#ifndef CONN_POOL_HOST_LENGTH
+#define CONN_POOL_HOST_LENGTH 63
+#endif
+
+#ifndef CONN_POOL_TIMEOUT_MS
+#define CONN_POOL_TIMEOUT_MS 30000
+#endif
+
+class ConnectionPool {
+public:
+  enum Retry : uint8_t {
+    NO_RETRY,          // Transport errors go back to the caller
+    RETRY_IF_STALE     // Idempotent: resend once if a reused socket failed
+  };
+
+  /**
+   * Run one request on the pooled connection for url's host
+   * send() issues the request on the prepared HTTPClient and returns the
+   * HTTP code. The caller reads the body and then calls http.end().
+   */
+  template <typename SendFn>
+  int request(HTTPClient& http, const char* url, SendFn send, Retry retry = NO_RETRY) {
+    char host[CONN_POOL_HOST_LENGTH + 1];
+    hostOf(url, host, sizeof(host));
+    Slot* slot = slotFor(host);
+    bool reused = slot->client.connected();
+
+    uint32_t start = millis();
+    int code = attempt(http, slot, url, send);
+
+    if (code < 0 && reused && retry == RETRY_IF_STALE) {
+      // Idle keep-alive connection was closed by the server: start over
+      Serial.printf("[NET] Reused connection failed (%d), reconnecting\n", code);
+      http.end();
+      slot->client.stop();
+      reused = false;
+      start = millis();
+      code = attempt(http, slot, url, send);
+    }
+
+    if (code < 0 && reused) {
+      slot->client.stop();   // Not resent: the next request reconnects
+    }
+    record(reused, millis() - start);
+    return code;
+  }
+
+  template <typename SendFn>
+  int request(HTTPClient& http, const String& url, SendFn send, Retry retry = NO_RETRY) {
+    return request(http, url.c_str(), send, retry);
+  }
+
+  /**
+   * Drop every open connection (e.g. after WiFi reconnects)
+   */
+  void reset() {
+    for (int i = 0; i < CONN_POOL_SIZE; i++) {
+      slots[i].client.stop();
+      slots[i].host[0] = '\0';
+    }
+  }
+
+private:
+  struct Slot {
+    char host[CONN_POOL_HOST_LENGTH + 1] = "";
+    WiFiClientSecure client;
+    uint32_t lastUsed = 0;
+  };
+
+  Slot slots[CONN_POOL_SIZE];
+
+  // Latency comparison: fresh handshake vs reused connection
+  uint32_t freshCount = 0, freshTotalMs = 0;
+  uint32_t reusedCount = 0, reusedTotalMs = 0;
+
+  static void hostOf(const char* url, char* host, size_t size) {
+    const char* start = strstr(url, "://");
+    start = start == NULL ? url : start + 3;
+    size_t n = strcspn(start, "/");
+    if (n >= size) {
+      n = size - 1;
+    }
+    memcpy(host, start, n);
+    host[n] = '\0';
+  }
+
+  Slot* slotFor(const char* host) {
+    Slot* lru = &slots[0];
+    for (int i = 0; i < CONN_POOL_SIZE; i++) {
+      if (strcmp(slots[i].host, host) == 0) {
+        slots[i].lastUsed = millis();
+        return &slots[i];
+      }
+      if (slots[i].lastUsed < lru->lastUsed) {
+        lru = &slots[i];
+      }
+    }
+
+    // New host: evict the least recently used connection
+    lru->client.stop();
+    strlcpy(lru->host, host, sizeof(lru->host));
+    // No CA bundle is configured for the backend yet (as with
+    // HTTPClient::begin(url) before); pin one here when available
+    lru->client.setInsecure();
+    lru->lastUsed = millis();
+    return lru;
+  }
+
+  template <typename SendFn>
+  int attempt(HTTPClient& http, Slot* slot, const char* url, SendFn send) {
+    http.setReuse(true);
+    http.setTimeout(CONN_POOL_TIMEOUT_MS);
+    // HTTPClient keeps its own String copies of the URL parts; the pool
+    // itself allocates nothing per request
+    if (!http.begin(slot->client, url)) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    return send(http);
+  }
+
+  void record(bool reused, uint32_t ms) {
+    if (reused) {
+      reusedCount++;
+      reusedTotalMs += ms;
+    } else {
+      freshCount++;
+      freshTotalMs += ms;
+    }
+    Serial.printf("[NET] Request %lu ms (%s); avg new TLS %lu ms (n=%lu), reused %lu ms (n=%lu)\n",
+                  (unsigned long)ms,
+                  reused ? "reused" : "new TLS",
+                  (unsigned long)(freshCount ? freshTotalMs / freshCount : 0),
+                  (unsigned long)freshCount,
+                  (unsigned long)(reusedCount ? reusedTotalMs / reusedCount : 0),
+                  (unsigned long)reusedCount);
+  }
+};
+
+#endif // PRINTOSK_CONNECTION_POOL_H
@@ -0,0 +1,59 @@
+/**
+ * Printosk - HTTP Range Resume Helpers (ESP32, Arduino)
+ * Resuming a download that broke off part way instead of starting over
+ *
+ * The request asks for the rest of the file and names the copy it started
+ * from (If-Range); the server answers 206 with the rest, or 200 with the
+ * whole file if it changed in the meantime:
+ *
+ *   http.addHeader("Range", rangeFrom(offset));
+ *   http.addHeader("If-Range", etag);
+ *   ...
+ *   if (code == 206 && contentRangeStart(http.header("Content-Range").c_str()) == offset) {
+ *     // Body continues at offset
+ *   }
+ *
+ * Edit the firmware/common version; firmware/tools/sync_common_headers.sh
+ * copies it into ESP32_FINAL_FIRMWARE/ (the Arduino IDE only builds files
+ * inside the sketch folder).
+ */
+
+#ifndef PRINTOSK_HTTP_RANGE_H
+#define PRINTOSK_HTTP_RANGE_H
+
+#include <Arduino.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef HTTP_CODE_PARTIAL_CONTENT
+#define HTTP_CODE_PARTIAL_CONTENT 206
+#endif
+
+/**
+ * Range header value for everything from offset to the end
+ */
+inline String rangeFrom(uint32_t offset) {
+  return String("bytes=") + String(offset) + "-";
+}
+
+/**
+ * First byte of a "bytes <first>-<last>/<total>" Content-Range, -1 if the
+ * header is missing or malformed. total is set when known ("*" gives -1).
+ */
+inline int32_t contentRangeStart(const char* header, int32_t* total = NULL) {
+  if (header == NULL || strncmp(header, "bytes ", 6) != 0) {
+    return -1;
+  }
+  char* end;
+  long first = strtol(header + 6, &end, 10);
+  if (end == header + 6 || *end != '-' || first < 0) {
+    return -1;
+  }
+  if (total != NULL) {
+    const char* slash = strchr(end, '/');
+    *total = (slash != NULL && slash[1] != '*') ? (int32_t)strtol(slash + 1, NULL, 10) : -1;
+  }
+  return (int32_t)first;
+}
+
+#endif // PRINTOSK_HTTP_RANGE_H
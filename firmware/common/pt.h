@@ -0,0 +1,79 @@
+/**
+ * Printosk - Protothreads
+ * Stackless cooperative threads for the single-core firmware loops
+ *
+ * A protothread is a plain function that returns at every wait/yield point
+ * and resumes at the same line on its next call (switch-based local
+ * continuations). Threads cost two bytes of state and no stack, so long
+ * jobs can be broken up without an RTOS.
+ *
+ * Rules (as with any switch-based coroutine):
+ * - Locals do not survive a wait or yield; keep state in the thread's struct.
+ * - Do not put PT_WAIT/PT_YIELD inside a nested switch statement.
+ *
+ * Usage:
+ *   static char blink_thread(pt_t* pt) {
+ *     PT_BEGIN(pt);
+ *     while (1) {
+ *       PT_WAIT_UNTIL(pt, tick_elapsed());
+ *       toggle_led();
+ *     }
+ *     PT_END(pt);
+ *   }
+ *
+ *   while (1) { blink_thread(&blink_pt); other_thread(&other_pt); }
+ */
+
+#ifndef PRINTOSK_PT_H
+#define PRINTOSK_PT_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint16_t lc;             // Local continuation (resume line, 0 = start)
+} pt_t;
+
+// Thread return values
+#define PT_WAITING 0
+#define PT_YIELDED 1
+#define PT_EXITED 2
+#define PT_ENDED 3
+
+#define PT_INIT(pt) ((pt)->lc = 0)
+
+#define PT_BEGIN(pt) \
+  { char pt_yield_flag = 1; (void)pt_yield_flag; \
+    switch ((pt)->lc) { case 0:
+
+#define PT_END(pt) \
+    } pt_yield_flag = 0; PT_INIT(pt); return PT_ENDED; }
+
+/** Block until cond is true (re-evaluated every time the thread is run) */
+#define PT_WAIT_UNTIL(pt, cond) \
+  do { \
+    (pt)->lc = __LINE__; case __LINE__: \
+    if (!(cond)) return PT_WAITING; \
+  } while (0)
+
+#define PT_WAIT_WHILE(pt, cond) PT_WAIT_UNTIL((pt), !(cond))
+
+/** Give the other threads one turn, then continue */
+#define PT_YIELD(pt) \
+  do { \
+    pt_yield_flag = 0; \
+    (pt)->lc = __LINE__; case __LINE__: \
+    if (pt_yield_flag == 0) return PT_YIELDED; \
+  } while (0)
+
+/** Leave the thread; the next call starts again from PT_BEGIN */
+#define PT_EXIT(pt) \
+  do { PT_INIT(pt); return PT_EXITED; } while (0)
+
+/** Restart the thread from PT_BEGIN on its next call */
+#define PT_RESTART(pt) \
+  do { PT_INIT(pt); return PT_WAITING; } while (0)
+
+/** Run a thread once; true while it has not exited or ended */
+#define PT_SCHEDULE(f) ((f) < PT_EXITED)
+
+#endif // PRINTOSK_PT_H
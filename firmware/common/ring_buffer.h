@@ -0,0 +1,481 @@
+/**
+ * Printosk - Lock-free Ring Buffers
+ * Fixed-capacity queues shared by the ESP32 and Pico firmware
+ *
+ * Variants:
+ * - SPSC: one producer, one consumer (ISR -> main loop, core 0 -> core 1,
+ *   uartTask -> networkTask). Wait-free on every target.
+ * - MPSC: bounded, many producers, one consumer (several FreeRTOS tasks
+ *   posting to one worker). Producers claim slots with a CAS.
+ *
+ * Both support single and batch push/pop. SPSC additionally exposes
+ * zero-copy reserve/commit of contiguous spans so DMA and memcpy-free
+ * parsers can work directly in the ring storage.
+ *
+ * Usage from C (Pico):
+ *   RING_SPSC_DEFINE(rx_ring, uint8_t, 1024)
+ *   static rx_ring_t ring;  rx_ring_init(&ring);  rx_ring_push(&ring, &byte);
+ *
+ * Usage from C++ (ESP32):
+ *   printosk::SpscRing<UARTMessage, 8> queue;  queue.push(msg);
+ *
+ * A given ring must only be accessed from one language (the atomic types
+ * differ between C11 and C++11). Capacity must be a power of two (MPSC:
+ * at least 2).
+ *
+ * Portability:
+ * - Xtensa (ESP32) and x86: all operations are lock-free.
+ * - Cortex-M0+ (RP2040): SPSC uses plain loads/stores plus barriers and is
+ *   lock-free. The MPSC producer CAS is lowered to __atomic_* helpers, which
+ *   the SDK provides via pico_atomic (hardware spinlock, IRQ-safe).
+ */
+
+#ifndef PRINTOSK_RING_BUFFER_H
+#define PRINTOSK_RING_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+// ============================================================================
+// PORTABILITY LAYER
+// ============================================================================
+
+// Cache line size used to keep producer and consumer state apart
+#ifndef RB_CACHE_LINE
+  #if defined(__XTENSA__)
+    #define RB_CACHE_LINE 32
+  #elif defined(__ARM_ARCH_6M__)
+    #define RB_CACHE_LINE 4    // No data cache on M0+, don't waste SRAM
+  #else
+    #define RB_CACHE_LINE 64
+  #endif
+#endif
+
+#ifdef __cplusplus
+  #include <atomic>
+  #include <type_traits>
+
+  typedef std::atomic<uint32_t> rb_atomic_u32;
+  #define RB_ALIGNAS(n) alignas(n)
+  #define RB_STATIC_ASSERT(cond, msg) static_assert(cond, msg)
+
+  #define rb_load_relaxed(p) (p)->load(std::memory_order_relaxed)
+  #define rb_load_acquire(p) (p)->load(std::memory_order_acquire)
+  #define rb_store_relaxed(p, v) (p)->store((v), std::memory_order_relaxed)
+  #define rb_store_release(p, v) (p)->store((v), std::memory_order_release)
+  #define rb_cas_weak(p, expected, desired) \
+    (p)->compare_exchange_weak(*(expected), (desired), \
+      std::memory_order_relaxed, std::memory_order_relaxed)
+#else
+  #include <stdatomic.h>
+
+  typedef _Atomic uint32_t rb_atomic_u32;
+  #define RB_ALIGNAS(n) _Alignas(n)
+  #define RB_STATIC_ASSERT(cond, msg) _Static_assert(cond, msg)
+
+  #define rb_load_relaxed(p) atomic_load_explicit((p), memory_order_relaxed)
+  #define rb_load_acquire(p) atomic_load_explicit((p), memory_order_acquire)
+  #define rb_store_relaxed(p, v) atomic_store_explicit((p), (v), memory_order_relaxed)
+  #define rb_store_release(p, v) atomic_store_explicit((p), (v), memory_order_release)
+  #define rb_cas_weak(p, expected, desired) \
+    atomic_compare_exchange_weak_explicit((p), (expected), (desired), \
+      memory_order_relaxed, memory_order_relaxed)
+#endif
+
+#define RB_IS_POW2(n) ((n) != 0 && (((n) & ((n) - 1)) == 0))
+
+// With one slot, "free for pos + 1" and "holds pos" are the same sequence
+// value, so the MPSC scheme needs at least two
+#define RB_MPSC_CAPACITY_OK(n) (RB_IS_POW2(n) && (n) >= 2)
+
+// ============================================================================
+// SPSC CORE
+// ============================================================================
+
+/**
+ * SPSC control block
+ * Indices are free-running; slot = index & mask. Each side keeps a cached
+ * copy of the other side's index so the shared line is only touched when
+ * the ring looks full (producer) or empty (consumer).
+ */
+typedef struct {
+  RB_ALIGNAS(RB_CACHE_LINE) rb_atomic_u32 head;  // Written by producer
+  uint32_t cached_tail;                          // Producer-private
+  RB_ALIGNAS(RB_CACHE_LINE) rb_atomic_u32 tail;  // Written by consumer
+  uint32_t cached_head;                          // Consumer-private
+} rb_spsc_t;
+
+static inline void rb_spsc_init(rb_spsc_t* rb) {
+  rb_store_relaxed(&rb->head, 0);
+  rb_store_relaxed(&rb->tail, 0);
+  rb->cached_tail = 0;
+  rb->cached_head = 0;
+}
+
+/**
+ * Producer: reserve a contiguous writable span
+ * Returns pointer to the first free slot and sets *count to the number of
+ * contiguous free slots (may be less than total free space at wrap-around).
+ */
+static inline void* rb_spsc_write_reserve(rb_spsc_t* rb, void* slots, uint32_t capacity,
+                                          uint32_t elem_size, uint32_t* count) {
+  uint32_t head = rb_load_relaxed(&rb->head);
+  uint32_t used = head - rb->cached_tail;
+  if (used == capacity) {
+    rb->cached_tail = rb_load_acquire(&rb->tail);
+    used = head - rb->cached_tail;
+  }
+  uint32_t index = head & (capacity - 1);
+  uint32_t to_end = capacity - index;
+  uint32_t free_slots = capacity - used;
+  *count = free_slots < to_end ? free_slots : to_end;
+  return (uint8_t*)slots + (size_t)index * elem_size;
+}
+
+/**
+ * Producer: publish n slots previously obtained from rb_spsc_write_reserve()
+ */
+static inline void rb_spsc_write_commit(rb_spsc_t* rb, uint32_t n) {
+  rb_store_release(&rb->head, rb_load_relaxed(&rb->head) + n);
+}
+
+/**
+ * Consumer: peek a contiguous readable span
+ */
+static inline const void* rb_spsc_read_peek(rb_spsc_t* rb, const void* slots, uint32_t capacity,
+                                            uint32_t elem_size, uint32_t* count) {
+  uint32_t tail = rb_load_relaxed(&rb->tail);
+  uint32_t avail = rb->cached_head - tail;
+  if (avail == 0) {
+    rb->cached_head = rb_load_acquire(&rb->head);
+    avail = rb->cached_head - tail;
+  }
+  uint32_t index = tail & (capacity - 1);
+  uint32_t to_end = capacity - index;
+  *count = avail < to_end ? avail : to_end;
+  return (const uint8_t*)slots + (size_t)index * elem_size;
+}
+
+/**
+ * Consumer: release n slots previously obtained from rb_spsc_read_peek()
+ */
+static inline void rb_spsc_read_release(rb_spsc_t* rb, uint32_t n) {
+  rb_store_release(&rb->tail, rb_load_relaxed(&rb->tail) + n);
+}
+
+/**
+ * Producer: copy up to n items in (handles wrap-around)
+ * Returns number of items pushed.
+ */
+static inline uint32_t rb_spsc_push_batch(rb_spsc_t* rb, void* slots, uint32_t capacity,
+                                          uint32_t elem_size, const void* items, uint32_t n) {
+  uint32_t done = 0;
+  // Usually two spans: up to the end of storage, then from the start
+  while (done < n) {
+    uint32_t span;
+    void* dst = rb_spsc_write_reserve(rb, slots, capacity, elem_size, &span);
+    if (span == 0) {
+      break;
+    }
+    if (span > n - done) {
+      span = n - done;
+    }
+    memcpy(dst, (const uint8_t*)items + (size_t)done * elem_size, (size_t)span * elem_size);
+    done += span;
+    rb_spsc_write_commit(rb, span);
+  }
+  return done;
+}
+
+/**
+ * Consumer: copy up to n items out (handles wrap-around)
+ * Returns number of items popped.
+ */
+static inline uint32_t rb_spsc_pop_batch(rb_spsc_t* rb, const void* slots, uint32_t capacity,
+                                         uint32_t elem_size, void* out, uint32_t n) {
+  uint32_t done = 0;
+  while (done < n) {
+    uint32_t span;
+    const void* src = rb_spsc_read_peek(rb, slots, capacity, elem_size, &span);
+    if (span == 0) {
+      break;
+    }
+    if (span > n - done) {
+      span = n - done;
+    }
+    memcpy((uint8_t*)out + (size_t)done * elem_size, src, (size_t)span * elem_size);
+    done += span;
+    rb_spsc_read_release(rb, span);
+  }
+  return done;
+}
+
+/**
+ * Approximate fill level (exact when called from producer or consumer)
+ */
+static inline uint32_t rb_spsc_size(rb_spsc_t* rb) {
+  return rb_load_acquire(&rb->head) - rb_load_acquire(&rb->tail);
+}
+
+// ============================================================================
+// MPSC CORE (bounded, per-slot sequence numbers)
+// ============================================================================
+
+/**
+ * MPSC control block
+ * seq[i] == pos       : slot free for the producer claiming position pos
+ * seq[i] == pos + 1   : slot holds the item for position pos
+ */
+typedef struct {
+  RB_ALIGNAS(RB_CACHE_LINE) rb_atomic_u32 head;  // Next position to claim (producers)
+  RB_ALIGNAS(RB_CACHE_LINE) rb_atomic_u32 tail;  // Next position to read (consumer)
+} rb_mpsc_t;
+
+static inline void rb_mpsc_init(rb_mpsc_t* rb, rb_atomic_u32* seq, uint32_t capacity) {
+  assert(RB_MPSC_CAPACITY_OK(capacity));
+  for (uint32_t i = 0; i < capacity; i++) {
+    rb_store_relaxed(&seq[i], i);
+  }
+  rb_store_relaxed(&rb->head, 0);
+  rb_store_release(&rb->tail, 0);
+}
+
+/**
+ * Producer: push up to n items as one contiguous claim
+ * Items from one batch are consumed in order and are never interleaved with
+ * another producer's batch. Returns number of items pushed (0 when full).
+ */
+static inline uint32_t rb_mpsc_push_batch(rb_mpsc_t* rb, rb_atomic_u32* seq, void* slots,
+                                          uint32_t capacity, uint32_t elem_size,
+                                          const void* items, uint32_t n) {
+  uint32_t pos = rb_load_relaxed(&rb->head);
+  uint32_t k;
+
+  for (;;) {
+    uint32_t used = pos - rb_load_acquire(&rb->tail);
+    if (used > capacity) {
+      // Stale head snapshot (consumer already passed it)
+      pos = rb_load_relaxed(&rb->head);
+      continue;
+    }
+    uint32_t free_slots = capacity - used;
+    k = n < free_slots ? n : free_slots;
+    if (k == 0) {
+      return 0;
+    }
+    // Consumer frees in order, so if the last slot is free all earlier ones are
+    uint32_t last = pos + k - 1;
+    if (rb_load_acquire(&seq[last & (capacity - 1)]) != last) {
+      pos = rb_load_relaxed(&rb->head);
+      continue;
+    }
+    if (rb_cas_weak(&rb->head, &pos, pos + k)) {
+      break;
+    }
+  }
+
+  for (uint32_t i = 0; i < k; i++) {
+    uint32_t index = (pos + i) & (capacity - 1);
+    memcpy((uint8_t*)slots + (size_t)index * elem_size,
+           (const uint8_t*)items + (size_t)i * elem_size, elem_size);
+    rb_store_release(&seq[index], pos + i + 1);
+  }
+  return k;
+}
+
+/**
+ * Consumer: pop up to n items in order
+ * Stops at the first slot a producer has claimed but not yet published.
+ */
+static inline uint32_t rb_mpsc_pop_batch(rb_mpsc_t* rb, rb_atomic_u32* seq, const void* slots,
+                                         uint32_t capacity, uint32_t elem_size,
+                                         void* out, uint32_t n) {
+  uint32_t pos = rb_load_relaxed(&rb->tail);
+  uint32_t done = 0;
+
+  while (done < n) {
+    uint32_t index = pos & (capacity - 1);
+    if (rb_load_acquire(&seq[index]) != pos + 1) {
+      break;
+    }
+    memcpy((uint8_t*)out + (size_t)done * elem_size,
+           (const uint8_t*)slots + (size_t)index * elem_size, elem_size);
+    rb_store_release(&seq[index], pos + capacity);
+    pos++;
+    done++;
+  }
+
+  if (done > 0) {
+    rb_store_release(&rb->tail, pos);
+  }
+  return done;
+}
+
+static inline uint32_t rb_mpsc_size(rb_mpsc_t* rb) {
+  return rb_load_acquire(&rb->head) - rb_load_acquire(&rb->tail);
+}
+
+// ============================================================================
+// TYPED C WRAPPERS
+// ============================================================================
+
+/**
+ * Define an SPSC ring type `name_t` holding `capacity` items of `type`,
+ * plus static inline helpers name_init/push/pop/push_batch/pop_batch/
+ * write_reserve/write_commit/read_peek/read_release/size.
+ */
+#define RING_SPSC_DEFINE(name, type, capacity) \
+  RB_STATIC_ASSERT(RB_IS_POW2(capacity), #name " capacity must be a power of two"); \
+  typedef struct { \
+    rb_spsc_t ctl; \
+    RB_ALIGNAS(RB_CACHE_LINE) type slots[capacity]; \
+  } name##_t; \
+  static inline void name##_init(name##_t* rb) { rb_spsc_init(&rb->ctl); } \
+  static inline uint32_t name##_push_batch(name##_t* rb, const type* items, uint32_t n) { \
+    return rb_spsc_push_batch(&rb->ctl, rb->slots, (capacity), sizeof(type), items, n); \
+  } \
+  static inline uint32_t name##_pop_batch(name##_t* rb, type* out, uint32_t n) { \
+    return rb_spsc_pop_batch(&rb->ctl, rb->slots, (capacity), sizeof(type), out, n); \
+  } \
+  static inline bool name##_push(name##_t* rb, const type* item) { \
+    return name##_push_batch(rb, item, 1) == 1; \
+  } \
+  static inline bool name##_pop(name##_t* rb, type* out) { \
+    return name##_pop_batch(rb, out, 1) == 1; \
+  } \
+  static inline type* name##_write_reserve(name##_t* rb, uint32_t* count) { \
+    return (type*)rb_spsc_write_reserve(&rb->ctl, rb->slots, (capacity), sizeof(type), count); \
+  } \
+  static inline void name##_write_commit(name##_t* rb, uint32_t n) { \
+    rb_spsc_write_commit(&rb->ctl, n); \
+  } \
+  static inline const type* name##_read_peek(name##_t* rb, uint32_t* count) { \
+    return (const type*)rb_spsc_read_peek(&rb->ctl, rb->slots, (capacity), sizeof(type), count); \
+  } \
+  static inline void name##_read_release(name##_t* rb, uint32_t n) { \
+    rb_spsc_read_release(&rb->ctl, n); \
+  } \
+  static inline uint32_t name##_size(name##_t* rb) { return rb_spsc_size(&rb->ctl); }
+
+/**
+ * Define a bounded MPSC ring type `name_t` holding `capacity` items of `type`,
+ * plus static inline helpers name_init/push/pop/push_batch/pop_batch/size.
+ */
+#define RING_MPSC_DEFINE(name, type, capacity) \
+  RB_STATIC_ASSERT(RB_MPSC_CAPACITY_OK(capacity), #name " capacity must be a power of two, at least 2"); \
+  typedef struct { \
+    rb_mpsc_t ctl; \
+    rb_atomic_u32 seq[capacity]; \
+    type slots[capacity]; \
+  } name##_t; \
+  static inline void name##_init(name##_t* rb) { rb_mpsc_init(&rb->ctl, rb->seq, (capacity)); } \
+  static inline uint32_t name##_push_batch(name##_t* rb, const type* items, uint32_t n) { \
+    return rb_mpsc_push_batch(&rb->ctl, rb->seq, rb->slots, (capacity), sizeof(type), items, n); \
+  } \
+  static inline uint32_t name##_pop_batch(name##_t* rb, type* out, uint32_t n) { \
+    return rb_mpsc_pop_batch(&rb->ctl, rb->seq, rb->slots, (capacity), sizeof(type), out, n); \
+  } \
+  static inline bool name##_push(name##_t* rb, const type* item) { \
+    return name##_push_batch(rb, item, 1) == 1; \
+  } \
+  static inline bool name##_pop(name##_t* rb, type* out) { \
+    return name##_pop_batch(rb, out, 1) == 1; \
+  } \
+  static inline uint32_t name##_size(name##_t* rb) { return rb_mpsc_size(&rb->ctl); }
+
+// ============================================================================
+// C++ TEMPLATES
+// ============================================================================
+
+#ifdef __cplusplus
+namespace printosk {
+
+/**
+ * Single-producer single-consumer ring of trivially copyable T
+ */
+template <typename T, uint32_t Capacity>
+class SpscRing {
+  static_assert(RB_IS_POW2(Capacity), "SpscRing capacity must be a power of two");
+  static_assert(std::is_trivially_copyable<T>::value, "SpscRing requires trivially copyable T");
+
+public:
+  SpscRing() { rb_spsc_init(&ctl); }
+  SpscRing(const SpscRing&) = delete;
+  SpscRing& operator=(const SpscRing&) = delete;
+
+  bool push(const T& item) { return pushBatch(&item, 1) == 1; }
+  bool pop(T& out) { return popBatch(&out, 1) == 1; }
+
+  uint32_t pushBatch(const T* items, uint32_t n) {
+    return rb_spsc_push_batch(&ctl, slots, Capacity, sizeof(T), items, n);
+  }
+
+  uint32_t popBatch(T* out, uint32_t n) {
+    return rb_spsc_pop_batch(&ctl, slots, Capacity, sizeof(T), out, n);
+  }
+
+  /**
+   * Zero-copy write: fill up to *count slots at the returned pointer, then commit
+   */
+  T* writeReserve(uint32_t* count) {
+    return static_cast<T*>(rb_spsc_write_reserve(&ctl, slots, Capacity, sizeof(T), count));
+  }
+  void writeCommit(uint32_t n) { rb_spsc_write_commit(&ctl, n); }
+
+  /**
+   * Zero-copy read: consume up to *count slots at the returned pointer, then release
+   */
+  const T* readPeek(uint32_t* count) {
+    return static_cast<const T*>(rb_spsc_read_peek(&ctl, slots, Capacity, sizeof(T), count));
+  }
+  void readRelease(uint32_t n) { rb_spsc_read_release(&ctl, n); }
+
+  uint32_t size() { return rb_spsc_size(&ctl); }
+  bool empty() { return size() == 0; }
+  static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+  rb_spsc_t ctl;
+  alignas(RB_CACHE_LINE) T slots[Capacity];
+};
+
+/**
+ * Bounded multi-producer single-consumer ring of trivially copyable T
+ */
+template <typename T, uint32_t Capacity>
+class MpscRing {
+  static_assert(RB_MPSC_CAPACITY_OK(Capacity), "MpscRing capacity must be a power of two, at least 2");
+  static_assert(std::is_trivially_copyable<T>::value, "MpscRing requires trivially copyable T");
+
+public:
+  MpscRing() { rb_mpsc_init(&ctl, seq, Capacity); }
+  MpscRing(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+
+  bool push(const T& item) { return pushBatch(&item, 1) == 1; }
+  bool pop(T& out) { return popBatch(&out, 1) == 1; }
+
+  uint32_t pushBatch(const T* items, uint32_t n) {
+    return rb_mpsc_push_batch(&ctl, seq, slots, Capacity, sizeof(T), items, n);
+  }
+
+  uint32_t popBatch(T* out, uint32_t n) {
+    return rb_mpsc_pop_batch(&ctl, seq, slots, Capacity, sizeof(T), out, n);
+  }
+
+  uint32_t size() { return rb_mpsc_size(&ctl); }
+  bool empty() { return size() == 0; }
+  static constexpr uint32_t capacity() { return Capacity; }
+
+private:
+  rb_mpsc_t ctl;
+  rb_atomic_u32 seq[Capacity];
+  T slots[Capacity];
+};
+
+}  // namespace printosk
+#endif  // __cplusplus
+
+#endif  // PRINTOSK_RING_BUFFER_H
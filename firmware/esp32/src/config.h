@@ -38,6 +38,18 @@
 #define UART_BAUD_RATE 115200
 #define UART_BUFFER_SIZE 512
 
+// SPI bulk link to Pico (HSPI via GPIO matrix; Pico is slave on SPI0)
+#define SPI_LINK_SCK_PIN 32
+#define SPI_LINK_MOSI_PIN 23
+#define SPI_LINK_MISO_PIN 35          // Input-only pin; Pico sends nothing back
+#define SPI_LINK_CS_PIN 5
+#define SPI_LINK_READY_PIN 4          // Pico GPIO 22: high = block buffer armed
+#define SPI_LINK_CLOCK_HZ 10000000    // RP2040 slave limit is clk_peri/12
+#define SPI_LINK_BLOCK_SIZE 4096      // Must match the Pico
+#define SPI_LINK_GUARD_US 10          // Settle time before sampling READY again
+#define SPI_LINK_READY_TIMEOUT_MS 200 // Covers a flash sector erase on the Pico
+#define LINK_BENCH_BYTES 65536        // Per transport; ~6 s over 115200 baud UART
+
 // ============================================================================
 // KEYPAD LAYOUT
 // ============================================================================
@@ -116,6 +128,7 @@
 #define UART_MSG_PRINT_CMD 0x10
 #define UART_MSG_STATUS 0x20
 #define UART_MSG_ERROR 0x30
+#define UART_MSG_BENCH 0x43
 #define UART_MSG_ACK 0xFF
 
 // ============================================================================
@@ -144,5 +157,6 @@
 #define FEATURE_MOCK_KEYPAD 0       // Simulate keypad input for testing
 #define FEATURE_MOCK_SUPABASE 0     // Simulate Supabase responses
 #define FEATURE_DEBUG_DISPLAY 0     // Show debug info on OLED
+#define FEATURE_SPI_LINK 1          // Bulk data to Pico over SPI
 
 #endif // CONFIG_H
@@ -8,6 +8,7 @@
 
 #include <Adafruit_SSD1306.h>
 #include "state_machine.h"
+#include "text_layout.h"
 
 class DisplayManager {
 public:
@@ -62,7 +63,7 @@ private:
   void drawFooter(const char* hint);
 
   /**
-   * Draw centered text
+   * Draw centered text (x from centeredTextX() in text_layout.h)
    */
   void drawCenteredText(const char* text, int y, int textSize = 1);
 };
@@ -14,6 +14,7 @@
  * - 4x4 Numeric Keypad (GPIO 14-17: rows, GPIO 18-21: cols)
  * - SSD1306 OLED 128x64 (I2C: SDA=GPIO21, SCL=GPIO22)
  * - UART to Pico (TX=GPIO17, RX=GPIO16, 115200 baud)
+ * - SPI to Pico for bulk data (SCK=GPIO32, MOSI=GPIO23, CS=GPIO5, READY=GPIO4)
  */
 
 #include "config.h"
@@ -22,6 +23,7 @@
 #include "keypad.h"
 #include "display.h"
 #include "uart_protocol.h"
+#include "spi_link.h"
 #include "state_machine.h"
 #include "utils.h"
 #include <freertos/FreeRTOS.h>
@@ -30,9 +32,11 @@
 // Global state
 StateMachine stateMachine;
 UARTProtocol uartProtocol;
+SPILink spiLink;
 KeypadManager keypadManager;
 DisplayManager displayManager;
 SupabaseClient supabaseClient;
+ConnectionPool connectionPool;  // Keep-alive TLS shared by all Supabase calls
 
 // Task handles
 TaskHandle_t keypadTaskHandle = NULL;
@@ -127,6 +131,44 @@ void uartTask(void *pvParameters) {
   }
 }
 
+#if FEATURE_SPI_LINK
+/**
+ * Transport benchmark: the same BENCH payload over UART, then SPI
+ * Triggered by "BENCH" on the serial console. The Pico answers each run
+ * with its receive-side timing as a STATUS from job "BENCH".
+ */
+void runLinkBench() {
+  static UARTMessage msg;
+  msg.type = UART_MSG_BENCH;
+  memset(msg.payload, 0x55, sizeof(msg.payload));
+
+  uint32_t start = micros();
+  uint32_t sent = 0;
+  while (sent < LINK_BENCH_BYTES) {
+    msg.length = min((uint32_t)sizeof(msg.payload), LINK_BENCH_BYTES - sent);
+    if (!uartProtocol.sendFrame(&msg)) {
+      log_error("[BENCH] UART send failed");
+      return;
+    }
+    sent += msg.length;
+  }
+  uint32_t elapsed = micros() - start;
+  msg.length = 0;
+  uartProtocol.sendFrame(&msg);
+  log_info("[BENCH] uart: %u B in %u us, %u kbit/s",
+    sent, elapsed, (uint32_t)((uint64_t)sent * 8000 / elapsed));
+
+  start = micros();
+  uint32_t kbps = spiLink.bench(LINK_BENCH_BYTES);
+  elapsed = micros() - start;
+  if (kbps == 0) {
+    log_error("[BENCH] SPI send failed");
+    return;
+  }
+  log_info("[BENCH] spi: %u B in %u us, %u kbit/s", LINK_BENCH_BYTES, elapsed, kbps);
+}
+#endif
+
 /**
  * ESP32 initialization
  * Called once on startup
@@ -157,6 +199,13 @@ void setup() {
   if (!uartProtocol.init(UART_TX_PIN, UART_RX_PIN, UART_BAUD_RATE)) {
     log_error("[INIT] Failed to initialize UART!");
   }
+
+#if FEATURE_SPI_LINK
+  log_info("[INIT] Initializing SPI link...");
+  if (!spiLink.init()) {
+    log_error("[INIT] Failed to initialize SPI link!");
+  }
+#endif
   
   // Connect to WiFi
   log_info("[INIT] Connecting to WiFi...");
@@ -170,7 +219,7 @@ void setup() {
   
   // Initialize Supabase client
   log_info("[INIT] Initializing Supabase client...");
-  if (!supabaseClient.init(SUPABASE_URL, SUPABASE_API_KEY)) {
+  if (!supabaseClient.init(SUPABASE_URL, SUPABASE_API_KEY, &connectionPool)) {
     log_error("[INIT] Failed to initialize Supabase client!");
   }
   
@@ -195,11 +244,23 @@ void setup() {
  * Handled by FreeRTOS tasks, this is a placeholder
  */
 void loop() {
+  static uint32_t lastHeapLog = 0;
+
   // All work is done in FreeRTOS tasks
-  vTaskDelay(pdMS_TO_TICKS(10000));
-  
+  vTaskDelay(pdMS_TO_TICKS(100));
+
+#if FEATURE_SPI_LINK
+  // Serial console: BENCH compares the UART and SPI transports
+  if (Serial.available() && Serial.readStringUntil('\n').startsWith("BENCH")) {
+    runLinkBench();
+  }
+#endif
+
   // Periodic debug info
-  log_debug("[HEAP] Free heap: %u bytes, largest block: %u bytes",
-    ESP.getFreeHeap(),
-    ESP.getMaxAllocHeap());
+  if (millis() - lastHeapLog > 10000) {
+    lastHeapLog = millis();
+    log_debug("[HEAP] Free heap: %u bytes, largest block: %u bytes",
+      ESP.getFreeHeap(),
+      ESP.getMaxAllocHeap());
+  }
 }
@@ -0,0 +1,122 @@
+/**
+ * Printosk ESP32 - SPI Bulk Link
+ */
+
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include "config.h"
+#include "spi_link.h"
+#include "utils.h"
+
+bool SPILink::init() {
+  block = (uint8_t*)heap_caps_malloc(SPI_LINK_BLOCK_SIZE, MALLOC_CAP_DMA);
+  if (block == NULL) {
+    log_error("[SPI] Block buffer allocation failed");
+    return false;
+  }
+
+  pinMode(SPI_LINK_CS_PIN, OUTPUT);
+  digitalWrite(SPI_LINK_CS_PIN, HIGH);
+  pinMode(SPI_LINK_READY_PIN, INPUT_PULLDOWN);
+
+  spi = new SPIClass(HSPI);
+  spi->begin(SPI_LINK_SCK_PIN, SPI_LINK_MISO_PIN, SPI_LINK_MOSI_PIN, -1);
+
+  log_info("[SPI] Link ready: %u Hz, %u byte blocks", SPI_LINK_CLOCK_HZ, SPI_LINK_BLOCK_SIZE);
+  return true;
+}
+
+bool SPILink::waitReady(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (digitalRead(SPI_LINK_READY_PIN) == LOW) {
+    if (millis() - start > timeoutMs) {
+      return false;
+    }
+    // Spin briefly first: a re-arm normally takes microseconds
+    if (millis() - start > 1) {
+      vTaskDelay(1);
+    }
+  }
+  return true;
+}
+
+bool SPILink::sendFrame(uint8_t type, const uint8_t* payload, uint16_t len) {
+  if (block == NULL || len > maxPayload()) {
+    return false;
+  }
+
+  block[0] = UART_FRAME_START;
+  block[1] = len & 0xFF;
+  block[2] = len >> 8;
+  block[3] = type;
+  if (len > 0) {
+    memcpy(&block[4], payload, len);
+  }
+  block[4 + len] = calculateCRC(&block[3], len + 1);
+  block[5 + len] = UART_FRAME_END;
+  memset(&block[6 + len], 0, SPI_LINK_BLOCK_SIZE - 6 - len);
+
+  if (!waitReady(SPI_LINK_READY_TIMEOUT_MS)) {
+    log_error("[SPI] Pico not ready, frame 0x%02x dropped", type);
+    return false;
+  }
+
+  // Mode 3 (CPHA=1): the Pico slave keeps CS low across the whole block
+  spi->beginTransaction(SPISettings(SPI_LINK_CLOCK_HZ, MSBFIRST, SPI_MODE3));
+  digitalWrite(SPI_LINK_CS_PIN, LOW);
+  spi->writeBytes(block, SPI_LINK_BLOCK_SIZE);
+  digitalWrite(SPI_LINK_CS_PIN, HIGH);
+  spi->endTransaction();
+
+  delayMicroseconds(SPI_LINK_GUARD_US);
+  return true;
+}
+
+bool SPILink::sendJob(const char* jobId, const uint8_t* data, size_t len) {
+  if (!sendFrame(SPI_MSG_DATA_BEGIN, (const uint8_t*)jobId, strlen(jobId))) {
+    return false;
+  }
+
+  while (len > 0) {
+    uint16_t chunk = len < maxPayload() ? len : maxPayload();
+    if (!sendFrame(SPI_MSG_DATA, data, chunk)) {
+      return false;
+    }
+    data += chunk;
+    len -= chunk;
+  }
+
+  return sendFrame(SPI_MSG_DATA_END, NULL, 0);
+}
+
+uint32_t SPILink::bench(uint32_t totalBytes) {
+  static uint8_t payload[maxPayload()];
+  memset(payload, 0x55, sizeof(payload));
+
+  uint32_t start = micros();
+  uint32_t sent = 0;
+  while (sent < totalBytes) {
+    uint16_t chunk = totalBytes - sent < maxPayload() ? totalBytes - sent : maxPayload();
+    if (!sendFrame(SPI_MSG_BENCH, payload, chunk)) {
+      return 0;
+    }
+    sent += chunk;
+  }
+  uint32_t elapsed = micros() - start;
+
+  // Empty frame closes the run; the Pico reports its own timing over UART
+  sendFrame(SPI_MSG_BENCH, NULL, 0);
+
+  return elapsed ? (uint32_t)((uint64_t)sent * 8000 / elapsed) : 0;
+}
+
+uint8_t SPILink::calculateCRC(const uint8_t* data, int len) {
+  uint8_t crc = 0xFF;
+  for (int i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1;
+    }
+  }
+  return crc;
+}
@@ -0,0 +1,72 @@
+/**
+ * Printosk ESP32 - SPI Bulk Link
+ * SPI master to the Pico for bulk data; UART stays the control channel
+ *
+ * Every transaction is one SPI_LINK_BLOCK_SIZE block holding one frame in
+ * the UART format, zero padded:
+ *   [START=0xAA][LEN_L][LEN_H][TYPE][PAYLOAD][CRC][END=0xBB][padding]
+ *
+ * The Pico raises READY while it has a DMA buffer armed. A block is only
+ * clocked out once READY is high; after each block the master waits
+ * SPI_LINK_GUARD_US so it never samples the previous block's READY.
+ */
+
+#ifndef SPI_LINK_H
+#define SPI_LINK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <SPI.h>
+#include "config.h"
+
+// Bulk frame types (Pico config.h CMD_TYPE_DATA_BEGIN..CMD_TYPE_BENCH)
+#define SPI_MSG_DATA_BEGIN 0x40
+#define SPI_MSG_DATA 0x41
+#define SPI_MSG_DATA_END 0x42
+#define SPI_MSG_BENCH 0x43
+
+class SPILink {
+public:
+  /**
+   * Configure SPI bus, CS and READY pins
+   */
+  bool init();
+
+  /**
+   * Send one frame as one block
+   * Fails if READY does not come up within SPI_LINK_READY_TIMEOUT_MS.
+   */
+  bool sendFrame(uint8_t type, const uint8_t* payload, uint16_t len);
+
+  /**
+   * Stream a job into the Pico's flash spool: DATA_BEGIN, DATA..., DATA_END
+   */
+  bool sendJob(const char* jobId, const uint8_t* data, size_t len);
+
+  /**
+   * Send totalBytes of BENCH frames plus the closing empty frame
+   * Returns master-side throughput in kbit/s, 0 on failure.
+   */
+  uint32_t bench(uint32_t totalBytes);
+
+  /**
+   * Largest payload one block carries
+   */
+  static constexpr uint16_t maxPayload() { return SPI_LINK_BLOCK_SIZE - 6; }
+
+private:
+  SPIClass* spi;
+  uint8_t* block;   // One DMA-capable block buffer
+
+  bool waitReady(uint32_t timeoutMs);
+
+  /**
+   * Calculate CRC8 checksum (same as UARTProtocol)
+   */
+  uint8_t calculateCRC(const uint8_t* data, int len);
+};
+
+// Global instance
+extern SPILink spiLink;
+
+#endif // SPI_LINK_H
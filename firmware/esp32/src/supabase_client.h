@@ -9,20 +9,8 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <string>
-
-// Structure for print job data
-struct PrintJob {
-  char id[37];              // UUID string
-  int print_id_numeric;     // 6-digit Print ID
-  char job_title[256];
-  bool color_mode;
-  int copies;
-  char paper_size[20];
-  bool double_sided;
-  char status[20];
-  int total_pages;
-  int file_count;
-};
+#include "connection_pool.h"
+#include "job_json.h"   // PrintJob, streaming fetch-response parser
 
 // Structure for job status update
 struct JobStatusUpdate {
@@ -35,12 +23,15 @@ class SupabaseClient {
 public:
   /**
    * Initialize Supabase client with API credentials
+   * Requests go through pool (keep-alive TLS, one connection per host);
+   * call only from the task that owns the pool.
    */
-  bool init(const char* url, const char* apiKey);
+  bool init(const char* url, const char* apiKey, ConnectionPool* pool);
 
   /**
    * Fetch print job by numeric ID
-   * Returns true if successful, fills PrintJob struct
+   * Returns true if successful, fills PrintJob struct. The body is parsed
+   * as it streams in (JobJsonParser), never buffered whole.
    */
   bool fetchJobByPrintId(int printId, PrintJob* job);
 
@@ -67,7 +58,7 @@ public:
 private:
   std::string supabaseUrl;
   std::string apiKey;
-  HTTPClient http;
+  ConnectionPool* pool;
 
   /**
    * Build Authorization header
@@ -16,6 +16,7 @@
 #define UART_MSG_PRINT_CMD 0x10
 #define UART_MSG_STATUS 0x20
 #define UART_MSG_ERROR 0x30
+#define UART_MSG_BENCH 0x43   // Same as SPI_MSG_BENCH; UART side of the bench
 #define UART_MSG_ACK 0xFF
 
 // Message structure
@@ -0,0 +1,146 @@
+/**
+ * Printosk Pico - Job Checkpoints
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/regs/m0plus.h"
+#include "checkpoint.h"
+#include "utils.h"
+
+#define CHECKPOINT_MAGIC 0x4A4F4232u     // "JOB2"
+#define CHECKPOINT_ACTIVE 0xFF
+#define CHECKPOINT_DONE 0x00
+
+// Scratch 0-3 are free for applications (the SDK reboot path uses 4-7)
+#define SCRATCH_MAGIC 0
+#define SCRATCH_BAND 1
+#define SCRATCH_OFFSET 2
+#define SCRATCH_CHECK 3
+
+// Flash record (programmed as whole pages)
+typedef struct {
+  uint32_t magic;
+  uint16_t frame_len;
+  uint8_t crc;             // CRC8 over frame
+  uint8_t state;           // ACTIVE when written; cleared to DONE in place
+  uint8_t attempts;        // One bit cleared per restore (0xFF: never restored)
+  uint8_t frame[UART_BUFFER_SIZE];
+} CheckpointRecord;
+
+#define CHECKPOINT_RECORD_PAGES ((sizeof(CheckpointRecord) + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE)
+
+static uint8_t record_buf[CHECKPOINT_RECORD_PAGES * FLASH_PAGE_SIZE];
+
+static inline const CheckpointRecord* stored_record(void) {
+  return (const CheckpointRecord*)(XIP_BASE + CHECKPOINT_FLASH_OFFSET);
+}
+
+static inline uint32_t scratch_check(uint32_t band, uint32_t offset, uint8_t crc) {
+  return ~(CHECKPOINT_MAGIC ^ band ^ offset ^ crc);
+}
+
+static void scratch_clear(void) {
+  watchdog_hw->scratch[SCRATCH_MAGIC] = 0;
+  watchdog_hw->scratch[SCRATCH_CHECK] = 0;
+}
+
+/**
+ * Program record pages
+ * Called once per job; like flash_spool, erase and program keep the
+ * RAM-resident handlers in SPOOL_ERASE_KEEP_IRQS live.
+ */
+static void write_record(bool erase) {
+  uint32_t enabled = *(io_rw_32*)(PPB_BASE + M0PLUS_NVIC_ISER_OFFSET);
+  uint32_t masked = enabled & ~(uint32_t)SPOOL_ERASE_KEEP_IRQS;
+  irq_set_mask_enabled(masked, false);
+
+  if (erase) {
+    flash_range_erase(CHECKPOINT_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+  }
+  flash_range_program(CHECKPOINT_FLASH_OFFSET, record_buf, sizeof(record_buf));
+
+  irq_set_mask_enabled(masked, true);
+}
+
+bool checkpoint_begin(const uint8_t* frame, int frame_len) {
+  if (frame_len <= 0 || frame_len > UART_BUFFER_SIZE) {
+    return false;
+  }
+
+  memset(record_buf, 0xFF, sizeof(record_buf));
+  CheckpointRecord* record = (CheckpointRecord*)record_buf;
+  record->magic = CHECKPOINT_MAGIC;
+  record->frame_len = (uint16_t)frame_len;
+  record->crc = crc8(frame, frame_len);
+  record->state = CHECKPOINT_ACTIVE;
+  memcpy(record->frame, frame, (size_t)frame_len);
+
+  write_record(true);
+  checkpoint_band(0, 0);
+  return true;
+}
+
+void checkpoint_band(uint32_t band, uint32_t spool_offset) {
+  uint8_t crc = stored_record()->crc;
+  watchdog_hw->scratch[SCRATCH_BAND] = band;
+  watchdog_hw->scratch[SCRATCH_OFFSET] = spool_offset;
+  watchdog_hw->scratch[SCRATCH_CHECK] = scratch_check(band, spool_offset, crc);
+  watchdog_hw->scratch[SCRATCH_MAGIC] = CHECKPOINT_MAGIC;
+}
+
+void checkpoint_end(void) {
+  scratch_clear();
+
+  const CheckpointRecord* stored = stored_record();
+  if (stored->magic != CHECKPOINT_MAGIC || stored->state == CHECKPOINT_DONE) {
+    return;
+  }
+
+  // Clear the state byte in place; 0xFF bytes leave the rest untouched
+  memset(record_buf, 0xFF, sizeof(record_buf));
+  ((CheckpointRecord*)record_buf)->state = CHECKPOINT_DONE;
+  write_record(false);
+}
+
+bool checkpoint_restore(JobCheckpoint* checkpoint) {
+  const CheckpointRecord* stored = stored_record();
+  if (stored->magic != CHECKPOINT_MAGIC ||
+      stored->state != CHECKPOINT_ACTIVE ||
+      stored->frame_len == 0 ||
+      stored->frame_len > UART_BUFFER_SIZE ||
+      stored->crc != crc8(stored->frame, stored->frame_len)) {
+    scratch_clear();
+    return false;
+  }
+
+  // Counted before the job runs again, so a reset during it still counts
+  uint8_t attempts = stored->attempts & (uint8_t)(stored->attempts - 1);
+  memset(record_buf, 0xFF, sizeof(record_buf));
+  ((CheckpointRecord*)record_buf)->attempts = attempts;
+  write_record(false);
+  checkpoint->attempts = 8 - __builtin_popcount(attempts);
+
+  memcpy(checkpoint->frame, stored->frame, stored->frame_len);
+  checkpoint->frame_len = stored->frame_len;
+  checkpoint->band = 0;
+  checkpoint->spool_offset = 0;
+  checkpoint->warm = false;
+
+  // Band progress is only trusted if it belongs to this record
+  uint32_t band = watchdog_hw->scratch[SCRATCH_BAND];
+  uint32_t offset = watchdog_hw->scratch[SCRATCH_OFFSET];
+  if (watchdog_hw->scratch[SCRATCH_MAGIC] == CHECKPOINT_MAGIC &&
+      watchdog_hw->scratch[SCRATCH_CHECK] == scratch_check(band, offset, stored->crc)) {
+    checkpoint->band = band;
+    checkpoint->spool_offset = offset;
+    checkpoint->warm = true;
+  }
+
+  return true;
+}
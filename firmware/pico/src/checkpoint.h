@@ -0,0 +1,59 @@
+/**
+ * Printosk Pico - Job Checkpoints
+ * Warm-restart state for the active print job
+ *
+ * Two layers:
+ * - Flash: the job's command frame, written once when the job starts, so
+ *   the job can be re-run after any reset without asking the ESP32 again.
+ *   Completion clears a flag in place (no erase).
+ * - Watchdog scratch registers: the last completed band and spool offset,
+ *   updated after every band at no flash cost. They survive a watchdog or
+ *   soft reset but not a power cycle, in which case the job restarts from
+ *   band 0.
+ * Every restore is counted in the flash record, so the caller can give up
+ * on a job that resets the Pico each time it runs.
+ */
+
+#ifndef PICO_CHECKPOINT_H
+#define PICO_CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"
+#include "config.h"
+
+// One sector directly below the flash spool region
+#define CHECKPOINT_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - SPOOL_FLASH_SIZE - FLASH_SECTOR_SIZE)
+
+// Restored job state
+typedef struct {
+  uint8_t frame[UART_BUFFER_SIZE];  // Original command frame
+  int frame_len;
+  uint32_t band;                    // Bands completed before the reset
+  uint32_t spool_offset;            // Spool bytes consumed by those bands
+  bool warm;                        // Progress came from scratch registers
+  int attempts;                     // Restores of this job, this one included
+} JobCheckpoint;
+
+/**
+ * Record a new active job (erases and programs the checkpoint sector)
+ */
+bool checkpoint_begin(const uint8_t* frame, int frame_len);
+
+/**
+ * Record a completed band (scratch registers only)
+ */
+void checkpoint_band(uint32_t band, uint32_t spool_offset);
+
+/**
+ * Mark the active job finished (printed, failed or cancelled)
+ */
+void checkpoint_end(void);
+
+/**
+ * Load an unfinished job left by the previous boot and count the attempt
+ * Returns false if the last job finished or no record exists.
+ */
+bool checkpoint_restore(JobCheckpoint* checkpoint);
+
+#endif // PICO_CHECKPOINT_H
@@ -15,6 +15,18 @@
 #define UART_TX_PIN 0        // GPIO 0
 #define UART_RX_PIN 1        // GPIO 1
 #define UART_BUFFER_SIZE 512
+#define UART_RX_RING_SIZE 1024        // IRQ -> main loop ring (power of two)
+#define UART_INTERBYTE_TIMEOUT_MS 10  // Abandon a frame after this much silence
+
+// SPI bulk link from ESP32 (Pico is slave; ESP32 clocks at up to clk_peri/12)
+#define SPI_LINK_ID spi0
+#define SPI_LINK_BAUD 10000000        // Slave ignores it; documents the ESP32 clock
+#define SPI_LINK_RX_PIN 16            // GPIO 16 (MOSI)
+#define SPI_LINK_CS_PIN 17            // GPIO 17
+#define SPI_LINK_SCK_PIN 18           // GPIO 18
+#define SPI_LINK_TX_PIN 19            // GPIO 19 (MISO, unused)
+#define SPI_LINK_READY_PIN 22         // GPIO 22: high while a block buffer is armed
+#define SPI_LINK_BLOCK_SIZE 4096      // One frame per block, zero padded
 
 // USB (for printer)
 // Uses default USB on Pico (pins 1-2 for D+/D-)
@@ -37,6 +49,13 @@
 #define CMD_TYPE_PING 0x01
 #define CMD_TYPE_PRINT 0x10
 #define CMD_TYPE_CANCEL 0x11
+#define CMD_TYPE_STATUS 0x20
+
+// Bulk data (SPI link; UART accepts them too as a fallback)
+#define CMD_TYPE_DATA_BEGIN 0x40  // Payload: job id; opens a flash spool job
+#define CMD_TYPE_DATA 0x41        // Payload: job stream bytes
+#define CMD_TYPE_DATA_END 0x42    // Closes the spool job
+#define CMD_TYPE_BENCH 0x43       // Payload counted and discarded; empty frame ends run
 
 // Status codes
 #define CMD_STATUS_READY 0x00
@@ -44,6 +63,8 @@
 #define CMD_STATUS_PRINTING 0x02
 #define CMD_STATUS_DONE 0x03
 #define CMD_STATUS_ERROR 0x04
+#define CMD_STATUS_CANCELLED 0x05
+#define CMD_STATUS_RESUMING 0x06
 
 // ============================================================================
 // PRINTER SETTINGS
@@ -54,9 +75,27 @@
 #define PRINTER_VID 0x04B8  // Epson (example)
 #define PRINTER_PID 0x0005  // Specific model (example)
 
+// Heartbeat to ESP32 (ms)
+#define HEARTBEAT_INTERVAL_MS 5000
+
+// Watchdog: must outlast the heartbeat, the longest idle __wfe() sleep
+#define WATCHDOG_TIMEOUT_MS 8000
+
 // Print timeout (ms)
 #define PRINT_TIMEOUT_MS 300000  // 5 minutes
 
+// PRINT may arrive before its DATA_END; wait this long for the upload
+#define JOB_DATA_TIMEOUT_MS 30000
+
+// An upload with no DATA frame for this long is discarded from the spool
+#define SPOOL_RECEIVE_TIMEOUT_MS 10000
+
+// Jobs spooled before a reset are dropped if no PRINT comes this long after boot
+#define SPOOL_ORPHAN_EXPIRE_MS 600000  // 10 minutes
+
+// A job that keeps resetting the Pico is dropped after this many resumes
+#define RESUME_MAX_ATTEMPTS 3
+
 // Page conversion
 #define MAX_PAGES_PER_JOB 1000
 #define MOCK_PRINT_TIME_PER_PAGE 100  // ms per page in mock mode
@@ -66,16 +105,29 @@
 // ============================================================================
 
 // Fixed buffers (no malloc after init)
-#define PRINT_BUFFER_SIZE 65536      // 64 KB for print spool
+#define PRINT_BUFFER_SIZE 8192       // Band buffers between flash spool and printer
 #define UART_COMMAND_BUFFER 512
 #define PRINTER_RESPONSE_BUFFER 256
 
+// Spool block pool (carved from PRINT_BUFFER_SIZE)
+#define SPOOL_BLOCK_SIZE 1024
+#define SPOOL_BLOCK_COUNT (PRINT_BUFFER_SIZE / SPOOL_BLOCK_SIZE)
+
+// Flash spool (log-structured region at the top of QSPI flash)
+#define SPOOL_FLASH_SIZE (1024 * 1024)   // Upper 1 MB of 2 MB flash
+#define SPOOL_ERASE_AHEAD_SECTORS 4      // 16 KB kept erased ahead of writes
+#define SPOOL_ERASE_KEEP_IRQS (1u << 11)  // DMA_IRQ_0 (SPI link): handler and callees run from RAM
+#define SPOOL_MAX_JOBS 16
+
 // ============================================================================
 // FEATURE FLAGS
 // ============================================================================
 
 #define FEATURE_MOCK_PRINTER 0       // Simulate printer for testing
-#define FEATURE_SPOOL_TO_STORAGE 0   // Save print jobs to flash
+#define FEATURE_SPOOL_TO_STORAGE 1   // Save print jobs to flash
+#define ENABLE_SPOOL_BENCHMARK 0     // Measure flash spool write MB/s at boot
 #define FEATURE_DETAILED_STATUS 1    // Send progress updates
+#define FEATURE_FAST_BOOT 1          // No startup delay; flash spool scan on core 1
+#define FEATURE_SPI_LINK 1           // SPI slave for bulk data from ESP32
 
 #endif // PICO_CONFIG_H
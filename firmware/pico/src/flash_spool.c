@@ -0,0 +1,489 @@
+/**
+ * Printosk Pico - Flash Spool
+ */
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/regs/addressmap.h"
+#include "hardware/regs/m0plus.h"
+#include "flash_spool.h"
+#include "utils.h"
+
+#if FEATURE_SPOOL_TO_STORAGE
+
+// ============================================================================
+// PAGE HELPERS
+// ============================================================================
+
+static inline uint32_t page_flash_offset(uint32_t page) {
+  return SPOOL_FLASH_OFFSET + (page % SPOOL_PAGE_COUNT) * SPOOL_PAGE_SIZE;
+}
+
+static inline const SpoolPageHeader* page_header(uint32_t page) {
+  return (const SpoolPageHeader*)(XIP_BASE + page_flash_offset(page));
+}
+
+static inline const uint8_t* page_payload(uint32_t page) {
+  return (const uint8_t*)page_header(page) + sizeof(SpoolPageHeader);
+}
+
+/**
+ * Mask IRQs for a flash operation
+ * Handlers listed in SPOOL_ERASE_KEEP_IRQS run entirely from RAM and stay
+ * live (SPI link DMA), so erases and page programs never stall them.
+ * Everything else, UART RX included, waits until the operation is done.
+ */
+static inline uint32_t flash_irqs_mask(void) {
+  uint32_t enabled = *(io_rw_32*)(PPB_BASE + M0PLUS_NVIC_ISER_OFFSET);
+  uint32_t masked = enabled & ~(uint32_t)SPOOL_ERASE_KEEP_IRQS;
+  irq_set_mask_enabled(masked, false);
+  return masked;
+}
+
+static inline void flash_irqs_restore(uint32_t masked) {
+  irq_set_mask_enabled(masked, true);
+}
+
+static uint8_t page_crc(const SpoolPageHeader* header, const uint8_t* payload) {
+  uint8_t buf[7];
+  buf[0] = header->type;
+  memcpy(&buf[1], &header->seq, 4);
+  memcpy(&buf[5], &header->len, 2);
+  return crc8(buf, sizeof(buf)) ^ crc8(payload, header->len);
+}
+
+/**
+ * Page holds a valid record for absolute page number `page`
+ */
+static bool page_valid(uint32_t page) {
+  const SpoolPageHeader* header = page_header(page);
+  return header->magic == SPOOL_PAGE_MAGIC &&
+         header->seq == page &&
+         header->len <= SPOOL_PAGE_PAYLOAD &&
+         header->crc == page_crc(header, page_payload(page));
+}
+
+static bool pages_blank(uint32_t first, uint32_t end) {
+  for (uint32_t page = first; page < end; page++) {
+    const uint32_t* words = (const uint32_t*)page_header(page);
+    for (uint32_t i = 0; i < SPOOL_PAGE_SIZE / 4; i++) {
+      if (words[i] != 0xFFFFFFFF) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+static inline uint32_t sector_align_up(uint32_t page) {
+  return (page + SPOOL_PAGES_PER_SECTOR - 1) / SPOOL_PAGES_PER_SECTOR * SPOOL_PAGES_PER_SECTOR;
+}
+
+/**
+ * Program one page (buffer holds header space + payload)
+ * Page programs take well under a millisecond, so all IRQs are masked.
+ */
+static bool program_page(FlashSpool* spool, uint8_t* page_buf, uint8_t type, uint16_t len) {
+  if (spool->head_page >= spool->erased_page) {
+    spool->write_stalls++;
+    return false;
+  }
+
+  SpoolPageHeader* header = (SpoolPageHeader*)page_buf;
+  header->magic = SPOOL_PAGE_MAGIC;
+  header->type = type;
+  header->flags = 0xFF;
+  header->seq = spool->head_page;
+  header->len = len;
+  header->reserved = 0xFF;
+  uint8_t* payload = page_buf + sizeof(SpoolPageHeader);
+  memset(payload + len, 0xFF, SPOOL_PAGE_PAYLOAD - len);
+  header->crc = page_crc(header, payload);
+
+  uint32_t masked = flash_irqs_mask();
+  flash_range_program(page_flash_offset(spool->head_page), page_buf, SPOOL_PAGE_SIZE);
+  flash_irqs_restore(masked);
+
+  spool->head_page++;
+  return true;
+}
+
+/**
+ * Erase one sector (tens of milliseconds; kept IRQs stay live)
+ */
+static void erase_sector(uint32_t page) {
+  uint32_t masked = flash_irqs_mask();
+  flash_range_erase(page_flash_offset(page), FLASH_SECTOR_SIZE);
+  flash_irqs_restore(masked);
+}
+
+// ============================================================================
+// JOB INDEX
+// ============================================================================
+
+static inline int job_slot(FlashSpool* spool, int n) {
+  return (spool->job_first + n) % SPOOL_MAX_JOBS;
+}
+
+/**
+ * Drop drained jobs from the front of the index and move the tail
+ */
+static void update_tail(FlashSpool* spool) {
+  while (spool->job_count > 0 && spool->jobs[spool->job_first].state == SPOOL_JOB_DRAINED) {
+    spool->job_first = (spool->job_first + 1) % SPOOL_MAX_JOBS;
+    spool->job_count--;
+  }
+  spool->tail_page = spool->job_count > 0
+    ? spool->jobs[spool->job_first].begin_page
+    : spool->head_page;
+}
+
+static SpoolJob* add_job(FlashSpool* spool, uint32_t begin_page, const char* job_id) {
+  if (spool->job_count == SPOOL_MAX_JOBS) {
+    update_tail(spool);
+    if (spool->job_count == SPOOL_MAX_JOBS) {
+      return NULL;
+    }
+  }
+
+  int slot = job_slot(spool, spool->job_count++);
+  SpoolJob* job = &spool->jobs[slot];
+  safe_strncpy(job->job_id, job_id, sizeof(job->job_id));
+  job->begin_page = begin_page;
+  job->end_page = begin_page;
+  job->bytes = 0;
+  job->state = SPOOL_JOB_RECEIVING;
+  spool->receiving = slot;
+  return job;
+}
+
+/**
+ * Replay the log from oldest to newest page
+ */
+static void rebuild_index(FlashSpool* spool) {
+  uint32_t first = spool->head_page > SPOOL_PAGE_COUNT ? spool->head_page - SPOOL_PAGE_COUNT : 0;
+  SpoolJob* job = NULL;
+  bool drained = false;
+
+  for (uint32_t page = first; page < spool->head_page; page++) {
+    if (!page_valid(page)) {
+      continue;
+    }
+    const SpoolPageHeader* header = page_header(page);
+
+    switch (header->type) {
+      case SPOOL_REC_JOB_BEGIN:
+        if (job) {
+          job->state = SPOOL_JOB_DRAINED;  // Upload never finished
+        }
+        drained = (header->flags & SPOOL_FLAG_DRAINED) == 0;
+        job = add_job(spool, page, (const char*)page_payload(page));
+        break;
+
+      case SPOOL_REC_DATA:
+        if (job) {
+          job->bytes += header->len;
+        }
+        break;
+
+      case SPOOL_REC_JOB_END:
+        if (job) {
+          job->end_page = page;
+          job->state = drained ? SPOOL_JOB_DRAINED : SPOOL_JOB_COMPLETE;
+          job = NULL;
+        }
+        break;
+    }
+  }
+
+  // A job cut off by power loss can't be printed; discard it
+  if (job) {
+    job->state = SPOOL_JOB_DRAINED;
+  }
+  spool->receiving = -1;
+}
+
+// ============================================================================
+// PUBLIC API
+// ============================================================================
+
+bool flash_spool_init(FlashSpool* spool) {
+  memset(spool, 0, sizeof(*spool));
+  spool->receiving = -1;
+
+  // Head = one past the highest valid sequence number
+  bool found = false;
+  uint32_t max_seq = 0;
+  for (uint32_t slot = 0; slot < SPOOL_PAGE_COUNT; slot++) {
+    const SpoolPageHeader* header = page_header(slot);
+    if (header->magic != SPOOL_PAGE_MAGIC || header->seq % SPOOL_PAGE_COUNT != slot) {
+      continue;
+    }
+    if (page_valid(header->seq) && (!found || header->seq > max_seq)) {
+      max_seq = header->seq;
+      found = true;
+    }
+  }
+  spool->head_page = found ? max_seq + 1 : 0;
+
+  rebuild_index(spool);
+
+  // Rest of the head sector is reusable only if blank (a torn page may sit at head)
+  uint32_t sector_end = sector_align_up(spool->head_page);
+  if (!pages_blank(spool->head_page, sector_end)) {
+    spool->head_page = sector_end;
+  }
+  spool->erased_page = pages_blank(spool->head_page, sector_end) ? sector_end : spool->head_page;
+
+  update_tail(spool);
+
+  // Count sectors that are already erased ahead of the head
+  while (spool->erased_page - spool->head_page < SPOOL_ERASE_AHEAD_SECTORS * SPOOL_PAGES_PER_SECTOR &&
+         spool->erased_page + SPOOL_PAGES_PER_SECTOR <= spool->tail_page + SPOOL_PAGE_COUNT &&
+         pages_blank(spool->erased_page, spool->erased_page + SPOOL_PAGES_PER_SECTOR)) {
+    spool->erased_page += SPOOL_PAGES_PER_SECTOR;
+  }
+
+  log_info("Flash spool: %u KB at 0x%06x, head=%lu tail=%lu, %d job(s) indexed\n",
+    SPOOL_FLASH_SIZE / 1024,
+    SPOOL_FLASH_OFFSET,
+    (unsigned long)spool->head_page,
+    (unsigned long)spool->tail_page,
+    spool->job_count);
+  return true;
+}
+
+bool flash_spool_poll(FlashSpool* spool) {
+  // Enough erased runway already
+  if (spool->erased_page - spool->head_page >= SPOOL_ERASE_AHEAD_SECTORS * SPOOL_PAGES_PER_SECTOR) {
+    return false;
+  }
+  // Next sector still holds undrained jobs
+  if (spool->erased_page + SPOOL_PAGES_PER_SECTOR > spool->tail_page + SPOOL_PAGE_COUNT) {
+    return false;
+  }
+
+  erase_sector(spool->erased_page);
+  spool->erased_page += SPOOL_PAGES_PER_SECTOR;
+  spool->sectors_erased++;
+  return true;
+}
+
+bool flash_spool_job_begin(FlashSpool* spool, const char* job_id) {
+  if (spool->receiving >= 0) {
+    log_error("Flash spool: job %s still receiving\n", spool->jobs[spool->receiving].job_id);
+    return false;
+  }
+
+  uint8_t page[SPOOL_PAGE_SIZE];
+  uint16_t len = (uint16_t)safe_strlen(job_id, 36) + 1;
+  memcpy(page + sizeof(SpoolPageHeader), job_id, len - 1);
+  page[sizeof(SpoolPageHeader) + len - 1] = '\0';
+
+  uint32_t begin_page = spool->head_page;
+  if (!program_page(spool, page, SPOOL_REC_JOB_BEGIN, len)) {
+    return false;
+  }
+  if (!add_job(spool, begin_page, job_id)) {
+    log_error("Flash spool: job index full\n");
+    return false;
+  }
+
+  spool->page_fill = 0;
+  return true;
+}
+
+uint32_t flash_spool_write(FlashSpool* spool, const uint8_t* data, uint32_t len) {
+  if (spool->receiving < 0) {
+    return 0;
+  }
+
+  SpoolJob* job = &spool->jobs[spool->receiving];
+  uint8_t* payload = spool->page_buf + sizeof(SpoolPageHeader);
+  uint32_t done = 0;
+
+  while (done < len) {
+    if (spool->page_fill == SPOOL_PAGE_PAYLOAD) {
+      if (!program_page(spool, spool->page_buf, SPOOL_REC_DATA, SPOOL_PAGE_PAYLOAD)) {
+        break;  // Out of erased pages; bytes stay buffered
+      }
+      job->bytes += SPOOL_PAGE_PAYLOAD;
+      spool->page_fill = 0;
+    }
+
+    uint32_t n = SPOOL_PAGE_PAYLOAD - spool->page_fill;
+    if (n > len - done) {
+      n = len - done;
+    }
+    memcpy(payload + spool->page_fill, data + done, n);
+    spool->page_fill += n;
+    done += n;
+  }
+
+  return done;
+}
+
+bool flash_spool_job_end(FlashSpool* spool) {
+  if (spool->receiving < 0) {
+    return false;
+  }
+  SpoolJob* job = &spool->jobs[spool->receiving];
+
+  if (spool->page_fill > 0) {
+    if (!program_page(spool, spool->page_buf, SPOOL_REC_DATA, spool->page_fill)) {
+      return false;
+    }
+    job->bytes += spool->page_fill;
+    spool->page_fill = 0;
+  }
+
+  uint8_t page[SPOOL_PAGE_SIZE];
+  memcpy(page + sizeof(SpoolPageHeader), &job->bytes, sizeof(job->bytes));
+
+  uint32_t end_page = spool->head_page;
+  if (!program_page(spool, page, SPOOL_REC_JOB_END, sizeof(job->bytes))) {
+    return false;
+  }
+
+  job->end_page = end_page;
+  job->state = SPOOL_JOB_COMPLETE;
+  spool->receiving = -1;
+  return true;
+}
+
+bool flash_spool_job_abort(FlashSpool* spool) {
+  if (spool->receiving < 0) {
+    return false;
+  }
+
+  spool->jobs[spool->receiving].state = SPOOL_JOB_DRAINED;
+  spool->receiving = -1;
+  spool->page_fill = 0;
+  update_tail(spool);
+  return true;
+}
+
+int flash_spool_next_pending(FlashSpool* spool) {
+  for (int n = 0; n < spool->job_count; n++) {
+    int slot = job_slot(spool, n);
+    if (spool->jobs[slot].state == SPOOL_JOB_COMPLETE) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+int flash_spool_find(FlashSpool* spool, const char* job_id) {
+  // Newest first: a re-uploaded job supersedes an older copy
+  for (int n = spool->job_count - 1; n >= 0; n--) {
+    int slot = job_slot(spool, n);
+    if (spool->jobs[slot].state == SPOOL_JOB_COMPLETE &&
+        strncmp(spool->jobs[slot].job_id, job_id, sizeof(spool->jobs[slot].job_id)) == 0) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+const SpoolJob* flash_spool_job(FlashSpool* spool, int index) {
+  if (index < 0 || index >= SPOOL_MAX_JOBS) {
+    return NULL;
+  }
+  return &spool->jobs[index];
+}
+
+bool flash_spool_open(FlashSpool* spool, int index, SpoolReader* reader) {
+  const SpoolJob* job = flash_spool_job(spool, index);
+  if (!job || job->state != SPOOL_JOB_COMPLETE) {
+    return false;
+  }
+
+  reader->page = job->begin_page + 1;
+  reader->end_page = job->end_page;
+  reader->offset = 0;
+  return true;
+}
+
+const uint8_t* flash_spool_read_next(FlashSpool* spool, SpoolReader* reader, uint16_t* len) {
+  (void)spool;
+
+  while (reader->page < reader->end_page) {
+    uint32_t page = reader->page++;
+    if (page_valid(page) && page_header(page)->type == SPOOL_REC_DATA) {
+      *len = page_header(page)->len;
+      reader->offset += *len;
+      return page_payload(page);
+    }
+  }
+
+  *len = 0;
+  return NULL;
+}
+
+bool flash_spool_job_drained(FlashSpool* spool, int index) {
+  if (index < 0 || index >= SPOOL_MAX_JOBS || spool->jobs[index].state != SPOOL_JOB_COMPLETE) {
+    return false;
+  }
+  SpoolJob* job = &spool->jobs[index];
+
+  // Clear the DRAINED bit in place; 0xFF bytes leave the rest of the page untouched
+  uint8_t page[SPOOL_PAGE_SIZE];
+  memset(page, 0xFF, sizeof(page));
+  ((SpoolPageHeader*)page)->flags = (uint8_t)~SPOOL_FLAG_DRAINED;
+
+  uint32_t masked = flash_irqs_mask();
+  flash_range_program(page_flash_offset(job->begin_page), page, SPOOL_PAGE_SIZE);
+  flash_irqs_restore(masked);
+
+  job->state = SPOOL_JOB_DRAINED;
+  update_tail(spool);
+  return true;
+}
+
+uint32_t flash_spool_benchmark(FlashSpool* spool, uint32_t bytes) {
+  static uint8_t chunk[SPOOL_PAGE_PAYLOAD];
+  for (uint32_t i = 0; i < sizeof(chunk); i++) {
+    chunk[i] = (uint8_t)i;
+  }
+
+  if (!flash_spool_job_begin(spool, "BENCHMARK")) {
+    return 0;
+  }
+  int index = spool->receiving;
+  uint32_t erased_before = spool->sectors_erased;
+
+  // Sustained rate: erases are paid for whenever the runway runs out
+  uint64_t start_us = time_us_64();
+  uint32_t written = 0;
+  while (written < bytes) {
+    uint32_t n = bytes - written < sizeof(chunk) ? bytes - written : sizeof(chunk);
+    uint32_t done = flash_spool_write(spool, chunk, n);
+    written += done;
+    if (done < n && !flash_spool_poll(spool)) {
+      log_warn("Flash spool benchmark: log full after %lu bytes\n", (unsigned long)written);
+      break;
+    }
+  }
+  while (!flash_spool_job_end(spool)) {
+    if (!flash_spool_poll(spool)) {
+      break;
+    }
+  }
+  uint64_t elapsed_us = time_us_64() - start_us;
+
+  flash_spool_job_drained(spool, index);
+
+  uint32_t kb_per_s = elapsed_us ? (uint32_t)((uint64_t)written * 1000000 / 1024 / elapsed_us) : 0;
+  log_info("Flash spool benchmark: %lu bytes in %lu us, %lu sector erases, %lu.%02lu MB/s\n",
+    (unsigned long)written,
+    (unsigned long)elapsed_us,
+    (unsigned long)(spool->sectors_erased - erased_before),
+    (unsigned long)(kb_per_s / 1024),
+    (unsigned long)(kb_per_s % 1024) * 100 / 1024);
+  return kb_per_s;
+}
+
+#endif // FEATURE_SPOOL_TO_STORAGE
@@ -0,0 +1,165 @@
+/**
+ * Printosk Pico - Flash Spool
+ * Log-structured job spool in the upper region of QSPI flash
+ *
+ * Layout:
+ * - The region is a circular log of 256-byte pages. Every page carries a
+ *   header with a monotonic sequence number, so the log head is found
+ *   after power-up by scanning for the highest valid sequence.
+ * - A job is JOB_BEGIN (job id) + DATA pages + JOB_END (byte count).
+ * - Drained jobs are marked by clearing a flag bit in the JOB_BEGIN page
+ *   in place (NOR flash allows 1 -> 0 without erasing).
+ *
+ * Wear levelling falls out of the circular log: every sector is erased
+ * once per lap. Sectors are erased ahead of the write head from
+ * flash_spool_poll(), never from the write path, so appends only ever
+ * program pre-erased pages (or report "full" and let the link back off).
+ */
+
+#ifndef PICO_FLASH_SPOOL_H
+#define PICO_FLASH_SPOOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/flash.h"
+#include "config.h"
+
+// Page geometry
+#define SPOOL_PAGE_SIZE FLASH_PAGE_SIZE                        // 256
+#define SPOOL_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define SPOOL_PAGE_COUNT (SPOOL_FLASH_SIZE / FLASH_PAGE_SIZE)
+#define SPOOL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - SPOOL_FLASH_SIZE)
+
+// Record types
+#define SPOOL_REC_JOB_BEGIN 0x01
+#define SPOOL_REC_DATA 0x02
+#define SPOOL_REC_JOB_END 0x03
+
+// Record flags (cleared in place)
+#define SPOOL_FLAG_DRAINED 0x01
+
+// Page header (payload follows)
+typedef struct {
+  uint16_t magic;          // SPOOL_PAGE_MAGIC
+  uint8_t type;            // SPOOL_REC_*
+  uint8_t flags;           // 0xFF when written; bits cleared later
+  uint32_t seq;            // Absolute page number (monotonic)
+  uint16_t len;            // Payload bytes
+  uint8_t crc;             // CRC8 over type, seq, len and payload
+  uint8_t reserved;
+} SpoolPageHeader;
+
+#define SPOOL_PAGE_MAGIC 0x5350
+#define SPOOL_PAGE_PAYLOAD (SPOOL_PAGE_SIZE - sizeof(SpoolPageHeader))
+
+// Job lifecycle in the index
+typedef enum {
+  SPOOL_JOB_RECEIVING,     // JOB_BEGIN written, still uploading
+  SPOOL_JOB_COMPLETE,      // JOB_END written, waiting for printer
+  SPOOL_JOB_DRAINED        // Printed; space reclaimable
+} SpoolJobState;
+
+// Per-job index entry (RAM, rebuilt from flash on boot)
+typedef struct {
+  char job_id[37];
+  uint32_t begin_page;     // Absolute page of JOB_BEGIN
+  uint32_t end_page;       // Absolute page of JOB_END
+  uint32_t bytes;
+  SpoolJobState state;
+} SpoolJob;
+
+// Sequential reader over one job's DATA pages
+typedef struct {
+  uint32_t page;           // Next absolute page to inspect
+  uint32_t end_page;
+  uint32_t offset;         // Payload bytes returned so far
+} SpoolReader;
+
+// Spool state
+typedef struct {
+  uint32_t head_page;      // Next absolute page to program
+  uint32_t tail_page;      // First page still holding live data
+  uint32_t erased_page;    // Pages below this (and >= head) are erased
+  SpoolJob jobs[SPOOL_MAX_JOBS];
+  int job_first;           // Oldest index entry
+  int job_count;
+  int receiving;           // Index of job being written, -1 if none
+  uint8_t page_buf[SPOOL_PAGE_SIZE];
+  uint16_t page_fill;      // Payload bytes buffered in page_buf
+  uint32_t sectors_erased; // Since boot (wear statistic)
+  uint32_t write_stalls;   // Appends refused for lack of erased pages
+} FlashSpool;
+
+/**
+ * Scan flash, rebuild job index and locate log head/tail
+ */
+bool flash_spool_init(FlashSpool* spool);
+
+/**
+ * Erase-ahead housekeeping; call from idle loop
+ * Erases at most one sector per call. Returns true if it did work.
+ */
+bool flash_spool_poll(FlashSpool* spool);
+
+/**
+ * Start a new job in the log
+ * Fails while another job is still receiving; abort that one first.
+ */
+bool flash_spool_job_begin(FlashSpool* spool, const char* job_id);
+
+/**
+ * Append job stream bytes
+ * Returns bytes accepted; less than len means the log is full or not yet
+ * erased far enough, and the caller should retry after flash_spool_poll().
+ */
+uint32_t flash_spool_write(FlashSpool* spool, const uint8_t* data, uint32_t len);
+
+/**
+ * Flush the partial page and write JOB_END
+ */
+bool flash_spool_job_end(FlashSpool* spool);
+
+/**
+ * Discard the job being received (upload restarted or stalled)
+ * Nothing is written: a JOB_BEGIN without JOB_END is skipped at boot.
+ */
+bool flash_spool_job_abort(FlashSpool* spool);
+
+/**
+ * Index of oldest complete, undrained job, or -1
+ */
+int flash_spool_next_pending(FlashSpool* spool);
+
+/**
+ * Index of the complete, undrained job with this id, or -1
+ */
+int flash_spool_find(FlashSpool* spool, const char* job_id);
+
+/**
+ * Look up index entry
+ */
+const SpoolJob* flash_spool_job(FlashSpool* spool, int index);
+
+/**
+ * Open reader on a complete job
+ */
+bool flash_spool_open(FlashSpool* spool, int index, SpoolReader* reader);
+
+/**
+ * Next chunk of job payload, read in place from XIP flash (zero copy)
+ * Returns NULL at end of job.
+ */
+const uint8_t* flash_spool_read_next(FlashSpool* spool, SpoolReader* reader, uint16_t* len);
+
+/**
+ * Mark job printed so its pages can be reclaimed
+ */
+bool flash_spool_job_drained(FlashSpool* spool, int index);
+
+/**
+ * Write a synthetic job of `bytes` and return sustained throughput in KB/s
+ * (erase-ahead included). The job is marked drained afterwards.
+ */
+uint32_t flash_spool_benchmark(FlashSpool* spool, uint32_t bytes);
+
+#endif // PICO_FLASH_SPOOL_H
@@ -0,0 +1,98 @@
+/**
+ * Printosk Pico - Per-Job Timing
+ * Milestone timestamps and cumulative blocked time for one print job,
+ * reported in the DONE/ERROR status so the backend can see where time goes.
+ *
+ * Header-only; the caller supplies the clock (time_us_32()):
+ *   job_timing_start(&timing, time_us_32());
+ *   job_timing_mark(&timing, JOB_MARK_FIRST_BAND, time_us_32());
+ *   job_timing_add_wait(&timing, JOB_WAIT_PRINTER, elapsed_us);
+ *   job_timing_format(&timing, buf, sizeof(buf));
+ *   // "T data=0.4 band=1.1 pr0=3.0 pr1=3850.2 done=4211.0
+ *   //  wait link=0.3 render=18.6 printer=4189.5 (ms)"
+ */
+
+#ifndef PICO_JOB_TIMING_H
+#define PICO_JOB_TIMING_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Milestones, in job order; all relative to command received
+typedef enum {
+  JOB_MARK_FIRST_DATA,          // First job data available
+  JOB_MARK_FIRST_BAND,          // First band rendered
+  JOB_MARK_FIRST_PRINTER_BYTE,  // First byte handed to the printer
+  JOB_MARK_LAST_PRINTER_BYTE,   // Last byte handed to the printer
+  JOB_MARK_COMPLETE,            // Printer reported completion
+  JOB_MARK_COUNT
+} JobMark;
+
+// Cumulative blocked time
+typedef enum {
+  JOB_WAIT_LINK,                // Waiting on the ESP32 / job data
+  JOB_WAIT_RENDER,              // Rendering bands
+  JOB_WAIT_PRINTER,             // Waiting on the USB printer
+  JOB_WAIT_COUNT
+} JobWait;
+
+typedef struct {
+  uint32_t start_us;            // Command received
+  uint32_t mark_us[JOB_MARK_COUNT];
+  uint32_t wait_us[JOB_WAIT_COUNT];
+  uint8_t marked;               // Bit per JobMark reached
+} JobTiming;
+
+static inline void job_timing_start(JobTiming* t, uint32_t now_us) {
+  *t = (JobTiming){ .start_us = now_us };
+}
+
+/** Record a milestone; first call wins, except LAST_PRINTER_BYTE which tracks the latest */
+static inline void job_timing_mark(JobTiming* t, JobMark mark, uint32_t now_us) {
+  if (!(t->marked & (1u << mark)) || mark == JOB_MARK_LAST_PRINTER_BYTE) {
+    t->mark_us[mark] = now_us - t->start_us;
+    t->marked |= 1u << mark;
+  }
+}
+
+static inline void job_timing_add_wait(JobTiming* t, JobWait wait, uint32_t us) {
+  t->wait_us[wait] += us;
+}
+
+/**
+ * Format "T name=ms.d ... wait link=ms.d render=ms.d printer=ms.d (ms)"
+ * Milestones not reached print as "-". Returns the string length
+ * (truncated to fit len).
+ */
+static inline int job_timing_format(const JobTiming* t, char* buf, size_t len) {
+  static const char* const mark_names[JOB_MARK_COUNT] = { "data", "band", "pr0", "pr1", "done" };
+  static const char* const wait_names[JOB_WAIT_COUNT] = { "link", "render", "printer" };
+
+  int n = snprintf(buf, len, "T");
+  for (int i = 0; i < JOB_MARK_COUNT && n >= 0 && (size_t)n < len; i++) {
+    if (t->marked & (1u << i)) {
+      n += snprintf(buf + n, len - (size_t)n, " %s=%lu.%lu", mark_names[i],
+                    (unsigned long)(t->mark_us[i] / 1000),
+                    (unsigned long)(t->mark_us[i] % 1000 / 100));
+    } else {
+      n += snprintf(buf + n, len - (size_t)n, " %s=-", mark_names[i]);
+    }
+  }
+  if (n >= 0 && (size_t)n < len) {
+    n += snprintf(buf + n, len - (size_t)n, " wait");
+  }
+  for (int i = 0; i < JOB_WAIT_COUNT && n >= 0 && (size_t)n < len; i++) {
+    n += snprintf(buf + n, len - (size_t)n, " %s=%lu.%lu", wait_names[i],
+                  (unsigned long)(t->wait_us[i] / 1000),
+                  (unsigned long)(t->wait_us[i] % 1000 / 100));
+  }
+  if (n >= 0 && (size_t)n < len) {
+    n += snprintf(buf + n, len - (size_t)n, " (ms)");
+  }
+  if (n < 0) {
+    return 0;
+  }
+  return (size_t)n < len ? n : (int)len - 1;
+}
+
+#endif // PICO_JOB_TIMING_H
@@ -12,13 +12,16 @@
  * - Raspberry Pi Pico (RP2040)
  * - USB Host capability
  * - UART0 for ESP32 communication (TX=GPIO0, RX=GPIO1, 115200 baud)
+ * - SPI0 slave for bulk data from ESP32 (GPIO16-19, READY=GPIO22)
  * - USB Data+/- for printer connection
  *
  * Architecture:
  * - Minimal dependencies (Pico SDK)
- * - Synchronous, deterministic execution
+ * - Event-driven main loop: UART RX and timer IRQs wake the core from __wfe()
+ * - Synchronous, deterministic job execution
  * - No dynamic allocation once initialized
  * - Simple state machine for print lifecycle
+ * - Watchdog supervised; an interrupted job resumes from its checkpoint
  */
 
 #include <stdio.h>
@@ -28,17 +31,76 @@
 #include "pico/cyw43_arch.h"
 #include "hardware/uart.h"
 #include "hardware/gpio.h"
+#include "hardware/sync.h"
+#include "hardware/watchdog.h"
+#include "pico/multicore.h"
 
 #include "config.h"
 #include "uart.h"
 #include "command_parser.h"
 #include "printer.h"
 #include "utils.h"
+#include "spool_pool.h"
+#include "flash_spool.h"
+#include "checkpoint.h"
+#include "spi_link.h"
+#include "job_timing.h"
+#include "boot_timeline.h"
 
 // Global state
 static PrinterController printer;
 static CommandParser parser;
+static SpoolPool spool_pool;
+#if FEATURE_SPOOL_TO_STORAGE
+static FlashSpool flash_spool;
+#endif
 static bool initialized = false;
+static boot_timeline_t boot_timeline;
+static JobTiming job_timing;  // Active job; started when its command arrives
+static int job_progress;      // Last progress reported for the active job
+static bool job_cancelled;    // CANCEL received for the active job
+static repeating_timer_t heartbeat_timer;
+static volatile bool heartbeat_due = false;
+
+// Transport throughput run (CMD_TYPE_BENCH frames)
+typedef struct {
+  bool running;
+  uint32_t start_us;
+  uint32_t bytes;
+  uint32_t frames;
+} LinkBench;
+static LinkBench link_bench;
+#if FEATURE_SPOOL_TO_STORAGE
+static uint32_t data_frame_offset;  // Bytes of a held DATA frame already spooled
+static char spool_job_id[37];       // Job being uploaded (DATA_BEGIN)
+static uint32_t spool_frame_us;     // Last DATA_BEGIN/DATA frame of that upload
+static uint32_t boot_spool_head;    // Jobs spooled below this predate the last reset
+#endif
+
+/**
+ * Heartbeat timer (alarm IRQ context): flag it and wake the main loop
+ */
+static bool heartbeat_callback(repeating_timer_t* timer) {
+  (void)timer;
+  heartbeat_due = true;
+  __sev();
+  return true;
+}
+
+#if FEATURE_SPOOL_TO_STORAGE && FEATURE_FAST_BOOT
+/**
+ * Core 1 boot helper: rebuild the flash spool index (read-only XIP scan)
+ * while core 0 brings up the printer
+ */
+static void core1_spool_scan() {
+  flash_spool_init(&flash_spool);
+  multicore_fifo_push_blocking(1);
+}
+#endif
+
+static inline void boot_mark(const char* stage) {
+  boot_timeline_mark(&boot_timeline, stage, time_us_32());
+}
 
 /**
  * Initialize Pico hardware
@@ -46,16 +108,37 @@ static bool initialized = false;
 static void init_hardware() {
   log_info("Initializing Pico hardware...\n");
 
-  // Initialize UART for ESP32 communication
-  uart_init(UART_ID, UART_BAUD_RATE);
-  gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
-  gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+  if (watchdog_caused_reboot()) {
+    log_warn("Rebooted by watchdog\n");
+  }
 
-  // Set UART parameters: 8N1
-  uart_set_hw_flow(UART_ID, false, false);
-  uart_set_format(UART_ID, 8, 1, UART_PARITY_NONE);
+  // Initialize UART for ESP32 communication (8N1, interrupt-driven RX)
+  uart_init_simple(UART_ID, UART_BAUD_RATE);
 
   log_info("UART initialized: %u baud\n", UART_BAUD_RATE);
+  boot_mark("uart");
+
+#if FEATURE_SPI_LINK
+  if (!spi_link_init()) {
+    log_error("SPI link unavailable, bulk data falls back to UART\n");
+  }
+#endif
+
+  // Initialize spool block pool (all print buffers come from here)
+  if (!spool_pool_init(&spool_pool)) {
+    log_error("Failed to initialize spool pool!\n");
+  } else {
+    log_info("Spool pool: %d x %d byte blocks\n", SPOOL_BLOCK_COUNT, SPOOL_BLOCK_SIZE);
+  }
+
+#if FEATURE_SPOOL_TO_STORAGE
+  // Rebuild flash spool index; complete jobs survive a power cycle
+#if FEATURE_FAST_BOOT
+  multicore_launch_core1(core1_spool_scan);
+#else
+  flash_spool_init(&flash_spool);
+#endif
+#endif
 
   // Initialize printer hardware
   if (!printer_init(&printer)) {
@@ -63,6 +146,26 @@ static void init_hardware() {
   } else {
     log_info("Printer initialized\n");
   }
+  boot_mark("printer");
+
+#if FEATURE_SPOOL_TO_STORAGE
+#if FEATURE_FAST_BOOT
+  multicore_fifo_pop_blocking();
+  // Park core 1 so flash erase/program never races its XIP fetches
+  multicore_reset_core1();
+#endif
+  boot_mark("flash_spool");
+#if ENABLE_SPOOL_BENCHMARK
+  flash_spool_benchmark(&flash_spool, 256 * 1024);
+#endif
+  boot_spool_head = flash_spool.head_page;
+  int pending = flash_spool_next_pending(&flash_spool);
+  if (pending >= 0) {
+    const SpoolJob* job = flash_spool_job(&flash_spool, pending);
+    log_info("Spooled job %s pending (%lu bytes), waiting for its PRINT\n", job->job_id,
+      (unsigned long)job->bytes);
+  }
+#endif
 
   initialized = true;
   log_info("Pico initialization complete\n\n");
@@ -85,14 +188,372 @@ static void send_status_response(
   strncpy(response.message, message ? message : "", sizeof(response.message) - 1);
   response.message[sizeof(response.message) - 1] = '\0';
 
+  // Remembered for STATUS queries while the job runs
+  if (status_code == CMD_STATUS_PRINTING) {
+    job_progress = progress;
+  }
+
   uart_send_response(UART_ID, &response);
 }
 
+/**
+ * Send the final DONE/ERROR status with the job's timing breakdown appended
+ */
+static void send_final_status(const char* job_id, uint8_t status_code, int progress, const char* text) {
+  char message[sizeof(((CommandResponse*)0)->message)];
+  int n = snprintf(message, sizeof(message), "%s; ", text);
+  job_timing_format(&job_timing, message + n, sizeof(message) - n);
+  log_info("Job timing: %s\n", message + n);
+  send_status_response(job_id, status_code, progress, message);
+}
+
+/**
+ * Bulk data frame handler, shared by the SPI link and the UART fallback
+ * Returns false to hold the frame (spool not erased far enough yet);
+ * only the SPI link can hold, so UART callers treat false as an error.
+ */
+static bool handle_link_frame(const uint8_t* frame, int len, const char* transport) {
+  int payload_len = frame[1] | (frame[2] << 8);
+  const uint8_t* payload = &frame[4];
+
+  if (len != payload_len + 6 || crc8(&frame[3], payload_len + 1) != frame[4 + payload_len]) {
+    log_error("%s: bad frame CRC\n", transport);
+    send_status_response("UNKNOWN", CMD_STATUS_ERROR, 0, "Frame error");
+    return true;
+  }
+
+  switch (frame[3]) {
+    case CMD_TYPE_BENCH:
+      if (payload_len > 0) {
+        if (!link_bench.running) {
+          link_bench.running = true;
+          link_bench.start_us = time_us_32();
+          link_bench.bytes = 0;
+          link_bench.frames = 0;
+        }
+        link_bench.bytes += payload_len;
+        link_bench.frames++;
+      } else if (link_bench.running) {
+        link_bench.running = false;
+        uint32_t elapsed_us = time_us_32() - link_bench.start_us;
+        uint32_t kbps = elapsed_us ? (uint32_t)((uint64_t)link_bench.bytes * 8000 / elapsed_us) : 0;
+        char message[96];
+        snprintf(message, sizeof(message), "BENCH %s %lu B %lu frames %lu us %lu kbit/s",
+          transport,
+          (unsigned long)link_bench.bytes,
+          (unsigned long)link_bench.frames,
+          (unsigned long)elapsed_us,
+          (unsigned long)kbps);
+        log_info("%s\n", message);
+        send_status_response("BENCH", CMD_STATUS_READY, 100, message);
+      }
+      return true;
+
+#if FEATURE_SPOOL_TO_STORAGE
+    case CMD_TYPE_DATA_BEGIN: {
+      int id_len = payload_len < (int)sizeof(spool_job_id) - 1 ? payload_len : (int)sizeof(spool_job_id) - 1;
+      memcpy(spool_job_id, payload, id_len);
+      spool_job_id[id_len] = '\0';
+      data_frame_offset = 0;
+      spool_frame_us = time_us_32();
+      // The ESP32 restarted an upload (e.g. after a reset): drop the old one
+      if (flash_spool_job_abort(&flash_spool)) {
+        log_warn("Spool upload replaced by %s\n", spool_job_id);
+      }
+      if (!flash_spool_job_begin(&flash_spool, spool_job_id)) {
+        send_status_response(spool_job_id, CMD_STATUS_ERROR, 0, "Spool full");
+      }
+      return true;
+    }
+
+    case CMD_TYPE_DATA:
+      spool_frame_us = time_us_32();
+      data_frame_offset += flash_spool_write(&flash_spool, payload + data_frame_offset,
+        payload_len - data_frame_offset);
+      if (data_frame_offset < (uint32_t)payload_len) {
+        return false;
+      }
+      data_frame_offset = 0;
+      return true;
+
+    case CMD_TYPE_DATA_END:
+      flash_spool_job_end(&flash_spool);
+      return true;
+#endif
+
+    default:
+      log_warn("%s: unexpected frame type 0x%02x\n", transport, frame[3]);
+      return true;
+  }
+}
+
+static inline bool is_link_frame(uint8_t type) {
+  return type >= CMD_TYPE_DATA_BEGIN && type <= CMD_TYPE_BENCH;
+}
+
+#if FEATURE_SPI_LINK
+static bool handle_spi_frame(const uint8_t* frame, int len) {
+  return handle_link_frame(frame, len, "spi");
+}
+#endif
+
+/**
+ * UART bulk fallback: the UART path cannot hold a frame, so retry against
+ * erase-ahead here
+ */
+static void handle_uart_link_frame(const uint8_t* frame, int len) {
+  while (!handle_link_frame(frame, len, "uart")) {
+#if FEATURE_SPOOL_TO_STORAGE
+    if (!flash_spool_poll(&flash_spool)) {
+      log_error("Flash spool full, dropping data\n");
+      send_status_response("UNKNOWN", CMD_STATUS_ERROR, 0, "Spool full");
+      data_frame_offset = 0;
+      break;
+    }
+#endif
+  }
+}
+
+#if FEATURE_SPOOL_TO_STORAGE
+/**
+ * Discard an upload whose frames stopped arriving (ESP32 reset or link
+ * lost mid-file), so it cannot block the spool for the next DATA_BEGIN
+ */
+static void expire_stalled_upload(void) {
+  if (flash_spool.receiving >= 0 &&
+      time_us_32() - spool_frame_us > SPOOL_RECEIVE_TIMEOUT_MS * 1000u &&
+      flash_spool_job_abort(&flash_spool)) {
+    log_warn("Spool upload %s stalled, discarded\n", spool_job_id);
+    send_status_response(spool_job_id, CMD_STATUS_ERROR, 0, "Upload timed out");
+  }
+}
+#endif
+
+/**
+ * Keep the link moving while a job runs
+ * Bulk frames (this job's upload still in flight, or the next job's) go to
+ * the flash spool, so the ESP32 is never held up by the printer. STATUS
+ * and CANCEL for the active job are answered here; a cancel takes effect
+ * at the next band boundary. Other commands are refused.
+ */
+static void service_link_during_job(const PrintCommand* cmd) {
+  static uint8_t buffer[UART_BUFFER_SIZE];
+  int len;
+
+  while ((len = uart_read_frame(UART_ID, buffer, UART_BUFFER_SIZE, UART_INTERBYTE_TIMEOUT_MS)) != 0) {
+    if (len < 0) {
+      log_error("Dropped malformed frame\n");
+      continue;
+    }
+    if (is_link_frame(buffer[3])) {
+      handle_uart_link_frame(buffer, len);
+      continue;
+    }
+
+    ParseResult result = parse_command(buffer, len);
+    if (!result.success) {
+      continue;
+    }
+
+    bool active = strcmp(result.command.job_id, cmd->job_id) == 0;
+    if (active && result.command.type == CMD_TYPE_STATUS) {
+      char status[32];
+      printer_get_status(&printer, status, sizeof(status));
+      send_status_response(cmd->job_id, CMD_STATUS_PRINTING, job_progress, status);
+    } else if (active && result.command.type == CMD_TYPE_CANCEL) {
+      log_info("Cancel requested for job %s\n", cmd->job_id);
+      job_cancelled = true;
+      printer_cancel(&printer);
+    } else {
+      log_warn("Busy with %s, refusing command for %s\n", cmd->job_id, result.command.job_id);
+      send_status_response(result.command.job_id, CMD_STATUS_ERROR, 0, "Printer busy");
+    }
+  }
+
+#if FEATURE_SPI_LINK
+  while (spi_link_poll(handle_spi_frame)) {
+  }
+#endif
+#if FEATURE_SPOOL_TO_STORAGE
+  flash_spool_poll(&flash_spool);
+  expire_stalled_upload();
+#endif
+}
+
+#if FEATURE_SPOOL_TO_STORAGE
+/**
+ * Band source: a spooled job read back from flash
+ */
+typedef struct {
+  SpoolReader reader;
+  const uint8_t* page;        // Current spool page payload (XIP flash)
+  uint16_t page_len;
+  uint16_t page_pos;          // Bytes of the page already taken
+  uint32_t offset;            // Job bytes taken so far
+} BandSource;
+
+/**
+ * Take up to len bytes from the spool, copying them to out unless NULL
+ */
+static uint32_t band_source_take(BandSource* source, uint8_t* out, uint32_t len) {
+  uint32_t done = 0;
+  while (done < len) {
+    if (source->page_pos == source->page_len) {
+      source->page = flash_spool_read_next(&flash_spool, &source->reader, &source->page_len);
+      source->page_pos = 0;
+      if (!source->page) {
+        break;
+      }
+    }
+    uint32_t n = source->page_len - source->page_pos;
+    if (n > len - done) {
+      n = len - done;
+    }
+    if (out) {
+      memcpy(out + done, source->page + source->page_pos, n);
+    }
+    source->page_pos += n;
+    done += n;
+  }
+  source->offset += done;
+  return done;
+}
+
+/**
+ * Render the next band into a pool block
+ * USB transfers read the band from SRAM, never from XIP flash: flash is
+ * unreadable while the spool programs or erases a sector for the next
+ * upload. Returns bytes rendered, 0 at the end of the job.
+ */
+static uint16_t render_band(BandSource* source, SpoolBlock* block) {
+  uint32_t start = time_us_32();
+  uint16_t len = (uint16_t)band_source_take(source, block->data, SPOOL_BLOCK_SIZE);
+  spool_block_commit(&spool_pool, block, len);
+
+  uint32_t now = time_us_32();
+  job_timing_add_wait(&job_timing, JOB_WAIT_RENDER, now - start);
+  if (len > 0) {
+    job_timing_mark(&job_timing, JOB_MARK_FIRST_BAND, now);
+  }
+  return len;
+}
+
+/**
+ * Hand one band to the printer; the transfer is the printer's blocked time
+ */
+static bool write_band(const uint8_t* data, uint16_t len) {
+  uint32_t start = time_us_32();
+  job_timing_mark(&job_timing, JOB_MARK_FIRST_PRINTER_BYTE, start);
+  bool written = printer_write(&printer, data, len);
+
+  uint32_t now = time_us_32();
+  job_timing_add_wait(&job_timing, JOB_WAIT_PRINTER, now - start);
+  job_timing_mark(&job_timing, JOB_MARK_LAST_PRINTER_BYTE, now);
+  return written;
+}
+
+/**
+ * Finish the job: printer_end() blocks until the printer drains it
+ */
+static bool finish_printer(void) {
+  uint32_t start = time_us_32();
+  bool ok = printer_end(&printer);
+  job_timing_add_wait(&job_timing, JOB_WAIT_PRINTER, time_us_32() - start);
+  return ok;
+}
+
+/**
+ * Stream a spooled job to the printer, one pool block per band
+ * Each band is rendered, written, returned to the pool and checkpointed
+ * before the next, so a restart resumes at the spool offset of the last
+ * completed band.
+ */
+static bool print_spooled_job(const PrintCommand* cmd, const PrintJob* job, int spool_index,
+                              uint32_t band, uint32_t offset) {
+  BandSource source = { 0 };
+  if (!flash_spool_open(&flash_spool, spool_index, &source.reader)) {
+    return false;
+  }
+  uint32_t job_bytes = flash_spool_job(&flash_spool, spool_index)->bytes;
+  if (band_source_take(&source, NULL, offset) < offset) {
+    log_error("Spool offset %lu past end of job\n", (unsigned long)offset);
+    return false;
+  }
+
+  if (!printer_begin(&printer, job)) {
+    return false;
+  }
+
+  int reported = -1;
+  while (true) {
+    SpoolBlock* block = spool_block_alloc(&spool_pool);
+    if (!block) {
+      log_error("Spool pool exhausted\n");
+      return false;
+    }
+
+    uint16_t len = render_band(&source, block);
+    bool written = len == 0 || write_band(block->data, len);
+    spool_block_free(&spool_pool, block);
+    if (!written) {
+      return false;
+    }
+    if (len == 0) {
+      break;
+    }
+
+    band++;
+    checkpoint_band(band, source.offset);
+    service_link_during_job(cmd);  // A CANCEL here stops the next printer_write()
+
+    // Report every tenth of the job; the rest of the range is setup/finish
+    int progress = 40 + (int)((uint64_t)source.offset * 55 / (job_bytes ? job_bytes : 1));
+    if (progress / 10 != reported / 10) {
+      char message[48];
+      snprintf(message, sizeof(message), "Band %lu (%lu/%lu bytes)",
+        (unsigned long)band,
+        (unsigned long)source.offset,
+        (unsigned long)job_bytes);
+      send_status_response(cmd->job_id, CMD_STATUS_PRINTING, progress, message);
+      reported = progress;
+    }
+  }
+
+  // A page that failed its CRC was skipped by the reader
+  if (source.offset != job_bytes) {
+    log_error("Spooled job short: %lu of %lu bytes readable\n",
+      (unsigned long)source.offset,
+      (unsigned long)job_bytes);
+    finish_printer();
+    return false;
+  }
+
+  return finish_printer();
+}
+#endif
+
+/**
+ * Close out the active job, whatever its outcome
+ * The checkpoint is cleared and the spooled data released: a retry is
+ * uploaded afresh, and a failed job must not pin the spool tail.
+ */
+static void end_job(int spool_index) {
+  checkpoint_end();
+#if FEATURE_SPOOL_TO_STORAGE
+  if (spool_index >= 0) {
+    flash_spool_job_drained(&flash_spool, spool_index);
+  }
+#else
+  (void)spool_index;
+#endif
+}
+
 /**
  * Main print job execution loop
- * Runs synchronously until job complete or error
+ * Runs synchronously until job complete or error. After a restart the
+ * spooled data resumes at resume_offset, the end of band resume_band.
  */
-static void execute_print_job(const PrintCommand* cmd) {
+static void execute_print_job(const PrintCommand* cmd, uint32_t resume_band, uint32_t resume_offset) {
   log_info("========================================\n");
   log_info("Starting print job: %s\n", cmd->job_id);
   log_info("Pages: %d, Color: %s, Copies: %d\n",
@@ -100,110 +561,270 @@ static void execute_print_job(const PrintCommand* cmd) {
     cmd->color ? "Yes" : "No",
     cmd->copies);
   log_info("========================================\n\n");
+  job_cancelled = false;
+  job_progress = 0;
 
-  // Send STARTED status
-  send_status_response(cmd->job_id, CMD_STATUS_STARTED, 0, "Print job started");
-  sleep_ms(500);
+  if (resume_band == 0) {
+    // Send STARTED status
+    send_status_response(cmd->job_id, CMD_STATUS_STARTED, 0, "Print job started");
+  }
 
   // ========================================================================
-  // STEP 1: Download file from URL (simulated or real)
+  // STEP 1: Locate the job data (uploaded over the link into the flash spool)
   // ========================================================================
-  log_info("[STEP 1/3] Downloading file from Supabase...\n");
-  if (!cmd->mock_mode) {
-    // In production: would use TLS client to download file
-    // For now: mock mode assumed
-    log_warn("File download not implemented (mock mode assumed)\n");
+  log_info("[STEP 1/3] Locating spooled job data...\n");
+  uint32_t wait_start = time_us_32();
+  int spool_index = -1;
+#if FEATURE_SPOOL_TO_STORAGE
+  // PRINT can overtake the end of its upload; keep receiving until it lands
+  spool_index = flash_spool_find(&flash_spool, cmd->job_id);
+  while (spool_index < 0 && !cmd->mock_mode && !job_cancelled &&
+         time_us_32() - wait_start < JOB_DATA_TIMEOUT_MS * 1000u) {
+    watchdog_update();
+    service_link_during_job(cmd);
+    spool_index = flash_spool_find(&flash_spool, cmd->job_id);
+    if (spool_index < 0) {
+      best_effort_wfe_or_timeout(make_timeout_time_ms(10));
+    }
   }
+#endif
+  job_timing_add_wait(&job_timing, JOB_WAIT_LINK, time_us_32() - wait_start);
 
-  send_status_response(cmd->job_id, CMD_STATUS_PRINTING, 20, "File downloaded");
-  sleep_ms(500);
+  if (job_cancelled) {
+    log_info("Print job cancelled before its data arrived\n");
+    send_final_status(cmd->job_id, CMD_STATUS_CANCELLED, 0, "Print job cancelled");
+    checkpoint_end();
+    return;
+  } else if (spool_index >= 0) {
+#if FEATURE_SPOOL_TO_STORAGE
+    log_info("Spooled: %lu bytes, resuming at %lu\n",
+      (unsigned long)flash_spool_job(&flash_spool, spool_index)->bytes,
+      (unsigned long)resume_offset);
+#endif
+  } else if (cmd->mock_mode) {
+    log_warn("No spooled data, mock job\n");
+  } else {
+    log_error("No spooled data for job %s\n", cmd->job_id);
+    send_final_status(cmd->job_id, CMD_STATUS_ERROR, 0, "Job data not spooled");
+    checkpoint_end();
+    return;
+  }
+  job_timing_mark(&job_timing, JOB_MARK_FIRST_DATA, time_us_32());
+  send_status_response(cmd->job_id, CMD_STATUS_PRINTING, 20, "Job data ready");
 
   // ========================================================================
   // STEP 2: Connect to printer via USB
   // ========================================================================
   log_info("[STEP 2/3] Connecting to printer...\n");
 
-  if (!printer_connect(&printer)) {
+  wait_start = time_us_32();
+  bool connected = printer_connect(&printer);
+  job_timing_add_wait(&job_timing, JOB_WAIT_PRINTER, time_us_32() - wait_start);
+
+  if (!connected) {
     log_error("Failed to connect to printer!\n");
-    send_status_response(cmd->job_id, CMD_STATUS_ERROR, 0, "Printer connection failed");
+    send_final_status(cmd->job_id, CMD_STATUS_ERROR, 0, "Printer connection failed");
+    end_job(spool_index);
     return;
   }
 
   log_info("Printer connected\n");
   send_status_response(cmd->job_id, CMD_STATUS_PRINTING, 40, "Connected to printer");
-  sleep_ms(500);
 
   // ========================================================================
-  // STEP 3: Send print command and wait for completion
+  // STEP 3: Stream the job to the printer and wait for completion
   // ========================================================================
-  log_info("[STEP 3/3] Sending print command...\n");
+  log_info("[STEP 3/3] Sending job to printer...\n");
 
   PrintJob job;
   job.total_pages = cmd->total_pages;
   job.color = cmd->color;
   job.copies = cmd->copies;
-  strncpy(job.job_id, cmd->job_id, sizeof(job.job_id) - 1);
+  safe_strncpy(job.job_id, cmd->job_id, sizeof(job.job_id));
+
+  // The spooled path times its own renders and printer transfers; a mock
+  // job has no bands, only the printer wait
+  bool printed;
+#if FEATURE_SPOOL_TO_STORAGE
+  if (spool_index >= 0) {
+    printed = print_spooled_job(cmd, &job, spool_index, resume_band, resume_offset);
+  } else
+#endif
+  {
+    wait_start = time_us_32();
+    printed = printer_print(&printer, &job);
+    job_timing_add_wait(&job_timing, JOB_WAIT_PRINTER, time_us_32() - wait_start);
+  }
 
-  if (!printer_print(&printer, &job)) {
+  if (!printed && job_cancelled) {
+    log_info("Print job cancelled\n");
+    send_final_status(cmd->job_id, CMD_STATUS_CANCELLED, job_progress, "Print job cancelled");
+    printer_disconnect(&printer);
+    end_job(spool_index);
+    return;
+  }
+
+  if (!printed) {
     log_error("Print job failed!\n");
-    send_status_response(cmd->job_id, CMD_STATUS_ERROR, 0, "Print job failed");
+    send_final_status(cmd->job_id, CMD_STATUS_ERROR, 0, "Print job failed");
     printer_disconnect(&printer);
+    end_job(spool_index);
     return;
   }
 
+  job_timing_mark(&job_timing, JOB_MARK_COMPLETE, time_us_32());
+  end_job(spool_index);
   log_info("Print completed successfully\n");
-  send_status_response(cmd->job_id, CMD_STATUS_DONE, 100, "Print completed successfully");
+  send_final_status(cmd->job_id, CMD_STATUS_DONE, 100, "Print completed successfully");
 
   // Disconnect printer
   printer_disconnect(&printer);
 
+  SpoolPoolStats stats;
+  spool_pool_get_stats(&spool_pool, &stats);
+  log_info("Spool: high-water %u/%u blocks, %lu alloc failures, %u%% slack\n",
+    stats.high_water,
+    stats.total_blocks,
+    (unsigned long)stats.alloc_failures,
+    stats.fragmentation_pct);
+
   log_info("\n========================================\n");
   log_info("Job complete\n");
   log_info("========================================\n\n");
 }
 
 /**
- * UART receive loop
- * Continuously monitors for commands from ESP32
+ * UART receive handler
+ * Processes every complete frame already buffered by the RX interrupt.
+ * Returns true if any frame was handled.
  */
-static void uart_receive_loop() {
+static bool uart_receive_loop() {
   static uint8_t buffer[UART_BUFFER_SIZE];
-  int bytes_read = 0;
+  bool handled = false;
+  int bytes_read;
 
-  // Wait for incoming data
-  if (uart_is_readable(UART_ID)) {
-    bytes_read = uart_read_blocking(UART_ID, buffer, UART_BUFFER_SIZE);
+  while ((bytes_read = uart_read_frame(UART_ID, buffer, UART_BUFFER_SIZE, UART_INTERBYTE_TIMEOUT_MS)) != 0) {
+    handled = true;
 
-    if (bytes_read > 0) {
-      log_debug("Received %d bytes\n", bytes_read);
+    if (bytes_read < 0) {
+      log_error("Dropped malformed frame\n");
+      send_status_response("UNKNOWN", CMD_STATUS_ERROR, 0, "Frame error");
+      continue;
+    }
 
-      // Parse command
-      ParseResult result = parse_command(buffer, bytes_read);
+    log_debug("Received %d bytes\n", bytes_read);
 
-      if (result.success) {
-        log_info("Command parsed: type=%d, job_id=%s\n",
-          result.command.type,
-          result.command.job_id);
+    // Bulk data fallback
+    if (is_link_frame(buffer[3])) {
+      handle_uart_link_frame(buffer, bytes_read);
+      continue;
+    }
 
-        // Execute print job
-        execute_print_job(&result.command);
-      } else {
-        log_error("Failed to parse command: error=%d\n", result.error);
-        send_status_response("UNKNOWN", CMD_STATUS_ERROR, 0, "Parse error");
-      }
+    // Parse command
+    ParseResult result = parse_command(buffer, bytes_read);
+
+    if (result.success && result.command.type != CMD_TYPE_PRINT) {
+      // STATUS and CANCEL only mean something while a job runs
+      send_status_response(result.command.job_id, CMD_STATUS_READY, 0, "No active job");
+    } else if (result.success) {
+      job_timing_start(&job_timing, time_us_32());
+      log_info("Command parsed: type=%d, job_id=%s\n",
+        result.command.type,
+        result.command.job_id);
+
+      // Checkpoint the command so a reset mid-job can resume it
+      checkpoint_begin(buffer, bytes_read);
+
+      // Execute print job
+      execute_print_job(&result.command, 0, 0);
+    } else {
+      log_error("Failed to parse command: error=%d\n", result.error);
+      send_status_response("UNKNOWN", CMD_STATUS_ERROR, 0, "Parse error");
     }
   }
+
+  return handled;
+}
+
+/**
+ * Resume a job interrupted by a reset
+ * The command is replayed from the flash checkpoint; after a watchdog or
+ * soft reset the scratch registers also say which bands already finished.
+ */
+static void resume_interrupted_job() {
+  static JobCheckpoint checkpoint;
+
+  if (!checkpoint_restore(&checkpoint)) {
+    return;
+  }
+
+  job_timing_start(&job_timing, time_us_32());
+  ParseResult result = parse_command(checkpoint.frame, checkpoint.frame_len);
+  if (!result.success) {
+    log_error("Checkpointed command unreadable, dropping\n");
+    checkpoint_end();
+    return;
+  }
+
+  if (checkpoint.attempts > RESUME_MAX_ATTEMPTS) {
+    log_error("Job %s reset the Pico %d times, dropping\n", result.command.job_id, RESUME_MAX_ATTEMPTS);
+    send_final_status(result.command.job_id, CMD_STATUS_ERROR, 0, "Gave up after repeated resets");
+#if FEATURE_SPOOL_TO_STORAGE
+    end_job(flash_spool_find(&flash_spool, result.command.job_id));
+#else
+    end_job(-1);
+#endif
+    return;
+  }
+
+  char message[48];
+  snprintf(message, sizeof(message), "Resuming after band %lu (%s)",
+    (unsigned long)checkpoint.band,
+    checkpoint.warm ? "warm" : "cold");
+  log_info("%s: job %s\n", message, result.command.job_id);
+  send_status_response(result.command.job_id, CMD_STATUS_RESUMING, 0, message);
+
+  execute_print_job(&result.command, checkpoint.band, checkpoint.spool_offset);
 }
 
+#if FEATURE_SPOOL_TO_STORAGE
+/**
+ * Drop jobs a previous boot left in the spool without a PRINT
+ * They are never printed unasked: the customer may have left or
+ * reprinted meanwhile. A PRINT from the ESP32 within
+ * SPOOL_ORPHAN_EXPIRE_MS of boot still finds its job; after that the
+ * leftovers are drained so they cannot pin the spool tail.
+ */
+static void expire_spooled_orphans() {
+  static bool expired = false;
+
+  if (expired || time_us_64() < SPOOL_ORPHAN_EXPIRE_MS * 1000ull) {
+    return;
+  }
+  expired = true;
+
+  // Pending jobs come out oldest first, so the orphans lead
+  int index;
+  while ((index = flash_spool_next_pending(&flash_spool)) >= 0 &&
+         flash_spool_job(&flash_spool, index)->begin_page < boot_spool_head) {
+    log_warn("Spooled job %s never got a PRINT, dropping\n", flash_spool_job(&flash_spool, index)->job_id);
+    flash_spool_job_drained(&flash_spool, index);
+  }
+}
+#endif
+
 /**
  * Main function
  */
 int main() {
   // Initialize standard I/O
   stdio_init_all();
+  boot_mark("stdio");
 
+#if !FEATURE_FAST_BOOT
   // Small delay to let serial monitor catch startup
   sleep_ms(2000);
+#endif
 
   log_info("\n\n");
   log_info("========================================\n");
@@ -213,22 +834,58 @@ int main() {
   // Initialize hardware
   init_hardware();
 
-  // Send startup message to ESP32
+  // Send startup message to ESP32; the boot timeline rides along
+  boot_mark("ready");
   CommandResponse startup_response;
   startup_response.status = CMD_STATUS_READY;
   startup_response.progress = 0;
   strcpy(startup_response.job_id, "PICO");
-  strcpy(startup_response.message, "Pico ready");
+  boot_timeline_format(&boot_timeline, startup_response.message, sizeof(startup_response.message));
+  log_info("%s\n", startup_response.message);
   uart_send_response(UART_ID, &startup_response);
 
+  // Supervise from here on; the main loop and blocking waits feed it
+  watchdog_enable(WATCHDOG_TIMEOUT_MS, true);
+
+  resume_interrupted_job();
+
+  // Heartbeats come from the SDK alarm pool instead of loop tick counting
+  add_repeating_timer_ms(HEARTBEAT_INTERVAL_MS, heartbeat_callback, NULL, &heartbeat_timer);
+
   // Main loop
   log_info("Waiting for print commands...\n\n");
 
   while (true) {
-    uart_receive_loop();
+    watchdog_update();
+
+    bool busy = uart_receive_loop();
+
+    if (heartbeat_due) {
+      heartbeat_due = false;
+      send_status_response("PICO", CMD_STATUS_READY, 0, "Heartbeat");
+    }
 
-    // Yield to prevent watchdog timeout
-    sleep_ms(100);
+#if FEATURE_SPI_LINK
+    // Bulk blocks; a held block retries after the erase-ahead below
+    while (spi_link_poll(handle_spi_frame)) {
+      busy = true;
+    }
+#endif
+
+#if FEATURE_SPOOL_TO_STORAGE
+    // Keep erased sectors ready so spool writes never wait on an erase
+    busy |= flash_spool_poll(&flash_spool);
+    expire_stalled_upload();   // Checked at least once per heartbeat wakeup
+
+    // Jobs a power cycle left in the spool wait a while for their PRINT
+    expire_spooled_orphans();
+#endif
+
+    // Sleep until the next UART byte, SPI block or timer IRQ; any IRQ since the
+    // checks above has already set the event flag, so nothing is missed
+    if (!busy && !uart_has_data(UART_ID) && !heartbeat_due) {
+      __wfe();
+    }
   }
 
   return 0;
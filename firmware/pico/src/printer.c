@@ -0,0 +1,224 @@
+/**
+ * Printosk Pico - Printer Interface
+ * Job framing and band output on top of the USB printer driver
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/watchdog.h"
+
+#include "config.h"
+#include "printer.h"
+#include "usb_printer.h"
+#include "utils.h"
+
+// USB printer class GET_PORT_STATUS bits (IEEE 1284 status lines)
+#define PORT_STATUS_NOT_ERROR 0x08
+#define PORT_STATUS_SELECTED 0x10
+#define PORT_STATUS_PAPER_EMPTY 0x20
+
+// Bulk transfers are split so one stalled chunk times out on its own; the
+// watchdog is fed per chunk and per status poll, so both timeouts must stay
+// below WATCHDOG_TIMEOUT_MS
+#define PRINTER_CHUNK_SIZE 512
+#define PRINTER_WRITE_TIMEOUT_MS 5000
+#define PRINTER_STATUS_POLL_MS 100
+
+// Sent on cancel: CAN drops the partly received line, ESC @ resets the
+// printer, ESC d 4 feeds what was printed past the cutter, GS V 1 cuts
+static const uint8_t CANCEL_FLUSH[] = { 0x18, 0x1B, 0x40, 0x1B, 0x64, 0x04, 0x1D, 0x56, 0x01 };
+
+static bool port_ready(uint8_t status) {
+  return (status & PORT_STATUS_NOT_ERROR) &&
+         (status & PORT_STATUS_SELECTED) &&
+         !(status & PORT_STATUS_PAPER_EMPTY);
+}
+
+// Stop a cancelled job at a band boundary; always returns false
+static bool flush_cancelled(PrinterController* controller) {
+  controller->printing = false;
+  log_info("Job cancelled, flushing printer\n");
+
+#if !FEATURE_MOCK_PRINTER
+  if (!usb_printer_write(controller->device_handle, CANCEL_FLUSH, sizeof(CANCEL_FLUSH), PRINTER_WRITE_TIMEOUT_MS)) {
+    log_error("USB: cancel flush failed\n");
+  }
+#endif
+  return false;
+}
+
+bool printer_init(PrinterController* controller) {
+  memset(controller, 0, sizeof(*controller));
+  controller->device_handle = -1;
+  controller->vendor_id = PRINTER_VID;
+  controller->product_id = PRINTER_PID;
+
+#if !FEATURE_MOCK_PRINTER
+  // A printer plugged in later is picked up by printer_connect()
+  if (!usb_printer_find(&controller->vendor_id, &controller->product_id)) {
+    log_warn("No USB printer found yet, expecting %04x:%04x\n", PRINTER_VID, PRINTER_PID);
+  }
+#endif
+  return true;
+}
+
+bool printer_connect(PrinterController* controller) {
+  if (controller->connected) {
+    return true;
+  }
+
+#if FEATURE_MOCK_PRINTER
+  controller->connected = true;
+  return true;
+#else
+  usb_printer_find(&controller->vendor_id, &controller->product_id);
+  if (!usb_printer_open(controller->vendor_id, controller->product_id, &controller->device_handle)) {
+    log_error("USB: cannot open printer %04x:%04x\n", controller->vendor_id, controller->product_id);
+    controller->device_handle = -1;
+    return false;
+  }
+
+  log_info("USB: Found printer (VID=%04X, PID=%04X)\n", controller->vendor_id, controller->product_id);
+  controller->connected = true;
+  return true;
+#endif
+}
+
+bool printer_begin(PrinterController* controller, const PrintJob* job) {
+  if (!controller->connected) {
+    return false;
+  }
+
+  log_info("Printer ready, starting job %s\n", job->job_id);
+  controller->printing = true;
+  controller->cancel_requested = false;
+  controller->pages_printed = 0;
+  return true;
+}
+
+bool printer_write(PrinterController* controller, const uint8_t* data, int len) {
+  if (!controller->printing) {
+    return false;
+  }
+  if (controller->cancel_requested) {
+    return flush_cancelled(controller);
+  }
+
+#if FEATURE_MOCK_PRINTER
+  (void)data;
+  (void)len;
+  return true;
+#else
+  for (int sent = 0; sent < len; ) {
+    int n = len - sent < PRINTER_CHUNK_SIZE ? len - sent : PRINTER_CHUNK_SIZE;
+    watchdog_update();
+    if (!usb_printer_write(controller->device_handle, data + sent, n, PRINTER_WRITE_TIMEOUT_MS)) {
+      log_error("USB: write failed after %d bytes\n", sent);
+      controller->printing = false;
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+#endif
+}
+
+bool printer_end(PrinterController* controller) {
+  if (!controller->printing) {
+    return false;
+  }
+  if (controller->cancel_requested) {
+    return flush_cancelled(controller);
+  }
+  controller->printing = false;
+
+#if FEATURE_MOCK_PRINTER
+  return true;
+#else
+  // The printer buffers the tail of the job; wait for it to come back ready
+  uint32_t start = to_ms_since_boot(get_absolute_time());
+  while (to_ms_since_boot(get_absolute_time()) - start < PRINT_TIMEOUT_MS) {
+    watchdog_update();
+    uint8_t status;
+    if (!usb_printer_get_status(controller->device_handle, &status)) {
+      log_error("USB: status request failed\n");
+      return false;
+    }
+    if (port_ready(status)) {
+      return true;
+    }
+    if (status & PORT_STATUS_PAPER_EMPTY) {
+      log_warn("Printer out of paper\n");
+    }
+    sleep_ms(PRINTER_STATUS_POLL_MS);
+  }
+
+  log_error("Printer did not finish within %d ms\n", PRINT_TIMEOUT_MS);
+  return false;
+#endif
+}
+
+bool printer_print(PrinterController* controller, const PrintJob* job) {
+  if (!printer_begin(controller, job)) {
+    return false;
+  }
+
+#if FEATURE_MOCK_PRINTER
+  for (int page = 1; page <= job->total_pages * job->copies; page++) {
+    log_info("Page %d/%d: Processing...\n", page, job->total_pages * job->copies);
+    watchdog_update();
+    sleep_ms(MOCK_PRINT_TIME_PER_PAGE);
+    controller->pages_printed = page;
+  }
+#endif
+
+  return printer_end(controller);
+}
+
+bool printer_get_status(PrinterController* controller, char* status, int status_len) {
+  if (!controller->connected) {
+    snprintf(status, status_len, "offline");
+    return false;
+  }
+
+#if FEATURE_MOCK_PRINTER
+  snprintf(status, status_len, controller->printing ? "printing" : "ready");
+  return true;
+#else
+  uint8_t port;
+  if (!usb_printer_get_status(controller->device_handle, &port)) {
+    snprintf(status, status_len, "offline");
+    return false;
+  }
+  if (port & PORT_STATUS_PAPER_EMPTY) {
+    snprintf(status, status_len, "out of paper");
+  } else if (!(port & PORT_STATUS_NOT_ERROR)) {
+    snprintf(status, status_len, "error");
+  } else {
+    snprintf(status, status_len, controller->printing ? "printing" : "ready");
+  }
+  return port_ready(port);
+#endif
+}
+
+bool printer_cancel(PrinterController* controller) {
+  if (!controller->printing) {
+    return false;
+  }
+  controller->cancel_requested = true;
+  return true;
+}
+
+void printer_disconnect(PrinterController* controller) {
+  if (!controller->connected) {
+    return;
+  }
+
+#if !FEATURE_MOCK_PRINTER
+  usb_printer_close(controller->device_handle);
+#endif
+  controller->device_handle = -1;
+  controller->connected = false;
+  controller->printing = false;
+}
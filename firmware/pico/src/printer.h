@@ -29,6 +29,7 @@ typedef struct {
   int device_handle;
   bool connected;
   bool printing;
+  volatile bool cancel_requested;  // Set by printer_cancel(), cleared by printer_begin()
   int pages_printed;
 } PrinterController;
 
@@ -43,9 +44,27 @@ bool printer_init(PrinterController* controller);
  */
 bool printer_connect(PrinterController* controller);
 
+/**
+ * Start a job whose data follows through printer_write()
+ */
+bool printer_begin(PrinterController* controller, const PrintJob* job);
+
+/**
+ * Send one band of job data (already in the printer's language)
+ * Blocks until the USB transfer is done. Returns false on a transfer error
+ * or, after printer_cancel(), without sending the band.
+ */
+bool printer_write(PrinterController* controller, const uint8_t* data, int len);
+
+/**
+ * Finish the job and wait for the printer to report ready again
+ */
+bool printer_end(PrinterController* controller);
+
 /**
  * Send print job to printer
- * Blocks until complete or error
+ * For jobs without spooled data (mock mode): printer_begin() + printer_end().
+ * Blocks until complete or error; feeds the watchdog while waiting
  */
 bool printer_print(PrinterController* controller, const PrintJob* job);
 
@@ -56,6 +75,10 @@ bool printer_get_status(PrinterController* controller, char* status, int status_
 
 /**
  * Cancel current print job
+ * Output stops at the next band boundary (the next printer_write() or
+ * printer_end()); the printer is then sent the flush sequence (CAN, ESC @,
+ * feed, cut) so no partial band is left queued.
+ * Returns false if no job is printing.
  */
 bool printer_cancel(PrinterController* controller);
 
@@ -0,0 +1,122 @@
+/**
+ * Printosk Pico - SPI Bulk Link
+ */
+
+#include "pico/stdlib.h"
+#include "hardware/spi.h"
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "spi_link.h"
+#include "utils.h"
+
+#if FEATURE_SPI_LINK
+
+static uint8_t blocks[2][SPI_LINK_BLOCK_SIZE];
+static volatile bool block_full[2];
+static volatile int active_block;   // Buffer DMA is filling, -1 if none armed
+static int next_read;               // Oldest unprocessed buffer
+static int dma_chan;
+static SpiLinkStats stats;
+
+// Point DMA at a free buffer and tell the master it may send
+static __force_inline void arm_block(int block) {
+  dma_channel_set_write_addr(dma_chan, blocks[block], false);
+  dma_channel_set_trans_count(dma_chan, SPI_LINK_BLOCK_SIZE, true);
+  active_block = block;
+  gpio_put(SPI_LINK_READY_PIN, 1);
+}
+
+/**
+ * Block complete: switch to the other buffer, or drop READY if it is busy
+ * Runs from RAM and stays unmasked during flash erase (SPOOL_ERASE_KEEP_IRQS),
+ * otherwise READY would stay high with no buffer armed.
+ */
+static void __not_in_flash_func(spi_link_dma_irq)(void) {
+  dma_hw->ints0 = 1u << dma_chan;
+
+  block_full[active_block] = true;
+  stats.blocks++;
+
+  int other = active_block ^ 1;
+  if (!block_full[other]) {
+    arm_block(other);
+  } else {
+    gpio_put(SPI_LINK_READY_PIN, 0);
+    active_block = -1;
+    stats.stalls++;
+  }
+  __sev();
+}
+
+bool spi_link_init(void) {
+  // Slave, mode 3: CPHA=1 lets CS stay low for a whole block
+  spi_init(SPI_LINK_ID, SPI_LINK_BAUD);
+  spi_set_slave(SPI_LINK_ID, true);
+  spi_set_format(SPI_LINK_ID, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);
+  gpio_set_function(SPI_LINK_RX_PIN, GPIO_FUNC_SPI);
+  gpio_set_function(SPI_LINK_CS_PIN, GPIO_FUNC_SPI);
+  gpio_set_function(SPI_LINK_SCK_PIN, GPIO_FUNC_SPI);
+  gpio_set_function(SPI_LINK_TX_PIN, GPIO_FUNC_SPI);
+
+  gpio_init(SPI_LINK_READY_PIN);
+  gpio_set_dir(SPI_LINK_READY_PIN, GPIO_OUT);
+  gpio_put(SPI_LINK_READY_PIN, 0);
+
+  dma_chan = dma_claim_unused_channel(false);
+  if (dma_chan < 0) {
+    log_error("SPI link: no free DMA channel\n");
+    return false;
+  }
+  dma_channel_config cfg = dma_channel_get_default_config(dma_chan);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_8);
+  channel_config_set_read_increment(&cfg, false);
+  channel_config_set_write_increment(&cfg, true);
+  channel_config_set_dreq(&cfg, spi_get_dreq(SPI_LINK_ID, false));
+  dma_channel_configure(dma_chan, &cfg, blocks[0], &spi_get_hw(SPI_LINK_ID)->dr, SPI_LINK_BLOCK_SIZE, false);
+
+  dma_channel_set_irq0_enabled(dma_chan, true);
+  irq_set_exclusive_handler(DMA_IRQ_0, spi_link_dma_irq);
+  irq_set_enabled(DMA_IRQ_0, true);
+
+  block_full[0] = block_full[1] = false;
+  next_read = 0;
+  arm_block(0);
+
+  log_info("SPI link: slave on spi%d, %d byte blocks\n", spi_get_index(SPI_LINK_ID), SPI_LINK_BLOCK_SIZE);
+  return true;
+}
+
+bool spi_link_poll(SpiLinkHandler handler) {
+  if (!block_full[next_read]) {
+    return false;
+  }
+
+  const uint8_t* block = blocks[next_read];
+  int payload_len = block[1] | (block[2] << 8);
+  int len = 4 + payload_len + 2;
+
+  if (block[0] != FRAME_START || len > SPI_LINK_BLOCK_SIZE || block[len - 1] != FRAME_END) {
+    stats.bad_frames++;
+  } else if (!handler(block, len)) {
+    return false;  // Held: READY stays low until the handler catches up
+  }
+
+  // Release the buffer; if DMA stalled on it, resume there
+  uint32_t irq = save_and_disable_interrupts();
+  block_full[next_read] = false;
+  if (active_block < 0) {
+    arm_block(next_read);
+  }
+  restore_interrupts(irq);
+
+  next_read ^= 1;
+  return true;
+}
+
+void spi_link_get_stats(SpiLinkStats* out) {
+  *out = stats;
+}
+
+#endif // FEATURE_SPI_LINK
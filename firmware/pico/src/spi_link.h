@@ -0,0 +1,49 @@
+/**
+ * Printosk Pico - SPI Bulk Link
+ * DMA-driven SPI slave carrying the same framed protocol as the UART
+ *
+ * The ESP32 is master and sends fixed-size blocks, each holding one frame
+ * padded to SPI_LINK_BLOCK_SIZE:
+ *
+ *   [0xAA][LEN_L][LEN_H][TYPE][PAYLOAD][CRC][0xBB][padding...]
+ *
+ * Flow control: the READY pin is high while a free block buffer is armed
+ * for DMA. The master waits for READY before every block (after a short
+ * guard time, so it never samples READY before the Pico has re-armed).
+ * Two buffers let one block be received while the previous is processed.
+ * A block is held, and READY stays low, until the frame handler accepts it.
+ *
+ * Bulk traffic (DATA, BENCH) uses this link; control commands stay on UART.
+ */
+
+#ifndef PICO_SPI_LINK_H
+#define PICO_SPI_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config.h"
+
+// Frame handler; return false to hold the frame and retry on the next poll
+typedef bool (*SpiLinkHandler)(const uint8_t* frame, int len);
+
+typedef struct {
+  uint32_t blocks;         // Blocks received
+  uint32_t bad_frames;     // Blocks without a valid frame
+  uint32_t stalls;         // Times both buffers were full (READY dropped)
+} SpiLinkStats;
+
+/**
+ * Configure SPI slave, DMA and READY pin, then arm the first buffer
+ */
+bool spi_link_init(void);
+
+/**
+ * Hand the oldest received frame to the handler
+ * Returns true if a block was consumed; false if none is waiting or the
+ * handler held it.
+ */
+bool spi_link_poll(SpiLinkHandler handler);
+
+void spi_link_get_stats(SpiLinkStats* stats);
+
+#endif // PICO_SPI_LINK_H
@@ -0,0 +1,146 @@
+/**
+ * Printosk Pico - Spool Block Pool
+ */
+
+#include <string.h>
+#include "spool_pool.h"
+#include "utils.h"
+
+bool spool_pool_init(SpoolPool* pool) {
+  int lock_num = spin_lock_claim_unused(false);
+  if (lock_num < 0) {
+    log_error("Spool pool: no free hardware spinlock\n");
+    return false;
+  }
+  pool->lock = spin_lock_init((uint)lock_num);
+
+  // Thread every block onto the free list
+  pool->free_list = NULL;
+  for (int i = SPOOL_BLOCK_COUNT - 1; i >= 0; i--) {
+    pool->blocks[i].next = pool->free_list;
+    pool->blocks[i].len = 0;
+    pool->blocks[i].offset = 0;
+    pool->free_list = &pool->blocks[i];
+  }
+
+  pool->free_count = SPOOL_BLOCK_COUNT;
+  pool->high_water = 0;
+  pool->alloc_failures = 0;
+  pool->payload_bytes = 0;
+  return true;
+}
+
+SpoolBlock* spool_block_alloc(SpoolPool* pool) {
+  uint32_t irq = spin_lock_blocking(pool->lock);
+
+  SpoolBlock* block = pool->free_list;
+  if (block) {
+    pool->free_list = block->next;
+    pool->free_count--;
+    uint16_t in_use = SPOOL_BLOCK_COUNT - pool->free_count;
+    if (in_use > pool->high_water) {
+      pool->high_water = in_use;
+    }
+  } else {
+    pool->alloc_failures++;
+  }
+
+  spin_unlock(pool->lock, irq);
+
+  if (block) {
+    block->next = NULL;
+    block->len = 0;
+    block->offset = 0;
+  }
+  return block;
+}
+
+void spool_block_free(SpoolPool* pool, SpoolBlock* block) {
+  if (!block) {
+    return;
+  }
+
+  uint32_t irq = spin_lock_blocking(pool->lock);
+  pool->payload_bytes -= block->len;
+  block->len = 0;
+  block->next = pool->free_list;
+  pool->free_list = block;
+  pool->free_count++;
+  spin_unlock(pool->lock, irq);
+}
+
+void spool_block_commit(SpoolPool* pool, SpoolBlock* block, uint16_t len) {
+  if (len > SPOOL_BLOCK_SIZE) {
+    len = SPOOL_BLOCK_SIZE;
+  }
+
+  uint32_t irq = spin_lock_blocking(pool->lock);
+  pool->payload_bytes += len - block->len;
+  block->len = len;
+  spin_unlock(pool->lock, irq);
+}
+
+void spool_list_init(SpoolList* list) {
+  list->head = NULL;
+  list->tail = NULL;
+  list->count = 0;
+  list->bytes = 0;
+}
+
+void spool_list_append(SpoolPool* pool, SpoolList* list, SpoolBlock* block) {
+  block->next = NULL;
+
+  uint32_t irq = spin_lock_blocking(pool->lock);
+  if (list->tail) {
+    list->tail->next = block;
+  } else {
+    list->head = block;
+  }
+  list->tail = block;
+  list->count++;
+  list->bytes += block->len;
+  spin_unlock(pool->lock, irq);
+}
+
+SpoolBlock* spool_list_pop(SpoolPool* pool, SpoolList* list) {
+  uint32_t irq = spin_lock_blocking(pool->lock);
+  SpoolBlock* block = list->head;
+  if (block) {
+    list->head = block->next;
+    if (!list->head) {
+      list->tail = NULL;
+    }
+    list->count--;
+    list->bytes -= block->len;
+  }
+  spin_unlock(pool->lock, irq);
+
+  if (block) {
+    block->next = NULL;
+  }
+  return block;
+}
+
+void spool_list_release(SpoolPool* pool, SpoolList* list) {
+  SpoolBlock* block;
+  while ((block = spool_list_pop(pool, list)) != NULL) {
+    spool_block_free(pool, block);
+  }
+}
+
+void spool_pool_get_stats(SpoolPool* pool, SpoolPoolStats* stats) {
+  uint32_t irq = spin_lock_blocking(pool->lock);
+  stats->total_blocks = SPOOL_BLOCK_COUNT;
+  stats->free_blocks = pool->free_count;
+  stats->in_use = SPOOL_BLOCK_COUNT - pool->free_count;
+  stats->high_water = pool->high_water;
+  stats->alloc_failures = pool->alloc_failures;
+  stats->payload_bytes = pool->payload_bytes;
+  spin_unlock(pool->lock, irq);
+
+  // Fixed blocks can't fragment externally; report internal slack instead
+  uint32_t capacity = (uint32_t)stats->in_use * SPOOL_BLOCK_SIZE;
+  stats->fragmentation_pct = capacity
+    ? (uint8_t)(100 - (stats->payload_bytes * 100) / capacity)
+    : 0;
+}
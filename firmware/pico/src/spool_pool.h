@@ -0,0 +1,105 @@
+/**
+ * Printosk Pico - Spool Block Pool
+ * Fixed-size block allocator backing the print spool
+ *
+ * - Static storage carved from PRINT_BUFFER_SIZE (no malloc)
+ * - O(1) alloc/free via an intrusive free list
+ * - Safe across both cores and from ISRs (hardware spinlock + IRQ mask)
+ * - Blocks chain into per-job spool lists; stages hand blocks over by
+ *   moving them between lists, never by copying payload
+ */
+
+#ifndef PICO_SPOOL_POOL_H
+#define PICO_SPOOL_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/sync.h"
+#include "config.h"
+
+// Spool block (header + payload)
+typedef struct SpoolBlock {
+  struct SpoolBlock* next;    // Free list or spool list link
+  uint16_t len;               // Valid payload bytes
+  uint16_t offset;            // Consumer read position within payload
+  uint8_t data[SPOOL_BLOCK_SIZE];
+} SpoolBlock;
+
+// Ordered chain of blocks belonging to one job / pipeline stage
+typedef struct {
+  SpoolBlock* head;
+  SpoolBlock* tail;
+  uint16_t count;             // Blocks in list
+  uint32_t bytes;             // Payload bytes in list
+} SpoolList;
+
+// Pool statistics snapshot
+typedef struct {
+  uint16_t total_blocks;
+  uint16_t free_blocks;
+  uint16_t in_use;
+  uint16_t high_water;        // Max blocks ever in use at once
+  uint32_t alloc_failures;    // Allocations refused because pool was empty
+  uint32_t payload_bytes;     // Bytes committed to blocks currently in use
+  uint8_t fragmentation_pct;  // Unused payload space in allocated blocks
+} SpoolPoolStats;
+
+// Pool state
+typedef struct {
+  SpoolBlock blocks[SPOOL_BLOCK_COUNT];
+  SpoolBlock* free_list;
+  spin_lock_t* lock;
+  uint16_t free_count;
+  uint16_t high_water;
+  uint32_t alloc_failures;
+  uint32_t payload_bytes;
+} SpoolPool;
+
+/**
+ * Initialize pool and claim a hardware spinlock
+ */
+bool spool_pool_init(SpoolPool* pool);
+
+/**
+ * Allocate one empty block
+ * Returns NULL if pool exhausted (never blocks)
+ */
+SpoolBlock* spool_block_alloc(SpoolPool* pool);
+
+/**
+ * Return block to pool
+ */
+void spool_block_free(SpoolPool* pool, SpoolBlock* block);
+
+/**
+ * Record that len payload bytes were written into block
+ */
+void spool_block_commit(SpoolPool* pool, SpoolBlock* block, uint16_t len);
+
+/**
+ * Reset list to empty (does not free blocks)
+ */
+void spool_list_init(SpoolList* list);
+
+/**
+ * Append block to tail of list
+ */
+void spool_list_append(SpoolPool* pool, SpoolList* list, SpoolBlock* block);
+
+/**
+ * Detach block from head of list
+ * Returns NULL if list empty
+ */
+SpoolBlock* spool_list_pop(SpoolPool* pool, SpoolList* list);
+
+/**
+ * Free every block in list
+ */
+void spool_list_release(SpoolPool* pool, SpoolList* list);
+
+/**
+ * Get pool statistics
+ */
+void spool_pool_get_stats(SpoolPool* pool, SpoolPoolStats* stats);
+
+#endif // PICO_SPOOL_POOL_H
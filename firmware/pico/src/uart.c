@@ -0,0 +1,164 @@
+/**
+ * Printosk Pico - UART Communication Layer
+ *
+ * RX is interrupt-driven: the UART IRQ drains the hardware FIFO into an
+ * SPSC ring and signals an event, so the main loop can sleep in __wfe()
+ * and still see a short command within one RX-timeout period (~32 bit
+ * times) instead of waiting for a full buffer.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#include "config.h"
+#include "uart.h"
+#include "utils.h"
+#include "ring_buffer.h"
+
+RING_SPSC_DEFINE(uart_rx_ring, uint8_t, UART_RX_RING_SIZE)
+
+static uart_rx_ring_t rx_ring;
+static uart_inst_t* rx_uart;
+static volatile uint32_t rx_overruns;
+
+/**
+ * RX interrupt: FIFO -> ring
+ * Masked during flash erase and program: the ring push (and its memcpy)
+ * execute from flash. Bytes wait in the 32-byte RX FIFO meanwhile, which
+ * is why bulk data goes over the SPI link rather than this UART.
+ */
+static void __not_in_flash_func(uart_rx_irq)(void) {
+  while (uart_is_readable(rx_uart)) {
+    uint8_t c = (uint8_t)uart_get_hw(rx_uart)->dr;
+    if (!uart_rx_ring_push(&rx_ring, &c)) {
+      rx_overruns++;
+    }
+  }
+  __sev();
+}
+
+void uart_init_simple(uart_inst_t* uart, uint baud_rate) {
+  uart_init(uart, baud_rate);
+  gpio_set_function(UART_TX_PIN, GPIO_FUNC_UART);
+  gpio_set_function(UART_RX_PIN, GPIO_FUNC_UART);
+
+  // 8N1, no flow control
+  uart_set_hw_flow(uart, false, false);
+  uart_set_format(uart, 8, 1, UART_PARITY_NONE);
+  uart_set_fifo_enabled(uart, true);
+
+  uart_rx_ring_init(&rx_ring);
+  rx_uart = uart;
+  rx_overruns = 0;
+
+  int irq = uart == uart0 ? UART0_IRQ : UART1_IRQ;
+  irq_set_exclusive_handler(irq, uart_rx_irq);
+  irq_set_enabled(irq, true);
+  uart_set_irq_enables(uart, true, false);
+}
+
+bool uart_has_data(uart_inst_t* uart) {
+  (void)uart;
+  return uart_rx_ring_size(&rx_ring) > 0;
+}
+
+int uart_read_timeout(uart_inst_t* uart, uint8_t* buf, int len, uint timeout_ms) {
+  (void)uart;
+  int got = 0;
+  absolute_time_t deadline = make_timeout_time_ms(timeout_ms);
+
+  while (got < len) {
+    uint32_t n = uart_rx_ring_pop_batch(&rx_ring, buf + got, (uint32_t)(len - got));
+    if (n > 0) {
+      got += (int)n;
+      // Inter-byte timeout: restart the clock on every byte received
+      deadline = make_timeout_time_ms(timeout_ms);
+      continue;
+    }
+    if (best_effort_wfe_or_timeout(deadline)) {
+      break;
+    }
+  }
+
+  return got;
+}
+
+int uart_read_frame(uart_inst_t* uart, uint8_t* buf, int max_len, uint timeout_ms) {
+  // Hunt for a start byte without blocking; anything before it is noise
+  uint8_t c;
+  do {
+    if (!uart_rx_ring_pop(&rx_ring, &c)) {
+      return 0;
+    }
+  } while (c != FRAME_START);
+  buf[0] = c;
+
+  // [START][LEN_LO][LEN_HI][TYPE][PAYLOAD...][CRC][END]
+  if (uart_read_timeout(uart, buf + 1, 2, timeout_ms) != 2) {
+    return -1;
+  }
+  int payload_len = buf[1] | (buf[2] << 8);
+  int total = 4 + payload_len + 2;
+  if (total > max_len) {
+    log_warn("Frame too large: %d bytes\n", total);
+    return -1;
+  }
+
+  if (uart_read_timeout(uart, buf + 3, total - 3, timeout_ms) != total - 3) {
+    log_warn("Frame timeout\n");
+    return -1;
+  }
+  if (buf[total - 1] != FRAME_END) {
+    return -1;
+  }
+
+  return total;
+}
+
+uint32_t uart_rx_overruns(void) {
+  return rx_overruns;
+}
+
+bool uart_send_response(uart_inst_t* uart, const CommandResponse* response) {
+  static uint8_t frame[UART_COMMAND_BUFFER];
+  char* payload = (char*)&frame[4];
+  int max_payload = (int)sizeof(frame) - 6;
+
+  int len = snprintf(payload, (size_t)max_payload,
+    "{\"type\":%d,\"status\":%d,\"progress\":%d,\"job_id\":\"%s\",\"message\":\"%s\"}",
+    CMD_TYPE_STATUS,
+    response->status,
+    response->progress,
+    response->job_id,
+    response->message);
+  if (len < 0 || len >= max_payload) {
+    return false;
+  }
+
+  frame[0] = FRAME_START;
+  frame[1] = (uint8_t)(len & 0xFF);
+  frame[2] = (uint8_t)(len >> 8);
+  frame[3] = CMD_TYPE_STATUS;
+  frame[4 + len] = crc8(&frame[3], len + 1);
+  frame[5 + len] = FRAME_END;
+
+  uart_write_blocking(uart, frame, (size_t)len + 6);
+  return true;
+}
+
+void uart_send_debug(const char* format, ...) {
+#if ENABLE_DEBUG_LOGS
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+#else
+  (void)format;
+#endif
+}
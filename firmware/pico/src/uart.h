@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "hardware/uart.h"
 
 // Command structure (received from ESP32)
 typedef struct {
@@ -36,24 +37,36 @@ typedef struct {
 } ParseResult;
 
 /**
- * Initialize UART
+ * Initialize UART with interrupt-driven RX
  */
-void uart_init_simple(uint uart_id, uint baud_rate);
+void uart_init_simple(uart_inst_t* uart, uint baud_rate);
 
 /**
- * Check if data available on UART
+ * Check if received data is waiting
  */
-bool uart_has_data(uint uart_id);
+bool uart_has_data(uart_inst_t* uart);
 
 /**
- * Read bytes from UART with timeout
+ * Read up to len bytes; returns early once no byte has arrived for
+ * timeout_ms (inter-byte timeout). Sleeps in __wfe() while waiting.
  */
-int uart_read_timeout(uint uart_id, uint8_t* buf, int len, uint timeout_ms);
+int uart_read_timeout(uart_inst_t* uart, uint8_t* buf, int len, uint timeout_ms);
+
+/**
+ * Read one complete frame if a start byte is waiting
+ * Returns frame length, 0 if no frame pending, -1 on timeout/bad frame.
+ */
+int uart_read_frame(uart_inst_t* uart, uint8_t* buf, int max_len, uint timeout_ms);
+
+/**
+ * Bytes dropped because the RX ring was full
+ */
+uint32_t uart_rx_overruns(void);
 
 /**
  * Send response frame back to ESP32
  */
-bool uart_send_response(uint uart_id, const CommandResponse* response);
+bool uart_send_response(uart_inst_t* uart, const CommandResponse* response);
 
 /**
  * Send debug message (stdout)
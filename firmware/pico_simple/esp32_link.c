@@ -0,0 +1,182 @@
+// ESP32 link transport: hardware UART or PIO + DMA backend (see esp32_link.h)
+
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "esp32_link.h"
+
+#if ESP32_LINK_PIO
+
+#include "hardware/pio.h"
+#include "hardware/dma.h"
+#include "esp32_link.pio.h"
+
+#define LINK_PIO pio0
+#define LINK_RX_BUF_BITS 12                     // 4 KB DMA ring
+#define LINK_RX_BUF_SIZE (1u << LINK_RX_BUF_BITS)
+#define LINK_TX_BUF_SIZE 512
+
+// DMA write-address ring wrap requires natural alignment
+static uint8_t rx_buf[LINK_RX_BUF_SIZE] __attribute__((aligned(LINK_RX_BUF_SIZE)));
+static uint8_t tx_buf[LINK_TX_BUF_SIZE];
+static uint32_t rx_read;        // Bytes consumed since boot (mod 2^32)
+static uint32_t rx_rearmed;     // Bytes written by earlier runs of the RX channel
+static uint32_t rx_lost;
+static uint tx_sm, rx_sm;
+static int tx_chan, rx_chan;
+
+// Bytes the DMA has written since boot (mod 2^32), from its remaining count.
+// The ring index alone cannot tell a full lap from an empty ring.
+static inline uint32_t rx_written(void) {
+    return rx_rearmed + (0xFFFFFFFFu - dma_hw->ch[rx_chan].transfer_count);
+}
+
+// The DMA lapped the reader: what it overwrote is gone. Skip to the oldest
+// byte still intact and count the rest as lost.
+static uint32_t rx_pending(void) {
+    uint32_t pending = rx_written() - rx_read;
+    if (pending > LINK_RX_BUF_SIZE) {
+        rx_lost += pending - LINK_RX_BUF_SIZE / 2;
+        rx_read += pending - LINK_RX_BUF_SIZE / 2;
+        pending = LINK_RX_BUF_SIZE / 2;
+    }
+    return pending;
+}
+
+// RX channel ran out of transfers (~2^32 bytes): re-arm; the ring keeps its place
+static void link_dma_irq(void) {
+    if (dma_channel_get_irq0_status(rx_chan)) {
+        dma_channel_acknowledge_irq0(rx_chan);
+        rx_rearmed += 0xFFFFFFFFu;
+        dma_channel_set_trans_count(rx_chan, 0xFFFFFFFF, true);
+    }
+}
+
+void link_init(void) {
+    uint tx_offset = pio_add_program(LINK_PIO, &esp32_link_tx_program);
+    uint rx_offset = pio_add_program(LINK_PIO, &esp32_link_rx_program);
+    tx_sm = pio_claim_unused_sm(LINK_PIO, true);
+    rx_sm = pio_claim_unused_sm(LINK_PIO, true);
+    esp32_link_tx_program_init(LINK_PIO, tx_sm, tx_offset, ESP32_TX_PIN, ESP32_LINK_BAUD);
+    esp32_link_rx_program_init(LINK_PIO, rx_sm, rx_offset, ESP32_RX_PIN, ESP32_LINK_BAUD);
+
+    // TX: memory -> PIO TX FIFO, one byte per DREQ
+    tx_chan = dma_claim_unused_channel(true);
+    dma_channel_config tx_cfg = dma_channel_get_default_config(tx_chan);
+    channel_config_set_transfer_data_size(&tx_cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&tx_cfg, true);
+    channel_config_set_write_increment(&tx_cfg, false);
+    channel_config_set_dreq(&tx_cfg, pio_get_dreq(LINK_PIO, tx_sm, true));
+    dma_channel_configure(tx_chan, &tx_cfg, &LINK_PIO->txf[tx_sm], tx_buf, 0, false);
+
+    // RX: top byte of each PIO RX FIFO word -> ring, wrapping on the write side
+    rx_chan = dma_claim_unused_channel(true);
+    dma_channel_config rx_cfg = dma_channel_get_default_config(rx_chan);
+    channel_config_set_transfer_data_size(&rx_cfg, DMA_SIZE_8);
+    channel_config_set_read_increment(&rx_cfg, false);
+    channel_config_set_write_increment(&rx_cfg, true);
+    channel_config_set_ring(&rx_cfg, true, LINK_RX_BUF_BITS);
+    channel_config_set_dreq(&rx_cfg, pio_get_dreq(LINK_PIO, rx_sm, false));
+    rx_read = 0;
+    rx_rearmed = 0;
+    rx_lost = 0;
+    dma_channel_configure(rx_chan, &rx_cfg, rx_buf,
+                          (io_rw_8 *)&LINK_PIO->rxf[rx_sm] + 3, 0xFFFFFFFF, true);
+
+    dma_channel_set_irq0_enabled(rx_chan, true);
+    irq_set_exclusive_handler(DMA_IRQ_0, link_dma_irq);
+    irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void link_write(const uint8_t *data, size_t len) {
+    while (len > 0) {
+        size_t chunk = len < LINK_TX_BUF_SIZE ? len : LINK_TX_BUF_SIZE;
+        dma_channel_wait_for_finish_blocking(tx_chan);
+        memcpy(tx_buf, data, chunk);
+        dma_channel_transfer_from_buffer_now(tx_chan, tx_buf, chunk);
+        data += chunk;
+        len -= chunk;
+    }
+}
+
+bool link_getc(uint8_t *c) {
+    if (rx_pending() == 0) {
+        return false;
+    }
+    *c = rx_buf[rx_read & (LINK_RX_BUF_SIZE - 1)];
+    rx_read++;
+    return true;
+}
+
+size_t link_rx_available(void) {
+    return rx_pending();
+}
+
+uint32_t link_rx_overruns(void) {
+    rx_pending();
+    return rx_lost;
+}
+
+#else // Hardware UART
+
+#include "hardware/uart.h"
+#include "ring_buffer.h"
+
+#define LINK_UART uart1
+#define LINK_RX_RING_SIZE 1024
+
+// UART IRQ fills the ring, main loop drains it
+RING_SPSC_DEFINE(link_rx_ring, uint8_t, LINK_RX_RING_SIZE)
+static link_rx_ring_t link_rx_ring;
+static volatile uint32_t rx_lost;
+
+// Drain RX FIFO into the ring and wake the main loop
+static void __not_in_flash_func(link_uart_irq)(void) {
+    while (uart_is_readable(LINK_UART)) {
+        uint8_t c = (uint8_t)uart_get_hw(LINK_UART)->dr;
+        if (!link_rx_ring_push(&link_rx_ring, &c)) {
+            rx_lost++;
+        }
+    }
+    __sev();
+}
+
+void link_init(void) {
+    uart_init(LINK_UART, ESP32_LINK_BAUD);
+    gpio_set_function(ESP32_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(ESP32_RX_PIN, GPIO_FUNC_UART);
+    uart_set_fifo_enabled(LINK_UART, true);
+
+    link_rx_ring_init(&link_rx_ring);
+    irq_set_exclusive_handler(UART1_IRQ, link_uart_irq);
+    irq_set_enabled(UART1_IRQ, true);
+    uart_set_irq_enables(LINK_UART, true, false);
+}
+
+void link_write(const uint8_t *data, size_t len) {
+    uart_write_blocking(LINK_UART, data, len);
+}
+
+bool link_getc(uint8_t *c) {
+    return link_rx_ring_pop(&link_rx_ring, c);
+}
+
+size_t link_rx_available(void) {
+    return link_rx_ring_size(&link_rx_ring);
+}
+
+uint32_t link_rx_overruns(void) {
+    return rx_lost;
+}
+
+#endif // ESP32_LINK_PIO
+
+void link_puts(const char *s) {
+    link_write((const uint8_t *)s, strlen(s));
+}
+
+void link_putc(char c) {
+    link_write((const uint8_t *)&c, 1);
+}
@@ -0,0 +1,69 @@
+/**
+ * Printosk Pico - ESP32 link transport
+ *
+ * One byte-stream API over two interchangeable backends, chosen at build
+ * time with -DESP32_LINK_PIO=ON (CMake option):
+ *
+ * - Hardware UART (default): uart1, RX interrupt into a ring buffer.
+ * - PIO UART: one PIO state machine per direction, 8x oversampled, with DMA
+ *   on both sides. Runs the link at multi-megabaud and frees uart1.
+ *
+ * Both use GPIO 8 (TX) / GPIO 9 (RX). The ESP32's PICO_BAUD_RATE must match
+ * ESP32_LINK_BAUD.
+ */
+
+#ifndef ESP32_LINK_H
+#define ESP32_LINK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef ESP32_LINK_PIO
+#define ESP32_LINK_PIO 0
+#endif
+
+#ifndef ESP32_LINK_BAUD
+#define ESP32_LINK_BAUD 115200
+#endif
+
+#define ESP32_TX_PIN 8
+#define ESP32_RX_PIN 9
+
+#if ESP32_LINK_PIO
+// No RX interrupt: DMA drains the PIO FIFO, so idle waits poll this often
+#define ESP32_LINK_POLL_MS 1
+#endif
+
+/**
+ * Configure pins, backend and RX buffering
+ */
+void link_init(void);
+
+/**
+ * Queue bytes for transmission
+ * Hardware: blocks until they are in the UART FIFO. PIO: copies into the
+ * DMA buffer and returns once the previous transfer has drained.
+ */
+void link_write(const uint8_t *data, size_t len);
+
+void link_puts(const char *s);
+void link_putc(char c);
+
+/**
+ * Pop one received byte; false if none is buffered
+ */
+bool link_getc(uint8_t *c);
+
+/**
+ * Bytes received and not yet read
+ */
+size_t link_rx_available(void);
+
+/**
+ * Bytes lost since boot because the RX buffer was full (the reader fell
+ * behind). Any increase means the stream has a gap.
+ */
+uint32_t link_rx_overruns(void);
+
+#endif // ESP32_LINK_H
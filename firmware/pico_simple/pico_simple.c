@@ -3,12 +3,24 @@
 #include "pico/stdlib.h"
 #include "hardware/uart.h"
 #include "hardware/gpio.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "esp32_link.h"
+#include "pt.h"
+#include "boot_timeline.h"
 
-// ESP32 Communication - Hardware UART1 on GPIO 8 (TX) and GPIO 9 (RX)
-#define ESP32_UART_ID uart1
-#define ESP32_BAUD_RATE 115200
-#define ESP32_TX_PIN 8
-#define ESP32_RX_PIN 9
+// ESP32 Communication - GPIO 8 (TX) and GPIO 9 (RX), hardware UART1 or PIO
+// (selected at build time, see esp32_link.h)
+
+#if ESP32_LINK_PIO
+// UART1 is free when the ESP32 link runs on PIO: use it as a telemetry port
+#define TELEMETRY_UART_ID uart1
+#define TELEMETRY_BAUD_RATE 115200
+#define TELEMETRY_TX_PIN 4
+#define TELEMETRY_RX_PIN 5
+#endif
 
 // Printer Communication - Hardware UART0 on GPIO 0 (TX) and GPIO 1 (RX)
 // Note: USB printer communicates via TX/RX (UART protocol over USB)
@@ -19,13 +31,31 @@
 
 #define LED_PIN PICO_DEFAULT_LED_PIN
 #define RX_BUFFER_SIZE 256
+#define HEARTBEAT_INTERVAL_MS 5000
+#define WATCHDOG_TIMEOUT_MS 8000  // Must outlast the heartbeat (longest idle sleep)
+#define FAST_BOOT 1               // Skip startup blink and banner pacing
+
+#if FAST_BOOT
+#define boot_pause_ms(ms) ((void)0)
+#else
+#define boot_pause_ms(ms) sleep_ms(ms)
+#endif
 
 char esp32_rx_buffer[RX_BUFFER_SIZE];
 int esp32_rx_index = 0;
+static uint32_t link_overruns_seen;  // link_rx_overruns() already handled
+
+// Startup stage timestamps, sent to the ESP32 once boot completes
+static boot_timeline_t boot_timeline;
+
+// Heartbeat: repeating timer sets the flag, main loop sends it
+static repeating_timer_t heartbeat_timer;
+static volatile bool heartbeat_due = false;
 
 // ESC/POS Commands for EPSON L3115
 #define ESC 0x1B
 #define GS 0x1D
+#define CAN 0x18
 #define DC2 0x12
 
 // Use SDK's built-in uart_puts (no need for custom wrapper)
@@ -37,13 +67,21 @@ void uart_write_bytes(uart_inst_t *uart, const uint8_t *data, int len) {
     }
 }
 
-void setup_esp32_uart() {
-    uart_init(ESP32_UART_ID, ESP32_BAUD_RATE);
-    gpio_set_function(ESP32_TX_PIN, GPIO_FUNC_UART);
-    gpio_set_function(ESP32_RX_PIN, GPIO_FUNC_UART);
-    uart_set_fifo_enabled(ESP32_UART_ID, true);
+bool heartbeat_callback(repeating_timer_t *timer) {
+    (void)timer;
+    heartbeat_due = true;
+    __sev();
+    return true;
 }
 
+#if ESP32_LINK_PIO
+void setup_telemetry_uart() {
+    uart_init(TELEMETRY_UART_ID, TELEMETRY_BAUD_RATE);
+    gpio_set_function(TELEMETRY_TX_PIN, GPIO_FUNC_UART);
+    gpio_set_function(TELEMETRY_RX_PIN, GPIO_FUNC_UART);
+}
+#endif
+
 void setup_printer_uart() {
     uart_init(PRINTER_UART_ID, PRINTER_BAUD_RATE);
     gpio_set_function(PRINTER_TX_PIN, GPIO_FUNC_UART);
@@ -69,7 +107,6 @@ void led_blink(int times, int delay_ms) {
 void printer_init() {
     uint8_t init_cmd[] = {ESC, '@'};
     uart_write_bytes(PRINTER_UART_ID, init_cmd, 2);
-    sleep_ms(100);
 }
 
 // ESC/POS: Set text alignment (0=left, 1=center, 2=right)
@@ -95,186 +132,596 @@ void printer_linefeed(int lines) {
     for (int i = 0; i < lines; i++) {
         uart_putc(PRINTER_UART_ID, '\n');
     }
-    sleep_ms(50);
 }
 
 // ESC/POS: Cut paper
 void printer_cut() {
     uint8_t cmd[] = {GS, 'V', 0x00};
     uart_write_bytes(PRINTER_UART_ID, cmd, 3);
-    sleep_ms(200);
+}
+
+// ESC/POS: Drop buffered data, reset, then feed and cut what was printed
+void printer_flush() {
+    uint8_t cmd[] = {CAN, ESC, '@', '\n', '\n', '\n', GS, 'V', 0x00};
+    uart_write_bytes(PRINTER_UART_ID, cmd, sizeof(cmd));
+    uart_tx_wait_blocking(PRINTER_UART_ID);
 }
 
 // Send text to printer
 void printer_text(const char *text) {
     uart_puts(PRINTER_UART_ID, text);
-    sleep_ms(50);
 }
 
-// TEST: Send raw bytes to printer to verify UART works
-void test_printer_uart() {
-    uart_puts(ESP32_UART_ID, "[Pico] TEST: Sending test byte to printer...\n");
-    
-    // Send ESC character (0x1B) as test
-    uart_putc(PRINTER_UART_ID, 0x1B);
-    uart_putc(PRINTER_UART_ID, '@');
-    
-    uart_puts(ESP32_UART_ID, "[Pico] TEST: Sent ESC @ to printer\n");
-    sleep_ms(500);
-    
-    // Try simple text
-    uart_puts(ESP32_UART_ID, "[Pico] TEST: Sending 'TEST' to printer...\n");
-    uart_puts(PRINTER_UART_ID, "TEST\n\n");
-    sleep_ms(500);
-    uart_puts(ESP32_UART_ID, "[Pico] TEST: Complete\n");
+// Job checkpoints for warm restart
+// Flash (last sector): job id + file count, written once per job, survives
+// power loss. Watchdog scratch 0-3: bands completed, updated per band,
+// survives watchdog/soft resets (the SDK reboot path only uses 4-7).
+// Each resume clears one bit of the attempts byte in place, so a job that
+// keeps resetting the Pico is dropped instead of resumed forever.
+#define CHECKPOINT_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define CHECKPOINT_MAGIC 0x4A4F4232u  // "JOB2"
+#define CHECKPOINT_ACTIVE 0xFF
+#define CHECKPOINT_DONE 0x00
+#define CHECKPOINT_MAX_ATTEMPTS 3
+
+typedef struct {
+    uint32_t magic;
+    uint32_t tag;          // Hash of job id; ties scratch progress to this job
+    int32_t file_count;
+    uint8_t state;         // ACTIVE when written; cleared to DONE in place
+    uint8_t attempts;      // One bit cleared per resume (0xFF: never resumed)
+    char job_id[32];
+} JobCheckpoint;
+
+static uint8_t checkpoint_page[FLASH_PAGE_SIZE];
+
+static const JobCheckpoint *checkpoint_stored() {
+    return (const JobCheckpoint *)(XIP_BASE + CHECKPOINT_FLASH_OFFSET);
 }
 
-// Parse and execute START_PRINT command
-void handle_print_command(const char *command) {
-    // Command format: START_PRINT:jobid:filecount
+static uint32_t checkpoint_tag(const char *job_id) {
+    uint32_t hash = 2166136261u;  // FNV-1a
+    while (*job_id) {
+        hash = (hash ^ (uint8_t)*job_id++) * 16777619u;
+    }
+    return hash;
+}
+
+// Record a new job (sector erase: ~45 ms with IRQs off, once per job)
+void checkpoint_begin(const char *job_id, int file_count) {
+    memset(checkpoint_page, 0xFF, sizeof(checkpoint_page));
+    JobCheckpoint *ckpt = (JobCheckpoint *)checkpoint_page;
+    ckpt->magic = CHECKPOINT_MAGIC;
+    ckpt->tag = checkpoint_tag(job_id);
+    ckpt->file_count = file_count;
+    ckpt->state = CHECKPOINT_ACTIVE;
+    strncpy(ckpt->job_id, job_id, sizeof(ckpt->job_id) - 1);
+    ckpt->job_id[sizeof(ckpt->job_id) - 1] = '\0';
+
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_erase(CHECKPOINT_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CHECKPOINT_FLASH_OFFSET, checkpoint_page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq);
+
+    watchdog_hw->scratch[0] = 0;
+}
+
+// Record bands completed (scratch registers only, no flash wear)
+void checkpoint_band(int band) {
+    uint32_t tag = checkpoint_stored()->tag;
+    watchdog_hw->scratch[1] = (uint32_t)band;
+    watchdog_hw->scratch[2] = tag;
+    watchdog_hw->scratch[3] = ~(CHECKPOINT_MAGIC ^ (uint32_t)band ^ tag);
+    watchdog_hw->scratch[0] = CHECKPOINT_MAGIC;
+}
+
+// Job finished, failed or cancelled: nothing to resume
+void checkpoint_end() {
+    watchdog_hw->scratch[0] = 0;
+    if (checkpoint_stored()->state != CHECKPOINT_ACTIVE) {
+        return;
+    }
+    // Clear the state byte in place; 0xFF bytes leave the rest untouched
+    memset(checkpoint_page, 0xFF, sizeof(checkpoint_page));
+    ((JobCheckpoint *)checkpoint_page)->state = CHECKPOINT_DONE;
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_program(CHECKPOINT_FLASH_OFFSET, checkpoint_page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq);
+}
+
+// Resumes already attempted for the stored job
+static int checkpoint_attempts() {
+    return 8 - __builtin_popcount(checkpoint_stored()->attempts);
+}
+
+// Count a resume before running it, so a reset during it still counts
+static void checkpoint_count_attempt() {
+    uint8_t bits = checkpoint_stored()->attempts;
+    memset(checkpoint_page, 0xFF, sizeof(checkpoint_page));
+    ((JobCheckpoint *)checkpoint_page)->attempts = bits & (uint8_t)(bits - 1);
+    uint32_t irq = save_and_disable_interrupts();
+    flash_range_program(CHECKPOINT_FLASH_OFFSET, checkpoint_page, FLASH_PAGE_SIZE);
+    restore_interrupts(irq);
+}
+
+// Bands completed by an unfinished job, or -1 if there is nothing to resume
+int checkpoint_restore() {
+    const JobCheckpoint *ckpt = checkpoint_stored();
+    if (ckpt->magic != CHECKPOINT_MAGIC || ckpt->state != CHECKPOINT_ACTIVE ||
+        memchr(ckpt->job_id, '\0', sizeof(ckpt->job_id)) == NULL ||
+        ckpt->tag != checkpoint_tag(ckpt->job_id)) {
+        return -1;
+    }
+    // Scratch progress only counts if it belongs to this job (cold boot: 0)
+    uint32_t band = watchdog_hw->scratch[1];
+    if (watchdog_hw->scratch[0] == CHECKPOINT_MAGIC &&
+        watchdog_hw->scratch[2] == ckpt->tag &&
+        watchdog_hw->scratch[3] == ~(CHECKPOINT_MAGIC ^ band ^ ckpt->tag)) {
+        return (int)band;
+    }
+    return 0;
+}
+
+// Print job task: one band of printer output per run, then a timed wait.
+// Waits return to the main loop, so ESP32 commands (CANCEL, STATUS) are
+// serviced between bands and a cancel stops output within one band.
+typedef struct {
+    pt_t pt;
+    bool active;
+    bool cancel;
     char job_id[32];
-    int file_count = 0;
-    
-    uart_puts(ESP32_UART_ID, "[Pico] ===== PRINT COMMAND RECEIVED =====\n");
-    uart_puts(ESP32_UART_ID, "[Pico] Command: ");
-    uart_puts(ESP32_UART_ID, command);
-    uart_puts(ESP32_UART_ID, "\n");
-    
-    if (sscanf(command, "START_PRINT:%31[^:]:%d", job_id, &file_count) == 2) {
-        uart_puts(ESP32_UART_ID, "[Pico] [OK] Command parsed\n");
-        uart_puts(ESP32_UART_ID, "[Pico] [OK] Job: ");
-        uart_puts(ESP32_UART_ID, job_id);
-        uart_puts(ESP32_UART_ID, " Files: ");
-        char temp[16];
-        sprintf(temp, "%d\n", file_count);
-        uart_puts(ESP32_UART_ID, temp);
-        
-        led_blink(3, 100);
-        
-        // TEST: Verify UART0 is working
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 1] Testing UART0 connection...\n");
-        test_printer_uart();
-        
-        sleep_ms(1000);
-        
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 2] Initializing printer...\n");
+    int file_count;
+    int band;           // Bands completed
+    int resume_band;    // Bands before this were printed before a reset
+    int files_done;     // Files passed through to the printer
+    bool data_lost;     // Link overrun while a file was arriving
+    absolute_time_t data_deadline;
+    absolute_time_t wake;
+    absolute_time_t last_report;
+} PrintTask;
+
+static PrintTask print_task;
+
+// Current band still needs printing (false while replaying up to resume_band)
+#define PRINT_BAND_PENDING(t) ((t)->band >= (t)->resume_band)
+
+// Progress reports to the ESP32 (progress bar and ETA on its display).
+// The job is one receipt: a single page of PRINT_BANDS bands.
+#define PRINT_BANDS 8              // PRINT_BAND_END calls in print_job_thread
+#define FILE_DATA_TIMEOUT_MS 30000 // Silence allowed while waiting for file data
+#define FILE_ACK_BYTES 256         // FILE_ACK after this many bytes; the ESP32 keeps
+                                   // at most two chunks unacknowledged (fits both RX buffers)
+#define PROGRESS_REPORT_MS 250     // Minimum gap between reports; the last band always goes
+
+// File data in flight: bytes still to come, and whether they go to the printer
+static uint32_t file_left;
+static uint32_t file_size;
+static int file_index;
+static bool file_to_printer;
+static absolute_time_t file_deadline;
+
+// Stop counting off file bytes: whatever the ESP32 sends next is a command
+static void file_data_reset(void) {
+    file_left = 0;
+    file_to_printer = false;
+}
+
+static void print_report_progress(PrintTask *t) {
+    absolute_time_t now = get_absolute_time();
+    if (t->band < PRINT_BANDS &&
+        absolute_time_diff_us(t->last_report, now) < PROGRESS_REPORT_MS * 1000) {
+        return;
+    }
+    t->last_report = now;
+    char msg[80];
+    snprintf(msg, sizeof(msg), "[Pico] PROGRESS job=%s page=1/1 band=%d/%d\n",
+             t->job_id, t->band, PRINT_BANDS);
+    link_puts(msg);
+}
+
+// End the current band, checkpoint and report it, and let the printer
+// drain for `ms`
+#define PRINT_BAND_END(t, ms) \
+    do { \
+        (t)->wake = PRINT_BAND_PENDING(t) ? make_timeout_time_ms(ms) : get_absolute_time(); \
+        (t)->band++; \
+        checkpoint_band((t)->band); \
+        print_report_progress(t); \
+        PT_WAIT_UNTIL(&(t)->pt, time_reached((t)->wake)); \
+    } while (0)
+
+static char print_job_thread(PrintTask *t) {
+    // Cancellation is checked on every resume, i.e. at each band boundary
+    if (t->cancel) {
+        file_data_reset();
+        printer_flush();
+        link_puts("[Pico] [CANCELLED] Job ");
+        link_puts(t->job_id);
+        link_puts(" stopped, printer flushed\n");
+        gpio_put(LED_PIN, 0);
+        checkpoint_end();
+        t->active = false;
+        t->cancel = false;
+        PT_EXIT(&t->pt);
+    }
+
+    PT_BEGIN(&t->pt);
+
+    gpio_put(LED_PIN, 1);
+
+    // TEST: Verify UART0 is working
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 1] Testing UART0 connection...\n");
+        link_puts("[Pico] TEST: Sending test byte to printer...\n");
+        uart_putc(PRINTER_UART_ID, ESC);
+        uart_putc(PRINTER_UART_ID, '@');
+        link_puts("[Pico] TEST: Sent ESC @ to printer\n");
+    }
+    PRINT_BAND_END(t, 500);
+
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] TEST: Sending 'TEST' to printer...\n");
+        uart_puts(PRINTER_UART_ID, "TEST\n\n");
+        link_puts("[Pico] TEST: Complete\n");
+    }
+    PRINT_BAND_END(t, 1500);
+
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 2] Initializing printer...\n");
         printer_init();
-        sleep_ms(500);
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 2] Init complete\n");
-        
-        // Print header
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 3] Sending alignment...\n");
+    }
+    PRINT_BAND_END(t, 600);
+
+    // Print header
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 2] Init complete\n");
+        link_puts("[Pico] [STEP 3] Sending alignment...\n");
         printer_set_align(1);
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 4] Setting bold...\n");
+        link_puts("[Pico] [STEP 4] Setting bold...\n");
         printer_set_bold(1);
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 5] Setting size...\n");
+        link_puts("[Pico] [STEP 5] Setting size...\n");
         printer_set_size(0x11);
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 6] Printing header...\n");
+        link_puts("[Pico] [STEP 6] Printing header...\n");
         printer_text("PRINTOSK\n");
         printer_set_bold(0);
         printer_set_size(0);
         printer_linefeed(1);
-        
-        // Print job info
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 7] Printing job info...\n");
+    }
+    PRINT_BAND_END(t, 100);
+
+    // Print job info
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 7] Printing job info...\n");
         printer_set_align(0);
         printer_text("Job ID: ");
-        printer_text(job_id);
+        printer_text(t->job_id);
         printer_text("\n");
-        
         char file_info[64];
-        sprintf(file_info, "Files: %d\n", file_count);
+        sprintf(file_info, "Files: %d\n", t->file_count);
         printer_text(file_info);
         printer_text("Status: PRINTING\n");
         printer_linefeed(2);
-        
-        // Print footer
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 8] Printing footer...\n");
+    }
+    PRINT_BAND_END(t, 300);
+
+    // File contents: requested only now, so they print after the header;
+    // the main loop passes each byte straight to the printer
+    if (PRINT_BAND_PENDING(t)) {
+        char request[96];
+        snprintf(request, sizeof(request), "[Pico] [STEP 8] SEND_FILES job=%s files=%d\n",
+                 t->job_id, t->file_count);
+        link_puts(request);
+        t->data_deadline = make_timeout_time_ms(FILE_DATA_TIMEOUT_MS);
+        t->wake = t->data_deadline;
+        PT_WAIT_UNTIL(&t->pt, t->files_done >= t->file_count || t->data_lost ||
+                              time_reached(t->data_deadline));
+        if (t->files_done < t->file_count) {
+            link_puts("[Pico] [ERROR] Job ");
+            link_puts(t->job_id);
+            link_puts(t->data_lost ? ": file data lost (link overrun)\n" : ": file data timed out\n");
+            file_data_reset();
+            printer_flush();
+            gpio_put(LED_PIN, 0);
+            checkpoint_end();
+            t->active = false;
+            PT_EXIT(&t->pt);
+        }
+    }
+    PRINT_BAND_END(t, 100);
+
+    // Print footer
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 9] Printing footer...\n");
         printer_set_align(1);
         printer_text("Thank you for printing!\n");
         printer_linefeed(1);
-        
-        // Cut paper
-        uart_puts(ESP32_UART_ID, "[Pico] [STEP 9] Cutting paper...\n");
+    }
+    PRINT_BAND_END(t, 100);
+
+    // Cut paper
+    if (PRINT_BAND_PENDING(t)) {
+        link_puts("[Pico] [STEP 10] Cutting paper...\n");
         printer_cut();
+    }
+    PRINT_BAND_END(t, 200);
+
+    // Notify ESP32
+    link_puts("[Pico] [COMPLETE] Print job finished!\n");
+    link_puts("[Pico] ===== END PRINT COMMAND =====\n");
+    file_data_reset();
+    gpio_put(LED_PIN, 0);
+    checkpoint_end();
+    t->active = false;
+
+    PT_END(&t->pt);
+}
+
+void print_task_start(const char *job_id, int file_count, int resume_band) {
+    memset(&print_task, 0, sizeof(print_task));
+    PT_INIT(&print_task.pt);
+    strcpy(print_task.job_id, job_id);
+    print_task.file_count = file_count;
+    print_task.resume_band = resume_band;
+    print_task.active = true;
+}
+
+// Pick up a job interrupted by a reset (watchdog, soft reset or power loss)
+void resume_interrupted_job() {
+    int band = checkpoint_restore();
+    if (band < 0) {
+        return;
+    }
+    const JobCheckpoint *ckpt = checkpoint_stored();
+    char msg[96];
+    if (checkpoint_attempts() >= CHECKPOINT_MAX_ATTEMPTS) {
+        snprintf(msg, sizeof(msg), "[Pico] [ERROR] Job %s dropped after %d resume attempts\n",
+                 ckpt->job_id, CHECKPOINT_MAX_ATTEMPTS);
+        link_puts(msg);
+        checkpoint_end();
+        return;
+    }
+    checkpoint_count_attempt();
+    snprintf(msg, sizeof(msg), "[Pico] RESUMING job=%s band=%d attempt=%d\n",
+             ckpt->job_id, band, checkpoint_attempts());
+    link_puts(msg);
+    print_task_start(ckpt->job_id, ckpt->file_count, band);
+}
+
+// Parse START_PRINT and hand the job to the print task
+void handle_print_command(const char *command) {
+    // Command format: START_PRINT:jobid:filecount
+    char job_id[32];
+    int file_count = 0;
+    
+    link_puts("[Pico] ===== PRINT COMMAND RECEIVED =====\n");
+    link_puts("[Pico] Command: ");
+    link_puts(command);
+    link_puts("\n");
+    
+    if (print_task.active) {
+        link_puts("[Pico] BUSY: job ");
+        link_puts(print_task.job_id);
+        link_puts(" still printing\n");
+        return;
+    }
+    
+    if (sscanf(command, "START_PRINT:%31[^:]:%d", job_id, &file_count) == 2) {
+        link_puts("[Pico] [OK] Command parsed\n");
+        link_puts("[Pico] [OK] Job: ");
+        link_puts(job_id);
+        link_puts(" Files: ");
+        char temp[16];
+        sprintf(temp, "%d\n", file_count);
+        link_puts(temp);
         
-        // Notify ESP32
-        uart_puts(ESP32_UART_ID, "[Pico] [COMPLETE] Print job finished!\n");
-        uart_puts(ESP32_UART_ID, "[Pico] ===== END PRINT COMMAND =====\n");
-        led_blink(2, 200);
+        checkpoint_begin(job_id, file_count);
+        print_task_start(job_id, file_count, 0);
     } else {
-        uart_puts(ESP32_UART_ID, "[Pico] [ERROR] Failed to parse command format\n");
+        link_puts("[Pico] [ERROR] Failed to parse command format\n");
     }
 }
 
+// Stop the running job at its next band boundary
+void handle_cancel_command() {
+    if (!print_task.active) {
+        link_puts("[Pico] CANCELLED: no active job\n");
+        return;
+    }
+    print_task.cancel = true;
+    link_puts("[Pico] CANCEL requested for job ");
+    link_puts(print_task.job_id);
+    link_puts("\n");
+}
+
+// File header: FILE:jobid:index:size, followed by size raw bytes for the printer
+void handle_file_command(const char *command) {
+    char job_id[32];
+    int index;
+    unsigned long size;
+    if (sscanf(command, "FILE:%31[^:]:%d:%lu", job_id, &index, &size) != 3) {
+        link_puts("[Pico] [ERROR] Failed to parse FILE header\n");
+        return;
+    }
+    // Not the running job's: the bytes are still counted off, then dropped
+    file_to_printer = print_task.active && strcmp(job_id, print_task.job_id) == 0;
+    char msg[80];
+    snprintf(msg, sizeof(msg), "[Pico] FILE %d: %lu bytes%s\n", index, size,
+             file_to_printer ? "" : " (no such job, discarding)");
+    link_puts(msg);
+    file_left = (uint32_t)size;
+    file_size = file_left;
+    file_index = index;
+    if (size == 0 && file_to_printer) {
+        print_task.files_done++;
+    }
+    file_deadline = make_timeout_time_ms(FILE_DATA_TIMEOUT_MS);
+    print_task.data_deadline = file_deadline;
+}
+
+// One byte of file data: to the printer unless discarded or cancelled
+static void file_data_byte(uint8_t c) {
+    bool ours = file_to_printer && print_task.active;
+    if (ours && !print_task.cancel) {
+        uart_putc_raw(PRINTER_UART_ID, (char)c);
+    }
+    if (--file_left == 0 && ours) {
+        print_task.files_done++;
+    }
+    // Flow control: the ESP32 sends more only as bytes are consumed here
+    uint32_t consumed = file_size - file_left;
+    if (consumed % FILE_ACK_BYTES == 0 || file_left == 0) {
+        char ack[40];
+        snprintf(ack, sizeof(ack), "[Pico] FILE_ACK %d %lu\n", file_index, (unsigned long)consumed);
+        link_puts(ack);
+    }
+    file_deadline = make_timeout_time_ms(FILE_DATA_TIMEOUT_MS);
+    if (ours) {
+        print_task.data_deadline = make_timeout_time_ms(FILE_DATA_TIMEOUT_MS);
+        print_task.wake = print_task.data_deadline;
+    }
+}
+
+void handle_status_command() {
+    char status[96];
+    if (print_task.active) {
+        snprintf(status, sizeof(status), "[Pico] STATUS: PRINTING job=%s band=%d%s\n",
+                 print_task.job_id, print_task.band, print_task.cancel ? " cancelling" : "");
+    } else {
+        snprintf(status, sizeof(status), "[Pico] STATUS: IDLE\n");
+    }
+    link_puts(status);
+}
+
 // Process ESP32 command buffer
 void process_command(const char *buffer) {
     if (strstr(buffer, "ESP_READY")) {
-        uart_puts(ESP32_UART_ID, "PICO_READY\n");
+        link_puts("PICO_READY\n");
     } 
     else if (strstr(buffer, "START_PRINT")) {
         handle_print_command(buffer);
     }
+    else if (strncmp(buffer, "FILE:", 5) == 0) {
+        handle_file_command(buffer);
+    }
+    else if (strstr(buffer, "CANCEL")) {
+        handle_cancel_command();
+    }
+    else if (strstr(buffer, "STATUS")) {
+        handle_status_command();
+    }
     else if (strstr(buffer, "TEST_ECHO")) {
-        uart_puts(ESP32_UART_ID, "[Pico] ECHO_RECEIVED: ");
-        uart_puts(ESP32_UART_ID, buffer);
-        uart_puts(ESP32_UART_ID, "\n");
+        link_puts("[Pico] ECHO_RECEIVED: ");
+        link_puts(buffer);
+        link_puts("\n");
         led_blink(1, 100);
     }
     else if (strlen(buffer) > 0) {
-        uart_puts(ESP32_UART_ID, "[Pico] Unknown command: ");
-        uart_puts(ESP32_UART_ID, buffer);
-        uart_puts(ESP32_UART_ID, "\n");
+        link_puts("[Pico] Unknown command: ");
+        link_puts(buffer);
+        link_puts("\n");
     }
 }
 
 int main() {
     setup_led();
-    setup_esp32_uart();
+    gpio_put(LED_PIN, 1);  // Lit until boot completes
+    link_init();
+    boot_timeline_mark(&boot_timeline, "esp32_link", time_us_32());
+#if ESP32_LINK_PIO
+    setup_telemetry_uart();
+#endif
     setup_printer_uart();
+    boot_timeline_mark(&boot_timeline, "printer_uart", time_us_32());
     
+#if !FAST_BOOT
     // Blink LED 5 times at startup
     led_blink(5, 100);
+#endif
     
     // Send detailed initialization messages
-    uart_puts(ESP32_UART_ID, "[Pico] ===== PICO INITIALIZATION START =====\n");
-    sleep_ms(100);
-    uart_puts(ESP32_UART_ID, "[Pico] LED initialized\n");
-    sleep_ms(50);
-    uart_puts(ESP32_UART_ID, "[Pico] UART1 (ESP32) initialized at 115200 baud\n");
-    sleep_ms(50);
-    uart_puts(ESP32_UART_ID, "[Pico] UART0 (Printer) initialized at 115200 baud\n");
-    sleep_ms(50);
-    uart_puts(ESP32_UART_ID, "[Pico] ===== PICO READY =====\n");
-    uart_puts(ESP32_UART_ID, "PICO_READY\n");
-    sleep_ms(100);
-    uart_puts(ESP32_UART_ID, "[Pico] Waiting for ESP32 commands...\n");
-    sleep_ms(100);
+    link_puts("[Pico] ===== PICO INITIALIZATION START =====\n");
+    boot_pause_ms(100);
+    link_puts("[Pico] LED initialized\n");
+    boot_pause_ms(50);
+#if ESP32_LINK_PIO
+    link_puts("[Pico] PIO UART (ESP32) initialized\n");
+#else
+    link_puts("[Pico] UART1 (ESP32) initialized at 115200 baud\n");
+#endif
+    boot_pause_ms(50);
+    link_puts("[Pico] UART0 (Printer) initialized at 115200 baud\n");
+    boot_pause_ms(50);
+    link_puts("[Pico] ===== PICO READY =====\n");
+    link_puts("PICO_READY\n");
+    boot_timeline_mark(&boot_timeline, "ready", time_us_32());
+    boot_pause_ms(100);
+    link_puts("[Pico] Waiting for ESP32 commands...\n");
+    boot_pause_ms(100);
+    
+    // Supervise from here on; every main loop pass feeds it
+    if (watchdog_caused_reboot()) {
+        link_puts("[Pico] Rebooted by watchdog\n");
+    }
+    watchdog_enable(WATCHDOG_TIMEOUT_MS, true);
+    
+    resume_interrupted_job();
+    boot_timeline_mark(&boot_timeline, "resume_check", time_us_32());
+    
+    char timeline[160];
+    boot_timeline_format(&boot_timeline, timeline, sizeof(timeline));
+    link_puts("[Pico] ");
+    link_puts(timeline);
+    link_puts("\n");
+#if ESP32_LINK_PIO
+    uart_puts(TELEMETRY_UART_ID, timeline);
+    uart_puts(TELEMETRY_UART_ID, "\n");
+#endif
+    gpio_put(LED_PIN, 0);
     
     // Send heartbeat every 5 seconds to verify UART working
-    int heartbeat_counter = 0;
+    add_repeating_timer_ms(HEARTBEAT_INTERVAL_MS, heartbeat_callback, NULL, &heartbeat_timer);
     
     // Main loop - listen for commands from ESP32
     memset(esp32_rx_buffer, 0, RX_BUFFER_SIZE);
     
     while (1) {
-        // Heartbeat every 5 seconds (500 * 10ms = 5000ms)
-        heartbeat_counter++;
-        if (heartbeat_counter > 500) {
-            uart_puts(ESP32_UART_ID, "[Pico] HEARTBEAT - System alive and waiting for commands\n");
-            heartbeat_counter = 0;
+        watchdog_update();
+        
+        if (heartbeat_due) {
+            heartbeat_due = false;
+            link_puts("[Pico] HEARTBEAT - System alive and waiting for commands\n");
         }
         
-        if (uart_is_readable(ESP32_UART_ID)) {
-            char c = uart_getc(ESP32_UART_ID);
-            
+        // A file cut off mid-transfer must not swallow the next commands
+        if (file_left > 0 && time_reached(file_deadline)) {
+            link_puts("[Pico] [WARN] File data stopped, dropping the rest\n");
+            file_data_reset();
+        }
+
+        uint8_t c;
+        while (link_getc(&c)) {
+            // RX buffer overran: the stream has a gap, so a file in flight
+            // is corrupt and the current command line is partial
+            if (link_rx_overruns() != link_overruns_seen) {
+                link_overruns_seen = link_rx_overruns();
+                link_puts("[Pico] [WARN] Link RX overrun, bytes lost\n");
+                if (file_left > 0 && file_to_printer && print_task.active) {
+                    print_task.data_lost = true;
+                }
+                file_data_reset();
+                esp32_rx_index = 0;
+            }
+            if (file_left > 0) {
+                file_data_byte(c);
+                continue;
+            }
             if (c == '\n') {
                 // Command complete
                 if (esp32_rx_index > 0) {
                     esp32_rx_buffer[esp32_rx_index] = '\0';
-                    uart_puts(ESP32_UART_ID, "[Pico] RECEIVED: ");
-                    uart_puts(ESP32_UART_ID, esp32_rx_buffer);
-                    uart_puts(ESP32_UART_ID, "\n");
+                    link_puts("[Pico] RECEIVED: ");
+                    link_puts(esp32_rx_buffer);
+                    link_puts("\n");
                     process_command(esp32_rx_buffer);
                     memset(esp32_rx_buffer, 0, RX_BUFFER_SIZE);
                     esp32_rx_index = 0;
@@ -289,7 +736,30 @@ int main() {
             }
         }
         
-        sleep_ms(10);
+        // Run the print job up to its next band boundary
+        if (print_task.active) {
+            print_job_thread(&print_task);
+        }
+        
+        // Sleep until the UART or heartbeat IRQ fires, or the print job's
+        // band delay expires (no missed wakeups: an IRQ after the checks
+        // above leaves the event flag set)
+        if (!heartbeat_due && link_rx_available() == 0) {
+#if ESP32_LINK_PIO
+            // PIO RX has no interrupt: wake at least every poll interval
+            absolute_time_t deadline = make_timeout_time_ms(ESP32_LINK_POLL_MS);
+            if (print_task.active && absolute_time_diff_us(print_task.wake, deadline) > 0) {
+                deadline = print_task.wake;
+            }
+            best_effort_wfe_or_timeout(deadline);
+#else
+            if (print_task.active) {
+                best_effort_wfe_or_timeout(print_task.wake);
+            } else {
+                __wfe();
+            }
+#endif
+        }
     }
     
     return 0;
@@ -0,0 +1,238 @@
+/**
+ * Printosk - Flash Spool Test
+ * Runs pico/src/flash_spool.c against an emulated NOR flash: jobs are
+ * uploaded, read back and drained for several laps of the 1 MB log, the
+ * log fills when nothing drains, an unfinished upload can be aborted, and
+ * the index survives a power cycle.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "flash_spool.h"
+#include "test_check.h"
+
+#define JOB_BYTES (48 * 1024 + 123)        // Not page aligned
+#define LARGE_JOB_BYTES (100 * 1024 + 7)    // Fills the log before the index
+
+static FlashSpool spool;
+
+static uint8_t pattern(uint32_t job, uint32_t offset) {
+  return (uint8_t)(job * 31 + offset * 7 + (offset >> 8));
+}
+
+static int find_job(uint32_t number) {
+  char job_id[37];
+  snprintf(job_id, sizeof(job_id), "job-%u", number);
+  return flash_spool_find(&spool, job_id);
+}
+
+/**
+ * Upload one job, running erase-ahead whenever the write path runs short
+ * (what the link handlers do). Returns false when the log is full.
+ */
+static bool upload_job(uint32_t number, uint32_t bytes) {
+  char job_id[37];
+  snprintf(job_id, sizeof(job_id), "job-%u", number);
+  while (!flash_spool_job_begin(&spool, job_id)) {
+    if (!flash_spool_poll(&spool)) {
+      return false;
+    }
+  }
+
+  uint8_t chunk[1000];
+  uint32_t written = 0;
+  while (written < bytes) {
+    uint32_t n = bytes - written < sizeof(chunk) ? bytes - written : sizeof(chunk);
+    for (uint32_t i = 0; i < n; i++) {
+      chunk[i] = pattern(number, written + i);
+    }
+    uint32_t done = 0;
+    while (done < n) {
+      done += flash_spool_write(&spool, chunk + done, n - done);
+      if (done < n && !flash_spool_poll(&spool)) {
+        return false;
+      }
+    }
+    written += n;
+  }
+
+  while (!flash_spool_job_end(&spool)) {
+    if (!flash_spool_poll(&spool)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Read a job back through open/read_next and compare with its pattern
+ */
+static bool verify_job(uint32_t number, uint32_t bytes) {
+  int index = find_job(number);
+  if (index < 0) {
+    fprintf(stderr, "job-%u not found\n", number);
+    return false;
+  }
+
+  SpoolReader reader;
+  REQUIRE(flash_spool_open(&spool, index, &reader));
+  uint32_t offset = 0;
+  uint16_t len;
+  const uint8_t* data;
+  while ((data = flash_spool_read_next(&spool, &reader, &len)) != NULL) {
+    for (uint16_t i = 0; i < len; i++) {
+      if (data[i] != pattern(number, offset + i)) {
+        fprintf(stderr, "job-%u: mismatch at %u\n", number, offset + i);
+        return false;
+      }
+    }
+    offset += len;
+  }
+  return offset == bytes && flash_spool_job(&spool, index)->bytes == bytes;
+}
+
+static void drain_job(uint32_t number) {
+  CHECK(flash_spool_job_drained(&spool, find_job(number)));
+}
+
+static void power_cycle(void) {
+  memset(&spool, 0xA5, sizeof(spool));  // RAM state is lost
+  REQUIRE(flash_spool_init(&spool));
+}
+
+/**
+ * Upload, print and drain jobs for three laps of the log, keeping one job
+ * queued behind the one printing (the ESP32 uploading ahead)
+ */
+static void wrap_around(void) {
+  const uint32_t jobs = 3 * SPOOL_FLASH_SIZE / JOB_BYTES;
+  REQUIRE(upload_job(0, JOB_BYTES));
+  for (uint32_t n = 1; n < jobs; n++) {
+    REQUIRE(upload_job(n, JOB_BYTES));
+    CHECK(verify_job(n - 1, JOB_BYTES));
+    drain_job(n - 1);
+  }
+  CHECK(verify_job(jobs - 1, JOB_BYTES));
+
+  CHECK(spool.head_page > 3 * SPOOL_PAGE_COUNT - 2 * JOB_BYTES / SPOOL_PAGE_PAYLOAD);
+  CHECK_EQ(spool.job_count, 1);
+
+  // Each sector was erased once per pass of the head after the first (the
+  // flash started blank), plus the erase-ahead
+  uint32_t written = spool.head_page / SPOOL_PAGES_PER_SECTOR;
+  CHECK(spool.sectors_erased >= written - SPOOL_PAGE_COUNT / SPOOL_PAGES_PER_SECTOR);
+  CHECK(spool.sectors_erased <= written + SPOOL_ERASE_AHEAD_SECTORS + 1);
+
+  // The queued job survives a power cycle after the wrap
+  uint32_t head = spool.head_page;
+  power_cycle();
+  CHECK(spool.head_page >= head);
+  CHECK(find_job(jobs - 2) < 0);
+  CHECK_EQ(flash_spool_next_pending(&spool), find_job(jobs - 1));
+  CHECK(verify_job(jobs - 1, JOB_BYTES));
+  drain_job(jobs - 1);
+  CHECK_EQ(flash_spool_next_pending(&spool), -1);
+}
+
+/**
+ * Nothing drains: the log must refuse data once the oldest job's sector
+ * comes around, and accept it again after that job drains
+ */
+static void fills_without_drain(void) {
+  const uint32_t capacity = SPOOL_PAGE_COUNT * SPOOL_PAGE_PAYLOAD;
+  uint32_t uploaded = 0;
+  while (uploaded < SPOOL_MAX_JOBS && upload_job(1000 + uploaded, LARGE_JOB_BYTES)) {
+    uploaded++;
+  }
+  CHECK(uploaded < SPOOL_MAX_JOBS);
+  CHECK(uploaded * LARGE_JOB_BYTES < capacity);
+  CHECK(uploaded * LARGE_JOB_BYTES > capacity - 2 * LARGE_JOB_BYTES);
+  CHECK(spool.write_stalls > 0);
+
+  // Nothing older was overwritten
+  for (uint32_t n = 0; n < uploaded; n++) {
+    CHECK(verify_job(1000 + n, LARGE_JOB_BYTES));
+  }
+
+  // The upload cut off by the full log is discarded at the next boot
+  power_cycle();
+  CHECK(find_job(1000 + uploaded) < 0);
+  CHECK(verify_job(1000, LARGE_JOB_BYTES));
+
+  // Draining the oldest two frees their sectors for the next upload
+  drain_job(1000);
+  drain_job(1001);
+  CHECK(upload_job(2000, LARGE_JOB_BYTES));
+  CHECK(verify_job(2000, LARGE_JOB_BYTES));
+  for (uint32_t n = 2; n < uploaded; n++) {
+    CHECK(verify_job(1000 + n, LARGE_JOB_BYTES));
+    drain_job(1000 + n);
+  }
+  drain_job(2000);
+  CHECK_EQ(flash_spool_next_pending(&spool), -1);
+}
+
+/**
+ * Power cycle with a drained job, a complete job and a torn upload
+ */
+static void power_cycle_index(void) {
+  REQUIRE(upload_job(3000, JOB_BYTES));
+  REQUIRE(upload_job(3001, 1000));
+  drain_job(3000);
+  REQUIRE(flash_spool_job_begin(&spool, "job-torn"));
+  uint8_t bytes[600] = { 0 };
+  CHECK_EQ(flash_spool_write(&spool, bytes, sizeof(bytes)), sizeof(bytes));
+
+  power_cycle();
+  CHECK(flash_spool_find(&spool, "job-3000") < 0);
+  CHECK(flash_spool_find(&spool, "job-torn") < 0);
+  int pending = flash_spool_next_pending(&spool);
+  CHECK(pending >= 0 && pending == flash_spool_find(&spool, "job-3001"));
+  CHECK(verify_job(3001, 1000));
+
+  // The log continues after the torn pages
+  REQUIRE(upload_job(3002, 5000));
+  CHECK(verify_job(3002, 5000));
+  drain_job(3001);
+  drain_job(3002);
+}
+
+/**
+ * An upload that never finishes blocks the next one until it is aborted;
+ * the aborted job is never found, before or after a power cycle
+ */
+static void abort_upload(void) {
+  CHECK(!flash_spool_job_abort(&spool));   // Nothing receiving
+
+  REQUIRE(flash_spool_job_begin(&spool, "job-4000"));
+  uint8_t bytes[600] = { 0 };
+  CHECK_EQ(flash_spool_write(&spool, bytes, sizeof(bytes)), sizeof(bytes));
+  CHECK(!flash_spool_job_begin(&spool, "job-4001"));
+
+  CHECK(flash_spool_job_abort(&spool));
+  CHECK_EQ(spool.receiving, -1);
+  CHECK(!flash_spool_job_end(&spool));
+  REQUIRE(upload_job(4001, 3000));
+  CHECK(find_job(4000) < 0);
+  CHECK(verify_job(4001, 3000));
+  CHECK_EQ(flash_spool_next_pending(&spool), find_job(4001));
+
+  power_cycle();
+  CHECK(find_job(4000) < 0);
+  CHECK(verify_job(4001, 3000));
+  drain_job(4001);
+  CHECK_EQ(flash_spool_next_pending(&spool), -1);
+  CHECK_EQ(spool.tail_page, spool.head_page);   // Aborted pages are reclaimable
+}
+
+int main(void) {
+  memset(host_flash, 0xFF, sizeof(host_flash));
+  REQUIRE(flash_spool_init(&spool));
+
+  wrap_around();
+  fills_without_drain();
+  power_cycle_index();
+  abort_upload();
+  return test_summary("flash_spool_wrap");
+}
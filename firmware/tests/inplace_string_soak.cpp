@@ -0,0 +1,174 @@
+/**
+ * Printosk - Fixed-Capacity String Heap Soak
+ * Builds every string the kiosk sketch builds for a print job (typed
+ * Print ID, API URLs, Pico commands and file headers, error text) with
+ * ESP32_FINAL_FIRMWARE/inplace_string.h for 100000 jobs, counting calls
+ * to operator new: a day of kiosk traffic must not touch the heap. Also
+ * checks the contents against snprintf and the truncation rules.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <vector>
+#include "config.h"
+#include "inplace_string.h"
+#include "test_check.h"
+
+#define SOAK_JOBS 100000
+
+// ============================================================================
+// Heap accounting: every C++ allocation in the process goes through these
+// ============================================================================
+static unsigned long heapAllocations = 0;
+
+void* operator new(size_t size) {
+  heapAllocations++;
+  void* p = malloc(size ? size : 1);
+  if (p == NULL) {
+    throw std::bad_alloc();
+  }
+  return p;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  heapAllocations++;
+  return malloc(size ? size : 1);
+}
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept { return operator new(size, tag); }
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+
+// As declared in the sketch
+typedef InplaceString<160> ApiUrl;
+static InplaceString<MAX_PRINT_ID_LENGTH> currentPrintId;
+
+// ============================================================================
+// One job's strings, in the order the sketch builds them
+// ============================================================================
+static bool soakJob(uint32_t n, bool verify) {
+  char expected[192];
+  bool ok = true;
+
+  // Keypad entry, one digit per key, after an attempt that was cleared
+  char digits[8];
+  snprintf(digits, sizeof(digits), "%06lu", (unsigned long)(100000 + n % 900000));
+  currentPrintId.clear();
+  currentPrintId += '9';
+  currentPrintId.clear();
+  for (const char* c = digits; *c; c++) {
+    currentPrintId += *c;
+  }
+  ok = ok && !currentPrintId.truncated();
+  if (verify) {
+    ok = ok && currentPrintId == digits;
+  }
+
+  // Fetch
+  ApiUrl url;
+  url.printf("%s/print-job/%s", API_BASE_URL, currentPrintId.c_str());
+  if (verify) {
+    snprintf(expected, sizeof(expected), "%s/print-job/%s", API_BASE_URL, digits);
+    ok = ok && url == expected;
+  }
+
+  // Start the print; the Pico asks for files, each sent with a header
+  int files = 1 + n % 5;
+  InplaceString<48> command;
+  command.printf("START_PRINT:%s:%d", currentPrintId.c_str(), files);
+  ok = ok && !command.truncated();
+  for (int f = 0; f < files; f++) {
+    url.printf("%s/print-job/%s/download-file?raw=1&fileIndex=%d", API_BASE_URL,
+               currentPrintId.c_str(), f);
+    InplaceString<48> header;
+    header.printf("FILE:%s:%d:%lu\n", currentPrintId.c_str(), f, (unsigned long)(n * 7919UL % 4000000));
+    ok = ok && !url.truncated() && !header.truncated();
+  }
+
+  // Status updates, index delta sync with a composite cursor, token refresh
+  url.printf("%s/print-job/%s/status", API_BASE_URL, currentPrintId.c_str());
+  ok = ok && !url.truncated();
+  url.printf("%s/job-index?limit=%d", API_BASE_URL, 50);
+  url.appendf("&since=%llu_%s", 1760781234567890ULL + n, currentPrintId.c_str());
+  ok = ok && !url.truncated();
+  if (verify) {
+    snprintf(expected, sizeof(expected), "%s/job-index?limit=50&since=%llu_%s", API_BASE_URL,
+             1760781234567890ULL + n, digits);
+    ok = ok && url == expected;
+  }
+  url.printf("%s/realtime-token", API_BASE_URL);
+
+  // Pico error and on-screen messages
+  InplaceString<96> error;
+  error.printf("Printer Error: %s", "[Pico] [ERROR] Job 482913: file data timed out");
+  InplaceString<24> message;
+  message.printf("Error: %d", -(int)(n % 12));
+  ok = ok && !error.truncated() && !message.truncated();
+  return ok;
+}
+
+static void heapSoak() {
+  // The counter is live: a real allocation shows up
+  unsigned long before = heapAllocations;
+  {
+    std::vector<int> probe(4);
+  }
+  CHECK_EQ(heapAllocations - before, 1);
+
+  REQUIRE(soakJob(0, true));
+
+  before = heapAllocations;
+  bool ok = true;
+  for (uint32_t n = 1; n <= SOAK_JOBS; n++) {
+    ok = soakJob(n, n % 997 == 0) && ok;
+  }
+  unsigned long allocations = heapAllocations - before;
+  printf("allocations over %d jobs: %lu\n", SOAK_JOBS, allocations);
+  CHECK(ok);
+  CHECK_EQ(allocations, 0);
+}
+
+// ============================================================================
+// Writes that do not fit are cut at the capacity and flagged
+// ============================================================================
+static void truncation() {
+  InplaceString<6> id;
+  for (const char* c = "1234567"; *c; c++) {
+    id += *c;
+  }
+  CHECK(id == "123456");
+  CHECK(id.truncated() && id.full());
+
+  id = "12";
+  CHECK(!id.truncated());
+  id += "34567";
+  CHECK(id == "123456");
+  CHECK(id.truncated());
+
+  InplaceString<8> text;
+  CHECK_EQ(text.printf("%s", "abcdefghij"), 8);
+  CHECK(text == "abcdefgh");
+  CHECK(text.truncated());
+  CHECK_EQ(text.printf("%d", 42), 2);   // printf starts over
+  CHECK(!text.truncated());
+  CHECK_EQ(text.appendf("-%s", "xyzuvw"), 8);
+  CHECK(text == "42-xyzuv");
+  CHECK(text.truncated());
+  CHECK_EQ(text.appendf("more"), 8);
+  CHECK(text == "42-xyzuv");
+
+  text.clear();
+  CHECK(text.empty() && !text.truncated() && text.c_str()[0] == '\0');
+  CHECK_EQ(InplaceString<8>::capacity(), 8);
+}
+
+int main() {
+  truncation();
+  heapSoak();
+  return test_summary("inplace_string_soak");
+}
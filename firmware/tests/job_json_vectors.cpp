@@ -0,0 +1,177 @@
+/**
+ * Printosk - Job JSON Parser Vectors
+ * Feeds common/job_json.h known fetch responses split at every byte
+ * boundary, with escapes, unknown and nested keys, and truncated or
+ * malformed input, and checks the extracted PrintJob.
+ */
+
+#include <string.h>
+#include "job_json.h"
+#include "test_check.h"
+
+static const char FETCH_RESPONSE[] =
+  "{ \"success\": true,\n"
+  "  \"printJob\": { \"id\": \"3f2b8c1e-5d7a-4e21-9b0c-7a6f1e2d3c4b\",\n"
+  "                \"print_id_numeric\": 482913, \"status\": \"PENDING\",\n"
+  "                \"color_mode\": \"COLOR\", \"paper_size\": \"A4\",\n"
+  "                \"duplex_mode\": \"LONG_EDGE\", \"copies\": 2,\n"
+  "                \"job_title\": \"Thesis, final\", \"price\": 12.5e0 },\n"
+  "  \"files\": [ { \"page_count\": 3, \"name\": \"a.pdf\" },\n"
+  "             { \"name\": \"b.pdf\", \"page_count\": 10 } ] }";
+
+static bool parse(PrintJob* job, const char* json, size_t len) {
+  JobJsonParser parser(job);
+  return parser.feed(json, len) && parser.finish() && parser.success();
+}
+
+static void checkFetchResponse(const PrintJob& job) {
+  CHECK(strcmp(job.id, "3f2b8c1e-5d7a-4e21-9b0c-7a6f1e2d3c4b") == 0);
+  CHECK_EQ(job.print_id_numeric, 482913);
+  CHECK(strcmp(job.status, "PENDING") == 0);
+  CHECK(job.color_mode);
+  CHECK(strcmp(job.paper_size, "A4") == 0);
+  CHECK(job.double_sided);
+  CHECK_EQ(job.copies, 2);
+  CHECK_EQ(job.file_count, 2);
+  CHECK_EQ(job.total_pages, 13);
+}
+
+/**
+ * The body arrives in whatever pieces the TCP stack hands over; every
+ * two-way split and byte-at-a-time feeding must give the same job
+ */
+static void splitTokens() {
+  const size_t len = strlen(FETCH_RESPONSE);
+  PrintJob job;
+
+  REQUIRE(parse(&job, FETCH_RESPONSE, len));
+  checkFetchResponse(job);
+
+  for (size_t split = 1; split < len; split++) {
+    JobJsonParser parser(&job);
+    CHECK(parser.feed(FETCH_RESPONSE, split));
+    CHECK(parser.feed(FETCH_RESPONSE + split, len - split));
+    CHECK(parser.finish() && parser.success());
+    checkFetchResponse(job);
+  }
+
+  JobJsonParser parser(&job);
+  for (size_t i = 0; i < len; i++) {
+    CHECK(parser.feed(FETCH_RESPONSE + i, 1));
+  }
+  CHECK(parser.finish() && parser.success());
+  checkFetchResponse(job);
+}
+
+static void escapes() {
+  PrintJob job;
+  const char json[] =
+    "{\"success\":true,\"printJob\":{"
+    "\"status\":\"PEN\\\"DI\\\\NG\","
+    "\"paper_size\":\"A4\\/\\u00e9\\n\","
+    "\"id\":\"\\u0041\\u0042x\","
+    "\"co\\u0070ies\":7,"              // Escaped key: not "copies"
+    "\"copies\":1}}";
+  REQUIRE(parse(&job, json, strlen(json)));
+  CHECK(strcmp(job.status, "PEN\"DI\\NG") == 0);
+  CHECK(strcmp(job.paper_size, "A4/?\n") == 0);
+  CHECK(strcmp(job.id, "??x") == 0);
+  CHECK_EQ(job.copies, 1);
+
+  // \u needs four hex digits
+  JobJsonParser parser(&job);
+  CHECK(!parser.feed("{\"id\":\"\\u00g0\"}", 15));
+}
+
+/**
+ * Keys the parser does not know are skipped with their whole value, and
+ * known names only count in their own section
+ */
+static void unknownKeys() {
+  PrintJob job;
+  const char json[] =
+    "{\"meta\":{\"id\":\"nested\",\"copies\":9,\"files\":[{\"page_count\":50}]},"
+    "\"success\":true,"
+    "\"list\":[1,[2,{\"printJob\":{\"copies\":8}}],\"x\",null,false],"
+    "\"printJob\":{\"extra\":{\"id\":\"deeper\",\"copies\":6},"
+                  "\"copies_requested_by_the_customer_long_key\":5,"
+                  "\"id\":\"real\",\"copies\":1,\"tags\":[\"copies\",3]},"
+    "\"files\":[{\"page_count\":4,\"pages\":{\"page_count\":40}},[{\"page_count\":99}],7],"
+    "\"copies\":11}";
+  REQUIRE(parse(&job, json, strlen(json)));
+  CHECK(strcmp(job.id, "real") == 0);
+  CHECK_EQ(job.copies, 1);
+  CHECK_EQ(job.file_count, 1);
+  CHECK_EQ(job.total_pages, 4);
+
+  // A string "true" is not success, and a quoted page_count is not counted
+  const char quoted[] = "{\"success\":\"true\",\"files\":[{\"page_count\":\"5\"}]}";
+  JobJsonParser parser(&job);
+  CHECK(parser.feed(quoted, strlen(quoted)) && parser.finish());
+  CHECK(!parser.success());
+  CHECK_EQ(job.total_pages, 0);
+  CHECK_EQ(job.file_count, 1);
+
+  // Empty containers
+  const char empty[] = "{\"printJob\":{},\"files\":[],\"success\":true,\"x\":[{}]}";
+  REQUIRE(parse(&job, empty, strlen(empty)));
+  CHECK_EQ(job.file_count, 0);
+  CHECK(job.id[0] == '\0');
+
+  // Long values are truncated to the field, not overrun
+  const char longValue[] =
+    "{\"success\":true,\"printJob\":{\"paper_size\":\"ABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789\"}}";
+  REQUIRE(parse(&job, longValue, strlen(longValue)));
+  CHECK_EQ(strlen(job.paper_size), sizeof(job.paper_size) - 1);
+  CHECK(strncmp(job.paper_size, "ABCDEFGHIJKLMNOPQRS", sizeof(job.paper_size) - 1) == 0);
+}
+
+/**
+ * A connection dropped mid-body must never look like a complete job
+ */
+static void truncatedInput() {
+  const size_t len = strlen(FETCH_RESPONSE);
+  PrintJob job;
+  for (size_t cut = 0; cut < len; cut++) {
+    JobJsonParser parser(&job);
+    parser.feed(FETCH_RESPONSE, cut);
+    CHECK(!parser.finish());
+  }
+}
+
+static void malformedInput() {
+  static const char* const bad[] = {
+    "{\"success\":}",
+    "{\"success\" true}",
+    "{\"success\":true,}",
+    "{success:true}",
+    "[1,2,]",
+    "{\"a\":[}",
+    "{\"a\":1]",
+    "{\"a\":1} {\"b\":2}",        // Trailing document
+    "{\"a\":@}",
+    "{\"a\":[[[[[[[[[1]]]]]]]]]}", // Deeper than JOB_JSON_MAX_DEPTH
+  };
+  PrintJob job;
+  for (const char* json : bad) {
+    JobJsonParser parser(&job);
+    bool accepted = parser.feed(json, strlen(json)) && parser.finish();
+    if (accepted) {
+      fprintf(stderr, "accepted malformed input: %s\n", json);
+    }
+    CHECK(!accepted);
+  }
+
+  // Whitespace after the document is fine
+  JobJsonParser parser(&job);
+  CHECK(parser.feed("{\"success\":true}\r\n  ", 20) && parser.finish() && parser.success());
+}
+
+int main() {
+  splitTokens();
+  escapes();
+  unknownKeys();
+  truncatedInput();
+  malformedInput();
+  return test_summary("job_json_vectors");
+}
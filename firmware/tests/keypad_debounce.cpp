@@ -0,0 +1,228 @@
+/**
+ * Printosk - Keypad Debounce Simulation
+ * Runs ESP32_FINAL_FIRMWARE/keypad_driver.h against simulated buttons and
+ * a simulated clock (stubs/arduino): contact bounce, glitches too short to
+ * count, the KEYPAD_DEBOUNCE_SAMPLES hold before a change is reported,
+ * rollover between keys, and type-ahead overflowing the event queue.
+ */
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "freertos/timers.h"
+#include "keypad_driver.h"
+#include "test_check.h"
+
+#define TICK_US (KEYPAD_DEBOUNCE_TICK_MS * 1000u)
+#define DEBOUNCE_US (KEYPAD_DEBOUNCE_SAMPLES * TICK_US)
+
+static const int PINS[] = { 13, 12, 14 };
+static const int KEY_COUNT = sizeof(PINS) / sizeof(PINS[0]);
+
+static KeypadDriver keypad;
+
+static void press(int key) { host_set_pin(PINS[key], LOW); }
+static void release(int key) { host_set_pin(PINS[key], HIGH); }
+
+/**
+ * Mechanical contact: a few ms of chatter before the level holds.
+ * Returns the time of the first edge, which events must report.
+ */
+static uint32_t bounce(int key, int level) {
+  uint32_t first = micros();
+  static const uint32_t chatterUs[] = { 150, 400, 250, 700, 300, 550 };
+  for (uint32_t i = 0; i < sizeof(chatterUs) / sizeof(chatterUs[0]); i++) {
+    host_set_pin(PINS[key], (i % 2 == 0) ? level : !level);
+    host_advance_us(chatterUs[i]);
+  }
+  host_set_pin(PINS[key], level);
+  return first;
+}
+
+static int drain(KeyEvent* events, int max) {
+  int n = 0;
+  KeyEvent event;
+  while (keypad.read(&event)) {
+    if (n < max) {
+      events[n] = event;
+    }
+    n++;
+  }
+  return n;
+}
+
+static void idleAtBoot() {
+  REQUIRE(keypad.begin(PINS, KEY_COUNT));
+  host_advance_us(50000);
+  KeyEvent events[4];
+  CHECK_EQ(drain(events, 4), 0);
+  CHECK_EQ(host_timers_running(), 0);   // Nothing to settle: the timer stops
+  CHECK(keypad.ticks <= 1);
+}
+
+/**
+ * Chatter on press and release gives one DOWN and one UP, stamped with
+ * the first edge of each, not the moment they settled
+ */
+static void bouncedPress() {
+  uint32_t downAt = bounce(0, LOW);
+  host_advance_us(40000);
+  uint32_t upAt = bounce(0, HIGH);
+  host_advance_us(40000);
+
+  KeyEvent events[4];
+  REQUIRE(drain(events, 4) == 2);
+  CHECK_EQ(events[0].key, 0);
+  CHECK_EQ(events[0].type, KEY_DOWN);
+  CHECK_EQ(events[0].timeUs, downAt | 1);
+  CHECK_EQ(events[1].key, 0);
+  CHECK_EQ(events[1].type, KEY_UP);
+  CHECK_EQ(events[1].timeUs, upAt | 1);
+  CHECK(!keypad.isDown(0));
+  CHECK_EQ(host_timers_running(), 0);
+}
+
+/**
+ * Pulses shorter than the debounce time never become events, and a
+ * glitch's edge does not date a real press that follows later
+ */
+static void glitchRejection() {
+  // Between two samples
+  press(1);
+  host_advance_us(100);
+  release(1);
+  host_advance_us(50000);
+
+  // Seen by a few samples, fewer than KEYPAD_DEBOUNCE_SAMPLES
+  press(1);
+  host_advance_us(DEBOUNCE_US - 2 * TICK_US);
+  release(1);
+  host_advance_us(50000);
+
+  KeyEvent events[4];
+  CHECK_EQ(drain(events, 4), 0);
+  CHECK(!keypad.isDown(1));
+
+  // A glitch, then a real press well after it
+  press(1);
+  host_advance_us(300);
+  release(1);
+  host_advance_us(KEYPAD_EDGE_MAX_AGE_US + 10000);
+  uint32_t downAt = micros();
+  press(1);
+  host_advance_us(40000);
+  release(1);
+  host_advance_us(40000);
+  REQUIRE(drain(events, 4) == 2);
+  CHECK_EQ(events[0].type, KEY_DOWN);
+  CHECK_EQ(events[0].timeUs, downAt | 1);
+}
+
+/**
+ * DOWN comes only after KEYPAD_DEBOUNCE_SAMPLES pressed samples in a row;
+ * a sampled bounce starts the count over. A long hold costs no ticks.
+ */
+static void holdSamples() {
+  KeyEvent events[4];
+
+  // The edge arms the timer; the Nth sample is N ticks later
+  press(2);
+  host_advance_us(DEBOUNCE_US - TICK_US / 2);
+  CHECK_EQ(drain(events, 4), 0);
+  CHECK(!keypad.isDown(2));
+  host_advance_us(TICK_US);
+  REQUIRE(drain(events, 4) == 1);
+  CHECK_EQ(events[0].type, KEY_DOWN);
+  CHECK(keypad.isDown(2));
+
+  // Held for 2 s: the timer stopped once the key settled
+  uint32_t ticks = keypad.ticks;
+  host_advance_us(2000000);
+  CHECK_EQ(keypad.ticks - ticks, 0);
+  CHECK_EQ(host_timers_running(), 0);
+
+  // Released with one sampled bounce back to pressed half way through
+  release(2);
+  host_advance_us(DEBOUNCE_US / 2);
+  press(2);
+  host_advance_us(TICK_US);
+  release(2);
+  host_advance_us(DEBOUNCE_US - TICK_US);
+  CHECK_EQ(drain(events, 4), 0);   // Count restarted at the bounce
+  CHECK(keypad.isDown(2));
+  host_advance_us(DEBOUNCE_US);
+  REQUIRE(drain(events, 4) == 1);
+  CHECK_EQ(events[0].type, KEY_UP);
+  CHECK(!keypad.isDown(2));
+}
+
+/**
+ * Overlapping presses come out in the order they happened
+ */
+static void rollover() {
+  uint32_t aDown = bounce(0, LOW);
+  host_advance_us(5000);
+  uint32_t bDown = bounce(1, LOW);          // Before A's DOWN is reported
+  host_advance_us(30000);
+  uint32_t aUp = bounce(0, HIGH);
+  host_advance_us(5000);
+  uint32_t bUp = bounce(1, HIGH);
+  host_advance_us(40000);
+
+  KeyEvent events[8];
+  REQUIRE(drain(events, 8) == 4);
+  CHECK(events[0].key == 0 && events[0].type == KEY_DOWN && events[0].timeUs == (aDown | 1));
+  CHECK(events[1].key == 1 && events[1].type == KEY_DOWN && events[1].timeUs == (bDown | 1));
+  CHECK(events[2].key == 0 && events[2].type == KEY_UP && events[2].timeUs == (aUp | 1));
+  CHECK(events[3].key == 1 && events[3].type == KEY_UP && events[3].timeUs == (bUp | 1));
+}
+
+/**
+ * Type-ahead past the queue: the oldest KEYPAD_QUEUE_DEPTH events are
+ * kept, the rest counted as dropped
+ */
+static void queueOverflow() {
+  const int presses = KEYPAD_QUEUE_DEPTH;   // Two events each
+  uint32_t events0 = keypad.events;
+  uint32_t dropped0 = keypad.dropped;
+  uint32_t firstDown = 0;
+  for (int i = 0; i < presses; i++) {
+    uint32_t at = bounce(i % KEY_COUNT, LOW);
+    if (i == 0) {
+      firstDown = at;
+    }
+    host_advance_us(25000);
+    bounce(i % KEY_COUNT, HIGH);
+    host_advance_us(25000);
+  }
+
+  KeyEvent events[KEYPAD_QUEUE_DEPTH];
+  CHECK_EQ(drain(events, KEYPAD_QUEUE_DEPTH), KEYPAD_QUEUE_DEPTH);
+  CHECK_EQ(keypad.events - events0, KEYPAD_QUEUE_DEPTH);
+  CHECK_EQ(keypad.dropped - dropped0, 2 * presses - KEYPAD_QUEUE_DEPTH);
+  CHECK_EQ(events[0].timeUs, firstDown | 1);
+  for (int i = 0; i < KEYPAD_QUEUE_DEPTH; i++) {
+    CHECK_EQ(events[i].key, (i / 2) % KEY_COUNT);
+    CHECK_EQ(events[i].type, i % 2 == 0 ? KEY_DOWN : KEY_UP);
+    if (i > 0) {
+      CHECK(events[i].timeUs > events[i - 1].timeUs);
+    }
+  }
+
+  // Reading makes room again
+  bounce(0, LOW);
+  host_advance_us(40000);
+  CHECK_EQ(drain(events, KEYPAD_QUEUE_DEPTH), 1);
+  bounce(0, HIGH);
+  host_advance_us(40000);
+  CHECK_EQ(drain(events, KEYPAD_QUEUE_DEPTH), 1);
+}
+
+int main() {
+  idleAtBoot();
+  bouncedPress();
+  glitchRejection();
+  holdSamples();
+  rollover();
+  queueOverflow();
+  return test_summary("keypad_debounce");
+}
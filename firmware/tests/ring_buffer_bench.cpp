@@ -0,0 +1,235 @@
+/**
+ * Printosk - Ring Buffer Benchmark
+ * Throughput of the lock-free rings against a mutex-protected std::deque,
+ * the shape of queue they replaced. Host numbers only rank the variants;
+ * absolute rates on the ESP32 / RP2040 are far lower.
+ *
+ *   ./ring_buffer_bench [items]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ring_buffer.h"
+
+using printosk::MpscRing;
+using printosk::SpscRing;
+
+static const uint32_t CAPACITY = 1024;
+static const uint32_t BATCH = 32;
+static const uint32_t MPSC_PRODUCERS = 4;
+
+typedef std::chrono::steady_clock Clock;
+
+static void report(const char* name, uint32_t items, Clock::time_point start) {
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  printf("  %-28s %8.1f Mitems/s\n", name, items / seconds / 1e6);
+}
+
+// Full or empty: give the other side the CPU (matters on few-core hosts)
+static inline void idle() {
+  std::this_thread::yield();
+}
+
+// Prevents the consumer loops from being optimized away
+static volatile uint32_t sink;
+
+static void spscSingle(uint32_t items) {
+  static SpscRing<uint32_t, CAPACITY> ring;
+  Clock::time_point start = Clock::now();
+  std::thread producer([items] {
+    for (uint32_t i = 0; i < items; ) {
+      if (ring.push(i)) {
+        i++;
+      } else {
+        idle();
+      }
+    }
+  });
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < items; ) {
+    uint32_t item;
+    if (ring.pop(item)) {
+      sum += item;
+      i++;
+    } else {
+      idle();
+    }
+  }
+  producer.join();
+  sink = sum;
+  report("spsc push/pop", items, start);
+}
+
+static void spscBatch(uint32_t items) {
+  static SpscRing<uint32_t, CAPACITY> ring;
+  Clock::time_point start = Clock::now();
+  std::thread producer([items] {
+    uint32_t batch[BATCH];
+    for (uint32_t i = 0; i < items; ) {
+      uint32_t n = items - i < BATCH ? items - i : BATCH;
+      for (uint32_t k = 0; k < n; k++) {
+        batch[k] = i + k;
+      }
+      uint32_t pushed = ring.pushBatch(batch, n);
+      if (pushed == 0) {
+        idle();
+      }
+      i += pushed;
+    }
+  });
+  uint32_t sum = 0;
+  uint32_t batch[BATCH];
+  for (uint32_t i = 0; i < items; ) {
+    uint32_t n = ring.popBatch(batch, BATCH);
+    for (uint32_t k = 0; k < n; k++) {
+      sum += batch[k];
+    }
+    if (n == 0) {
+      idle();
+    }
+    i += n;
+  }
+  producer.join();
+  sink = sum;
+  report("spsc batch(32)", items, start);
+}
+
+static void spscZeroCopy(uint32_t items) {
+  static SpscRing<uint32_t, CAPACITY> ring;
+  Clock::time_point start = Clock::now();
+  std::thread producer([items] {
+    for (uint32_t i = 0; i < items; ) {
+      uint32_t span;
+      uint32_t* slots = ring.writeReserve(&span);
+      if (span > items - i) {
+        span = items - i;
+      }
+      for (uint32_t k = 0; k < span; k++) {
+        slots[k] = i + k;
+      }
+      ring.writeCommit(span);
+      if (span == 0) {
+        idle();
+      }
+      i += span;
+    }
+  });
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < items; ) {
+    uint32_t span;
+    const uint32_t* slots = ring.readPeek(&span);
+    for (uint32_t k = 0; k < span; k++) {
+      sum += slots[k];
+    }
+    ring.readRelease(span);
+    if (span == 0) {
+      idle();
+    }
+    i += span;
+  }
+  producer.join();
+  sink = sum;
+  report("spsc reserve/peek", items, start);
+}
+
+static void mpscSingle(uint32_t items) {
+  static MpscRing<uint32_t, CAPACITY> ring;
+  uint32_t perProducer = items / MPSC_PRODUCERS;
+  Clock::time_point start = Clock::now();
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+    producers.emplace_back([perProducer] {
+      for (uint32_t i = 0; i < perProducer; ) {
+        if (ring.push(i)) {
+          i++;
+        } else {
+          idle();
+        }
+      }
+    });
+  }
+  uint32_t sum = 0;
+  uint32_t batch[BATCH];
+  for (uint32_t i = 0; i < perProducer * MPSC_PRODUCERS; ) {
+    uint32_t n = ring.popBatch(batch, BATCH);
+    for (uint32_t k = 0; k < n; k++) {
+      sum += batch[k];
+    }
+    if (n == 0) {
+      idle();
+    }
+    i += n;
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  sink = sum;
+  report("mpsc push x4", perProducer * MPSC_PRODUCERS, start);
+}
+
+static void mutexDeque(uint32_t items, uint32_t producerCount, const char* name) {
+  std::mutex lock;
+  std::deque<uint32_t> queue;
+  uint32_t perProducer = items / producerCount;
+  Clock::time_point start = Clock::now();
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < producerCount; p++) {
+    producers.emplace_back([&, perProducer] {
+      for (uint32_t i = 0; i < perProducer; ) {
+        bool pushed = false;
+        {
+          std::lock_guard<std::mutex> guard(lock);
+          if (queue.size() < CAPACITY) {
+            queue.push_back(i);
+            pushed = true;
+          }
+        }
+        if (pushed) {
+          i++;
+        } else {
+          idle();
+        }
+      }
+    });
+  }
+  uint32_t sum = 0;
+  for (uint32_t i = 0; i < perProducer * producerCount; ) {
+    bool popped = false;
+    {
+      std::lock_guard<std::mutex> guard(lock);
+      if (!queue.empty()) {
+        sum += queue.front();
+        queue.pop_front();
+        popped = true;
+      }
+    }
+    if (popped) {
+      i++;
+    } else {
+      idle();
+    }
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+  sink = sum;
+  report(name, perProducer * producerCount, start);
+}
+
+int main(int argc, char** argv) {
+  uint32_t items = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 20000000;
+  printf("ring_buffer_bench: %u items, capacity %u\n", items, CAPACITY);
+  spscSingle(items);
+  spscBatch(items);
+  spscZeroCopy(items);
+  mutexDeque(items, 1, "mutex+deque (1 producer)");
+  mpscSingle(items);
+  mutexDeque(items, MPSC_PRODUCERS, "mutex+deque (4 producers)");
+  return 0;
+}
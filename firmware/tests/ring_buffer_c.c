@@ -0,0 +1,140 @@
+/**
+ * Printosk - Ring Buffer Stress Test (C macros)
+ * Same checks as ring_buffer_stress.cpp against the C11 instantiations the
+ * Pico firmware uses (RING_SPSC_DEFINE / RING_MPSC_DEFINE), so the
+ * stdatomic.h path of the portability layer is exercised too.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include "ring_buffer.h"
+#include "test_check.h"
+
+#define SPSC_ITEMS 1000000u
+#define MPSC_PRODUCERS 3u
+#define MPSC_ITEMS_PER_PRODUCER 200000u
+
+RING_SPSC_DEFINE(byte_ring, uint8_t, 16)
+RING_MPSC_DEFINE(word_ring, uint32_t, 16)
+
+static byte_ring_t spsc;
+static word_ring_t mpsc;
+
+// ============================================================================
+// SPSC: byte stream with batch writes and zero-copy reads (UART RX pattern)
+// ============================================================================
+
+static void* spsc_producer(void* arg) {
+  (void)arg;
+  uint32_t next = 0;
+  while (next < SPSC_ITEMS) {
+    uint8_t chunk[7];
+    uint32_t n = 1 + next % 7;
+    if (n > SPSC_ITEMS - next) {
+      n = SPSC_ITEMS - next;
+    }
+    for (uint32_t i = 0; i < n; i++) {
+      chunk[i] = (uint8_t)(next + i);
+    }
+    uint32_t pushed = byte_ring_push_batch(&spsc, chunk, n);
+    next += pushed;
+    if (pushed == 0) {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void spsc_stress(void) {
+  byte_ring_init(&spsc);
+
+  pthread_t producer;
+  REQUIRE(pthread_create(&producer, NULL, spsc_producer, NULL) == 0);
+
+  uint32_t expected = 0;
+  uint32_t errors = 0;
+  while (expected < SPSC_ITEMS && errors == 0) {
+    uint32_t span;
+    const uint8_t* data = byte_ring_read_peek(&spsc, &span);
+    for (uint32_t i = 0; i < span; i++) {
+      errors += data[i] != (uint8_t)expected;
+      expected++;
+    }
+    byte_ring_read_release(&spsc, span);
+
+    uint8_t byte;
+    if (byte_ring_pop(&spsc, &byte)) {
+      errors += byte != (uint8_t)expected;
+      expected++;
+    } else if (span == 0) {
+      sched_yield();
+    }
+  }
+  pthread_join(producer, NULL);
+
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(expected, SPSC_ITEMS);
+  CHECK_EQ(byte_ring_size(&spsc), 0);
+}
+
+// ============================================================================
+// MPSC: value = producer << 24 | seq, per-producer order must hold
+// ============================================================================
+
+static void* mpsc_producer(void* arg) {
+  uint32_t producer = (uint32_t)(uintptr_t)arg;
+  uint32_t next = 0;
+  while (next < MPSC_ITEMS_PER_PRODUCER) {
+    uint32_t value = producer << 24 | next;
+    if (word_ring_push(&mpsc, &value)) {
+      next++;
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void mpsc_stress(void) {
+  word_ring_init(&mpsc);
+
+  pthread_t producers[MPSC_PRODUCERS];
+  for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+    REQUIRE(pthread_create(&producers[p], NULL, mpsc_producer, (void*)(uintptr_t)p) == 0);
+  }
+
+  uint32_t expected[MPSC_PRODUCERS] = { 0 };
+  uint32_t total = 0;
+  uint32_t errors = 0;
+  while (total < MPSC_PRODUCERS * MPSC_ITEMS_PER_PRODUCER && errors == 0) {
+    uint32_t values[8];
+    uint32_t n = word_ring_pop_batch(&mpsc, values, 8);
+    for (uint32_t i = 0; i < n; i++) {
+      uint32_t producer = values[i] >> 24;
+      uint32_t seq = values[i] & 0xFFFFFF;
+      if (producer >= MPSC_PRODUCERS || seq != expected[producer]) {
+        errors++;
+        continue;
+      }
+      expected[producer]++;
+      total++;
+    }
+    if (n == 0) {
+      sched_yield();
+    }
+  }
+  for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+    pthread_join(producers[p], NULL);
+  }
+
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(total, MPSC_PRODUCERS * MPSC_ITEMS_PER_PRODUCER);
+  CHECK_EQ(word_ring_size(&mpsc), 0);
+}
+
+int main(void) {
+  spsc_stress();
+  mpsc_stress();
+  return test_summary("ring_buffer_c");
+}
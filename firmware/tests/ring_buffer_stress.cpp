@@ -0,0 +1,239 @@
+/**
+ * Printosk - Ring Buffer Stress Test (C++ templates)
+ * Producers and a consumer hammer small rings from real threads, so every
+ * wrap-around, full and empty edge is crossed many times. Run under
+ * ThreadSanitizer (see CMakeLists.txt), which flags any missing
+ * acquire/release pairing; the checks catch lost, duplicated and
+ * reordered items.
+ */
+
+#include <stdint.h>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include "ring_buffer.h"
+#include "test_check.h"
+
+using printosk::MpscRing;
+using printosk::SpscRing;
+
+static const uint32_t SPSC_ITEMS = 2000000;
+static const uint32_t MPSC_PRODUCERS = 4;
+static const uint32_t MPSC_ITEMS_PER_PRODUCER = 250000;
+
+/**
+ * SPSC: items 0..N-1 go through in order, mixing single, batch and
+ * zero-copy operations on both sides
+ */
+static void spscStress() {
+  static SpscRing<uint32_t, 64> ring;   // Small: forces constant wrapping
+
+  std::thread producer([] {
+    std::minstd_rand rng(1);
+    uint32_t next = 0;
+    while (next < SPSC_ITEMS) {
+      uint32_t before = next;
+      switch (rng() % 3) {
+        case 0:
+          if (ring.push(next)) {
+            next++;
+          }
+          break;
+        case 1: {
+          uint32_t batch[17];
+          uint32_t n = 1 + rng() % 17;
+          if (n > SPSC_ITEMS - next) {
+            n = SPSC_ITEMS - next;
+          }
+          for (uint32_t i = 0; i < n; i++) {
+            batch[i] = next + i;
+          }
+          next += ring.pushBatch(batch, n);
+          break;
+        }
+        default: {
+          uint32_t span;
+          uint32_t* slots = ring.writeReserve(&span);
+          if (span > SPSC_ITEMS - next) {
+            span = SPSC_ITEMS - next;
+          }
+          for (uint32_t i = 0; i < span; i++) {
+            slots[i] = next + i;
+          }
+          ring.writeCommit(span);
+          next += span;
+          break;
+        }
+      }
+      if (next == before) {
+        std::this_thread::yield();   // Full: let the consumer run
+      }
+    }
+  });
+
+  std::minstd_rand rng(2);
+  uint32_t expected = 0;
+  uint32_t errors = 0;
+  while (expected < SPSC_ITEMS && errors == 0) {
+    uint32_t before = expected;
+    switch (rng() % 3) {
+      case 0: {
+        uint32_t item;
+        if (ring.pop(item)) {
+          errors += item != expected;
+          expected++;
+        }
+        break;
+      }
+      case 1: {
+        uint32_t batch[23];
+        uint32_t n = ring.popBatch(batch, 1 + rng() % 23);
+        for (uint32_t i = 0; i < n; i++) {
+          errors += batch[i] != expected;
+          expected++;
+        }
+        break;
+      }
+      default: {
+        uint32_t span;
+        const uint32_t* slots = ring.readPeek(&span);
+        for (uint32_t i = 0; i < span; i++) {
+          errors += slots[i] != expected;
+          expected++;
+        }
+        ring.readRelease(span);
+        break;
+      }
+    }
+    if (expected == before) {
+      std::this_thread::yield();     // Empty: let the producer run
+    }
+  }
+  producer.join();
+
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(expected, SPSC_ITEMS);
+  CHECK(ring.empty());
+}
+
+struct Tagged {
+  uint32_t producer;
+  uint32_t seq;       // Per-producer, consecutive
+  uint32_t call;      // Per-producer pushBatch() call that carried it
+};
+
+/**
+ * MPSC: each producer's items arrive in order, none is lost or duplicated,
+ * and the items of one pushBatch() call are never interleaved with another
+ * producer's items
+ */
+static void mpscStress() {
+  static MpscRing<Tagged, 32> ring;
+
+  std::vector<std::thread> producers;
+  for (uint32_t p = 0; p < MPSC_PRODUCERS; p++) {
+    producers.emplace_back([p] {
+      std::minstd_rand rng(10 + p);
+      uint32_t next = 0;
+      uint32_t call = 0;
+      while (next < MPSC_ITEMS_PER_PRODUCER) {
+        Tagged batch[8];
+        uint32_t n = 1 + rng() % 8;
+        if (n > MPSC_ITEMS_PER_PRODUCER - next) {
+          n = MPSC_ITEMS_PER_PRODUCER - next;
+        }
+        call++;
+        for (uint32_t i = 0; i < n; i++) {
+          batch[i] = Tagged{ p, next + i, call };
+        }
+        uint32_t pushed = ring.pushBatch(batch, n);
+        next += pushed;
+        if (pushed == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  uint32_t expected[MPSC_PRODUCERS] = {};
+  uint32_t lastCall[MPSC_PRODUCERS] = {};
+  Tagged previous = { UINT32_MAX, 0, 0 };
+  uint32_t total = 0;
+  uint32_t errors = 0;
+  uint32_t interleaved = 0;
+  while (total < MPSC_PRODUCERS * MPSC_ITEMS_PER_PRODUCER && errors == 0) {
+    Tagged items[16];
+    uint32_t n = ring.popBatch(items, 16);
+    for (uint32_t i = 0; i < n; i++) {
+      const Tagged& item = items[i];
+      if (item.producer >= MPSC_PRODUCERS || item.seq != expected[item.producer]) {
+        errors++;
+        continue;
+      }
+      expected[item.producer]++;
+      total++;
+
+      // A call seen before must continue right where it left off
+      bool continues = previous.producer == item.producer && previous.call == item.call;
+      interleaved += lastCall[item.producer] == item.call && !continues;
+      lastCall[item.producer] = item.call;
+      previous = item;
+    }
+    if (n == 0) {
+      std::this_thread::yield();
+    }
+  }
+  for (std::thread& producer : producers) {
+    producer.join();
+  }
+
+  CHECK_EQ(errors, 0);
+  CHECK_EQ(total, MPSC_PRODUCERS * MPSC_ITEMS_PER_PRODUCER);
+  CHECK_EQ(interleaved, 0);
+  CHECK(ring.empty());
+}
+
+/**
+ * Single-threaded edges: full and empty rings, batches larger than the ring
+ */
+static void edges() {
+  SpscRing<uint8_t, 8> spsc;
+  uint8_t in[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+  uint8_t out[12] = {};
+  CHECK_EQ(spsc.popBatch(out, 12), 0);
+  CHECK_EQ(spsc.pushBatch(in, 12), 8);
+  CHECK(!spsc.push(in[0]));
+  CHECK_EQ(spsc.popBatch(out, 3), 3);
+  CHECK_EQ(spsc.pushBatch(in + 8, 4), 3);    // Wraps
+  CHECK_EQ(spsc.popBatch(out + 3, 12), 8);
+  for (int i = 0; i < 11; i++) {
+    CHECK_EQ(out[i], i);
+  }
+
+  // Zero-copy spans stop at the end of storage
+  uint32_t span;
+  spsc.writeReserve(&span);
+  CHECK_EQ(span, 5);                         // Head at index 3
+  spsc.writeCommit(5);
+  spsc.writeReserve(&span);
+  CHECK_EQ(span, 3);
+  spsc.readPeek(&span);
+  CHECK_EQ(span, 5);
+
+  MpscRing<uint32_t, 4> mpsc;
+  uint32_t values[6] = { 1, 2, 3, 4, 5, 6 };
+  uint32_t popped[6] = {};
+  CHECK_EQ(mpsc.pushBatch(values, 6), 4);
+  CHECK_EQ(mpsc.pushBatch(values, 1), 0);
+  CHECK_EQ(mpsc.popBatch(popped, 6), 4);
+  CHECK_EQ(popped[3], 4);
+  CHECK(mpsc.empty());
+}
+
+int main() {
+  edges();
+  spscStress();
+  mpscStress();
+  return test_summary("ring_buffer_stress");
+}
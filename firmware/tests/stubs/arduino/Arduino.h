@@ -0,0 +1,42 @@
+/**
+ * Host stub of the Arduino core (tests only): simulated clock and GPIO
+ * Time stands still until the test advances it (host_advance_us), which
+ * also runs due FreeRTOS software timers, so timing-dependent drivers
+ * behave the same on every run. Pin levels are set by the test; a change
+ * calls the interrupt attached to the pin, as an edge would.
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define IRAM_ATTR
+#define LOW 0
+#define HIGH 1
+#define INPUT 0x01
+#define INPUT_PULLUP 0x05
+#define CHANGE 0x03
+
+#define HOST_PIN_COUNT 40   // ESP32 GPIO 0-39
+
+// Simulated time; starts at 1 so no event happens at micros() == 0
+extern uint32_t host_now_us;
+
+uint32_t micros(void);
+uint32_t millis(void);
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(uint8_t pin);
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode);
+
+// Test side: drive a pin (calls its interrupt on a change)
+void host_set_pin(uint8_t pin, int level);
+
+// Test side: let time pass in steps, running timers as they fall due
+void host_advance_us(uint32_t us);
+
+#endif // HOST_ARDUINO_H
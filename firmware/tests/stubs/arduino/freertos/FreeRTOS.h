@@ -0,0 +1,19 @@
+/**
+ * Host stub of FreeRTOS (tests only): types and tick conversion
+ * One tick is one millisecond, as configured for the ESP32 Arduino core.
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define portYIELD_FROM_ISR() ((void)0)
+
+#endif // HOST_FREERTOS_H
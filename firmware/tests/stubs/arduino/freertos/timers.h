@@ -0,0 +1,24 @@
+/**
+ * Host stub of FreeRTOS software timers (tests only)
+ * One-shot only; callbacks run from host_advance_us() once the simulated
+ * clock reaches their expiry, as the timer task would run them.
+ */
+
+#ifndef HOST_FREERTOS_TIMERS_H
+#define HOST_FREERTOS_TIMERS_H
+
+#include "FreeRTOS.h"
+
+typedef struct HostTimer* TimerHandle_t;
+typedef void (*TimerCallbackFunction_t)(TimerHandle_t timer);
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, BaseType_t autoReload,
+                           void* id, TimerCallbackFunction_t callback);
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait);
+BaseType_t xTimerStartFromISR(TimerHandle_t timer, BaseType_t* higherPriorityTaskWoken);
+void* pvTimerGetTimerID(TimerHandle_t timer);
+
+// Test side: timers started and not yet expired
+int host_timers_running(void);
+
+#endif // HOST_FREERTOS_TIMERS_H
@@ -0,0 +1,118 @@
+/**
+ * Host stub of the Arduino core and FreeRTOS timers (tests only)
+ */
+
+#include <assert.h>
+#include "Arduino.h"
+#include "freertos/timers.h"
+
+#define HOST_TIMER_COUNT 4
+#define HOST_STEP_US 50     // Granularity of host_advance_us()
+
+struct HostTimer {
+  void* id;
+  TimerCallbackFunction_t callback;
+  uint32_t periodUs;
+  uint32_t dueUs;
+  bool running;
+};
+
+uint32_t host_now_us = 1;
+
+static int pinLevel[HOST_PIN_COUNT];
+static void (*pinIsr[HOST_PIN_COUNT])(void*);
+static void* pinIsrArg[HOST_PIN_COUNT];
+static HostTimer timers[HOST_TIMER_COUNT];
+static int timerCount;
+
+uint32_t micros(void) {
+  return host_now_us;
+}
+
+uint32_t millis(void) {
+  return host_now_us / 1000;
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  assert(pin < HOST_PIN_COUNT);
+  if (mode == INPUT_PULLUP) {
+    pinLevel[pin] = HIGH;
+  }
+}
+
+int digitalRead(uint8_t pin) {
+  assert(pin < HOST_PIN_COUNT);
+  return pinLevel[pin];
+}
+
+int digitalPinToInterrupt(uint8_t pin) {
+  return pin;
+}
+
+void attachInterruptArg(uint8_t pin, void (*isr)(void*), void* arg, int mode) {
+  assert(pin < HOST_PIN_COUNT && mode == CHANGE);
+  pinIsr[pin] = isr;
+  pinIsrArg[pin] = arg;
+}
+
+void host_set_pin(uint8_t pin, int level) {
+  assert(pin < HOST_PIN_COUNT);
+  if (pinLevel[pin] == level) {
+    return;
+  }
+  pinLevel[pin] = level;
+  if (pinIsr[pin] != NULL) {
+    pinIsr[pin](pinIsrArg[pin]);
+  }
+}
+
+void host_advance_us(uint32_t us) {
+  uint32_t end = host_now_us + us;
+  while ((int32_t)(end - host_now_us) > 0) {
+    uint32_t step = end - host_now_us < HOST_STEP_US ? end - host_now_us : HOST_STEP_US;
+    host_now_us += step;
+    for (int i = 0; i < timerCount; i++) {
+      HostTimer* timer = &timers[i];
+      if (timer->running && (int32_t)(host_now_us - timer->dueUs) >= 0) {
+        timer->running = false;
+        timer->callback(timer);
+      }
+    }
+  }
+}
+
+TimerHandle_t xTimerCreate(const char* name, TickType_t period, BaseType_t autoReload,
+                           void* id, TimerCallbackFunction_t callback) {
+  (void)name;
+  assert(autoReload == pdFALSE && timerCount < HOST_TIMER_COUNT);
+  HostTimer* timer = &timers[timerCount++];
+  timer->id = id;
+  timer->callback = callback;
+  timer->periodUs = period * 1000;
+  timer->running = false;
+  return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t wait) {
+  (void)wait;
+  timer->running = true;
+  timer->dueUs = host_now_us + timer->periodUs;
+  return pdTRUE;
+}
+
+BaseType_t xTimerStartFromISR(TimerHandle_t timer, BaseType_t* higherPriorityTaskWoken) {
+  *higherPriorityTaskWoken = pdTRUE;
+  return xTimerStart(timer, 0);
+}
+
+void* pvTimerGetTimerID(TimerHandle_t timer) {
+  return timer->id;
+}
+
+int host_timers_running(void) {
+  int running = 0;
+  for (int i = 0; i < timerCount; i++) {
+    running += timers[i].running ? 1 : 0;
+  }
+  return running;
+}
@@ -0,0 +1,29 @@
+/**
+ * Host stub of the Pico SDK (tests only): QSPI flash
+ * Flash is a RAM array standing in for the XIP window. Programming can only
+ * clear bits and erasing works on whole sectors, as on the real part.
+ */
+
+#ifndef HOST_HARDWARE_FLASH_H
+#define HOST_HARDWARE_FLASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define FLASH_PAGE_SIZE (1u << 8)
+#define FLASH_SECTOR_SIZE (1u << 12)
+
+#ifndef PICO_FLASH_SIZE_BYTES
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#endif
+
+extern uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+
+// Operation counters for tests
+extern uint32_t host_flash_erases;
+extern uint32_t host_flash_programs;
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count);
+
+#endif // HOST_HARDWARE_FLASH_H
@@ -0,0 +1,16 @@
+/**
+ * Host stub of the Pico SDK (tests only): interrupt masking is a no-op
+ */
+
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+static inline void irq_set_mask_enabled(uint32_t mask, bool enabled) {
+  (void)mask;
+  (void)enabled;
+}
+
+#endif // HOST_HARDWARE_IRQ_H
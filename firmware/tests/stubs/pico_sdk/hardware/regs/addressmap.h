@@ -0,0 +1,16 @@
+/**
+ * Host stub of the Pico SDK (tests only): XIP window and PPB live in RAM
+ */
+
+#ifndef HOST_HARDWARE_REGS_ADDRESSMAP_H
+#define HOST_HARDWARE_REGS_ADDRESSMAP_H
+
+#include <stdint.h>
+#include "hardware/flash.h"
+
+extern uint32_t host_ppb[1];
+
+#define XIP_BASE ((uintptr_t)host_flash)
+#define PPB_BASE ((uintptr_t)host_ppb)
+
+#endif // HOST_HARDWARE_REGS_ADDRESSMAP_H
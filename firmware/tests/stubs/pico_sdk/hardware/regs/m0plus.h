@@ -0,0 +1,10 @@
+/**
+ * Host stub of the Pico SDK (tests only): NVIC enable register offset
+ */
+
+#ifndef HOST_HARDWARE_REGS_M0PLUS_H
+#define HOST_HARDWARE_REGS_M0PLUS_H
+
+#define M0PLUS_NVIC_ISER_OFFSET 0
+
+#endif // HOST_HARDWARE_REGS_M0PLUS_H
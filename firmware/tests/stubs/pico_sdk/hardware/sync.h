@@ -0,0 +1,12 @@
+/**
+ * Host stub of the Pico SDK (tests only): single-threaded, nothing to sync
+ */
+
+#ifndef HOST_HARDWARE_SYNC_H
+#define HOST_HARDWARE_SYNC_H
+
+#include <stdint.h>
+
+typedef volatile uint32_t io_rw_32;
+
+#endif // HOST_HARDWARE_SYNC_H
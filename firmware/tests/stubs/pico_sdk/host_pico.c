@@ -0,0 +1,55 @@
+/**
+ * Host stub of the Pico SDK (tests only): flash array and the firmware
+ * helpers declared in pico/src/utils.h
+ */
+
+#include <assert.h>
+#include <string.h>
+#include "hardware/flash.h"
+#include "hardware/regs/addressmap.h"
+
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+uint32_t host_ppb[1];
+uint32_t host_flash_erases;
+uint32_t host_flash_programs;
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+  assert(flash_offs % FLASH_SECTOR_SIZE == 0 && count % FLASH_SECTOR_SIZE == 0);
+  assert(flash_offs + count <= sizeof(host_flash));
+  memset(&host_flash[flash_offs], 0xFF, count);
+  host_flash_erases++;
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t* data, size_t count) {
+  assert(flash_offs % FLASH_PAGE_SIZE == 0 && count % FLASH_PAGE_SIZE == 0);
+  assert(flash_offs + count <= sizeof(host_flash));
+  for (size_t i = 0; i < count; i++) {
+    host_flash[flash_offs + i] &= data[i];  // NOR: 1 -> 0 only
+  }
+  host_flash_programs++;
+}
+
+uint8_t crc8(const uint8_t* data, int len) {
+  uint8_t crc = 0;
+  for (int i = 0; i < len; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (uint8_t)((crc & 0x80) ? (crc << 1) ^ 0x07 : crc << 1);
+    }
+  }
+  return crc;
+}
+
+int safe_strlen(const char* str, int max_len) {
+  int len = 0;
+  while (len < max_len && str[len]) {
+    len++;
+  }
+  return len;
+}
+
+void safe_strncpy(char* dest, const char* src, int dest_size) {
+  int len = safe_strlen(src, dest_size - 1);
+  memcpy(dest, src, (size_t)len);
+  dest[len] = '\0';
+}
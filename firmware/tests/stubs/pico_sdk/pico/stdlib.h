@@ -0,0 +1,24 @@
+/**
+ * Host stub of the Pico SDK (tests only): time base
+ */
+
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+
+typedef unsigned int uint;
+
+static inline uint64_t time_us_64(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+static inline uint32_t time_us_32(void) {
+  return (uint32_t)time_us_64();
+}
+
+#endif // HOST_PICO_STDLIB_H
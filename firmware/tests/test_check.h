@@ -0,0 +1,55 @@
+/**
+ * Printosk - Host Test Checks
+ * Minimal assertions for the host tests (C and C++, no framework)
+ *
+ *   CHECK(ring.size() == 0);
+ *   CHECK_EQ(popped, 42);
+ *   return test_summary("ring_buffer_stress");
+ */
+
+#ifndef PRINTOSK_TEST_CHECK_H
+#define PRINTOSK_TEST_CHECK_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      test_failures++; \
+    } \
+  } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    long long check_a_ = (long long)(a); \
+    long long check_b_ = (long long)(b); \
+    if (check_a_ != check_b_) { \
+      fprintf(stderr, "%s:%d: CHECK_EQ failed: %s == %s (%lld vs %lld)\n", \
+              __FILE__, __LINE__, #a, #b, check_a_, check_b_); \
+      test_failures++; \
+    } \
+  } while (0)
+
+// Abort the test at once (the rest would only cascade)
+#define REQUIRE(cond) \
+  do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: REQUIRE failed: %s\n", __FILE__, __LINE__, #cond); \
+      exit(1); \
+    } \
+  } while (0)
+
+static inline int test_summary(const char* name) {
+  if (test_failures > 0) {
+    fprintf(stderr, "%s: %d check(s) failed\n", name, test_failures);
+    return 1;
+  }
+  printf("%s: ok\n", name);
+  return 0;
+}
+
+#endif // PRINTOSK_TEST_CHECK_H
@@ -0,0 +1,241 @@
+#!/usr/bin/env python3
+"""
+Printosk - Realtime stand-in server
+
+Speaks the slice of the Supabase Realtime websocket protocol the kiosk
+uses (phx_join, heartbeat, broadcast), so push can be tested without a
+Supabase project or internet access. Python standard library only.
+
+    python3 realtime_standin.py [--port 4000]
+
+Point the kiosk at it (ESP32_FINAL_FIRMWARE/config.h):
+
+    #define REALTIME_URL "ws://<this-pc-ip>:4000/realtime/v1/websocket?apikey=test&vsn=1.0.0"
+
+Commands (stdin):
+    new <id> [files]        job appears (PENDING, expires in 24 h)
+    cancel <id>             job CANCELLED
+    done <id>               job COMPLETED
+    expire <id>             job still PENDING but already expired
+    job <id> <status> [files] [expires_in_s]
+    drop                    close every socket (kiosk must reconnect and rejoin)
+    kick                    phx_close the channel (kiosk must rejoin)
+    mute                    toggle heartbeat replies (kiosk must time out)
+    list                    connected clients
+"""
+
+import argparse
+import base64
+import hashlib
+import json
+import socket
+import struct
+import threading
+import time
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+TOPIC = "realtime:kiosk-jobs"
+
+clients = []            # [Client]
+clients_lock = threading.Lock()
+muted = False
+
+
+class Client:
+    def __init__(self, sock, addr):
+        self.sock = sock
+        self.addr = addr
+        self.topics = set()
+        self.send_lock = threading.Lock()
+
+    def send(self, opcode, data):
+        header = bytes([0x80 | opcode])
+        if len(data) < 126:
+            header += bytes([len(data)])
+        elif len(data) < 65536:
+            header += bytes([126]) + struct.pack(">H", len(data))
+        else:
+            header += bytes([127]) + struct.pack(">Q", len(data))
+        with self.send_lock:
+            self.sock.sendall(header + data)
+
+    def send_json(self, message):
+        self.send(0x1, json.dumps(message, separators=(",", ":")).encode())
+
+
+def recv_exact(sock, n):
+    buf = b""
+    while len(buf) < n:
+        chunk = sock.recv(n - len(buf))
+        if not chunk:
+            raise ConnectionError("closed")
+        buf += chunk
+    return buf
+
+
+def read_frame(sock):
+    b0, b1 = recv_exact(sock, 2)
+    opcode = b0 & 0x0F
+    length = b1 & 0x7F
+    if length == 126:
+        length = struct.unpack(">H", recv_exact(sock, 2))[0]
+    elif length == 127:
+        length = struct.unpack(">Q", recv_exact(sock, 8))[0]
+    if not b1 & 0x80:
+        raise ConnectionError("client frame not masked")
+    mask = recv_exact(sock, 4)
+    data = bytearray(recv_exact(sock, length))
+    for i in range(length):
+        data[i] ^= mask[i & 3]
+    return opcode, bytes(data)
+
+
+def handshake(sock):
+    request = b""
+    while b"\r\n\r\n" not in request:
+        chunk = sock.recv(1024)
+        if not chunk:
+            raise ConnectionError("closed during handshake")
+        request += chunk
+    lines = request.decode(errors="replace").split("\r\n")
+    headers = {}
+    for line in lines[1:]:
+        if ":" in line:
+            name, value = line.split(":", 1)
+            headers[name.strip().lower()] = value.strip()
+    key = headers.get("sec-websocket-key")
+    if not lines[0].startswith("GET ") or key is None:
+        sock.sendall(b"HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n")
+        raise ConnectionError("not a websocket upgrade")
+    accept = base64.b64encode(hashlib.sha1((key + WS_GUID).encode()).digest()).decode()
+    sock.sendall(("HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                  "Connection: Upgrade\r\nSec-WebSocket-Accept: %s\r\n\r\n" % accept).encode())
+    return lines[0].split(" ")[1]
+
+
+def reply(client, topic, ref, status="ok"):
+    client.send_json({"topic": topic, "event": "phx_reply",
+                      "payload": {"status": status, "response": {}}, "ref": ref})
+
+
+def serve(client):
+    try:
+        path = handshake(client.sock)
+        print("[standin] %s:%d connected (%s)" % (client.addr[0], client.addr[1], path.split("?")[0]))
+        while True:
+            opcode, data = read_frame(client.sock)
+            if opcode == 0x8:
+                client.send(0x8, b"")
+                break
+            if opcode == 0x9:
+                client.send(0xA, data)
+                continue
+            if opcode != 0x1:
+                continue
+            message = json.loads(data)
+            event, topic, ref = message.get("event"), message.get("topic"), message.get("ref")
+            if event == "heartbeat":
+                if not muted:
+                    reply(client, "phoenix", ref)
+            elif event == "phx_join":
+                client.topics.add(topic)
+                reply(client, topic, ref)
+                print("[standin] %s:%d joined %s" % (client.addr[0], client.addr[1], topic))
+            elif event == "phx_leave":
+                client.topics.discard(topic)
+                reply(client, topic, ref)
+    except (ConnectionError, OSError, ValueError) as e:
+        print("[standin] %s:%d gone (%s)" % (client.addr[0], client.addr[1], e))
+    finally:
+        with clients_lock:
+            if client in clients:
+                clients.remove(client)
+        client.sock.close()
+
+
+def broadcast(job):
+    message = {"topic": TOPIC, "event": "broadcast", "ref": None,
+               "payload": {"type": "broadcast", "event": "job", "payload": job}}
+    sent = 0
+    with clients_lock:
+        targets = [c for c in clients if TOPIC in c.topics]
+    for client in targets:
+        try:
+            client.send_json(message)
+            sent += 1
+        except OSError:
+            pass
+    print("[standin] job %s -> %d client(s)" % (json.dumps(job), sent))
+
+
+def job(print_id, status, files=1, expires_in=24 * 3600):
+    broadcast({"id": int(print_id), "status": status, "files": int(files),
+               "expires": int(time.time()) + int(expires_in)})
+
+
+def command(line):
+    global muted
+    words = line.split()
+    if not words:
+        return
+    cmd, args = words[0], words[1:]
+    if cmd == "new" and args:
+        job(args[0], "PENDING", *(args[1:2]))
+    elif cmd == "cancel" and args:
+        job(args[0], "CANCELLED", 0)
+    elif cmd == "done" and args:
+        job(args[0], "COMPLETED", 0)
+    elif cmd == "expire" and args:
+        job(args[0], "PENDING", 1, -1)
+    elif cmd == "job" and len(args) >= 2:
+        job(*args[:4])
+    elif cmd == "drop":
+        with clients_lock:
+            for client in clients:
+                client.sock.shutdown(socket.SHUT_RDWR)
+    elif cmd == "kick":
+        with clients_lock:
+            for client in clients:
+                if TOPIC in client.topics:
+                    client.topics.discard(TOPIC)
+                    client.send_json({"topic": TOPIC, "event": "phx_close", "payload": {}, "ref": None})
+    elif cmd == "mute":
+        muted = not muted
+        print("[standin] heartbeat replies %s" % ("off" if muted else "on"))
+    elif cmd == "list":
+        with clients_lock:
+            for client in clients:
+                print("[standin] %s:%d %s" % (client.addr[0], client.addr[1], sorted(client.topics)))
+    else:
+        print(__doc__.split("Commands (stdin):")[1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Printosk Realtime stand-in server")
+    parser.add_argument("--port", type=int, default=4000)
+    args = parser.parse_args()
+
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(("0.0.0.0", args.port))
+    server.listen(4)
+    print("[standin] listening on port %d, topic %s" % (args.port, TOPIC))
+
+    def accept_loop():
+        while True:
+            sock, addr = server.accept()
+            client = Client(sock, addr)
+            with clients_lock:
+                clients.append(client)
+            threading.Thread(target=serve, args=(client,), daemon=True).start()
+
+    threading.Thread(target=accept_loop, daemon=True).start()
+    try:
+        while True:
+            command(input())
+    except (EOFError, KeyboardInterrupt):
+        pass
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,49 @@
+#!/bin/bash
+# Printosk - Sync shared headers into the Arduino sketch
+#
+# The Arduino IDE only builds files inside the sketch folder, so headers
+# shared with firmware/common are copied into ESP32_FINAL_FIRMWARE/.
+# firmware/common is the source; the copies must stay byte-identical.
+#
+#   firmware/tools/sync_common_headers.sh           # copy common -> sketch
+#   firmware/tools/sync_common_headers.sh --check   # fail if any copy differs (CI)
+
+set -u
+
+REPO_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")/../.." && pwd)"
+COMMON_DIR="$REPO_DIR/firmware/common"
+SKETCH_DIR="$REPO_DIR/ESP32_FINAL_FIRMWARE"
+
+HEADERS=(
+    connection_pool.h
+    http_range.h
+    job_json.h
+    text_layout.h
+)
+
+check=0
+if [ "${1:-}" = "--check" ]; then
+    check=1
+elif [ $# -gt 0 ]; then
+    echo "usage: $0 [--check]" >&2
+    exit 2
+fi
+
+status=0
+for header in "${HEADERS[@]}"; do
+    if [ $check -eq 1 ]; then
+        if ! cmp -s "$COMMON_DIR/$header" "$SKETCH_DIR/$header"; then
+            echo "❌ ESP32_FINAL_FIRMWARE/$header differs from firmware/common/$header"
+            diff -u "$COMMON_DIR/$header" "$SKETCH_DIR/$header" | head -20
+            status=1
+        fi
+    elif ! cmp -s "$COMMON_DIR/$header" "$SKETCH_DIR/$header"; then
+        cp "$COMMON_DIR/$header" "$SKETCH_DIR/$header"
+        echo "Updated ESP32_FINAL_FIRMWARE/$header"
+    fi
+done
+
+if [ $check -eq 1 ] && [ $status -ne 0 ]; then
+    echo "Run firmware/tools/sync_common_headers.sh to update the sketch copies"
+fi
+exit $status
@@ -0,0 +1,131 @@
+/**
+ * Printosk Kiosk API - Job Index Delta Sync
+ * GET /api/kiosk/job-index?since=<cursor>&limit=<n>
+ * Kiosk devices only (X-Kiosk-Key): the response lists every open Print ID
+ *
+ * Feeds the kiosk's local Print ID index
+ * Without since: every PENDING, unexpired job (full sync)
+ * With since: every job updated after the cursor, any status, so the
+ * kiosk can drop jobs that left PENDING
+ *
+ * Compact on purpose; the ESP32 parses it into a fixed buffer:
+ * { success, server_time, cursor, more,
+ *   jobs: [{ id, status, files, expires }] }   // times in epoch seconds
+ */
+
+import { NextRequest, NextResponse } from 'next/server';
+import { supabase } from '@/lib/supabase';
+import { requireKioskDevice } from '@/lib/kioskAuth';
+
+const DEFAULT_LIMIT = 50;
+const MAX_LIMIT = 200;
+
+/**
+ * Cursor: "<updated_at in epoch microseconds>_<print_id_numeric>" of the
+ * last row sent. Rows are ordered by (updated_at, print_id_numeric) and the
+ * next page starts strictly after that pair, so rows sharing a timestamp
+ * are neither skipped nor sent twice. Microseconds match the column's
+ * precision; at most 23 characters (the kiosk stores 31).
+ */
+interface Cursor {
+  updatedAt: string;  // ISO timestamp with microseconds, for the query
+  printId: number;
+}
+
+function timestampToMicros(timestamp: string): bigint {
+  const fraction = (timestamp.match(/\.(\d+)/)?.[1] || '').padEnd(6, '0');
+  return BigInt(Date.parse(timestamp)) * BigInt(1000) + BigInt(fraction.slice(3, 6));
+}
+
+function microsToTimestamp(micros: bigint): string {
+  const ms = Number(micros / BigInt(1000));
+  const extra = String(micros % BigInt(1000)).padStart(3, '0');
+  return new Date(ms).toISOString().replace('Z', `${extra}Z`);
+}
+
+function parseCursor(since: string): Cursor | null {
+  const match = since.match(/^(\d{1,17})_(\d{1,9})$/);
+  if (!match) {
+    return null;
+  }
+  return { updatedAt: microsToTimestamp(BigInt(match[1])), printId: parseInt(match[2]) };
+}
+
+export async function GET(request: NextRequest) {
+  const unauthorized = requireKioskDevice(request);
+  if (unauthorized) {
+    return unauthorized;
+  }
+
+  try {
+    const { searchParams } = new URL(request.url);
+    const since = searchParams.get('since');
+    const limit = Math.min(parseInt(searchParams.get('limit') || '') || DEFAULT_LIMIT, MAX_LIMIT);
+    const now = new Date();
+
+    let query = supabase
+      .from('print_jobs')
+      .select('print_id_numeric, status, file_count, expires_at, updated_at')
+      .order('updated_at', { ascending: true })
+      .order('print_id_numeric', { ascending: true })
+      .limit(limit);
+
+    if (since) {
+      const cursor = parseCursor(since);
+      if (!cursor) {
+        return NextResponse.json(
+          { success: false, error: 'Invalid cursor' },
+          { status: 400 }
+        );
+      }
+      query = query.or(
+        `updated_at.gt.${cursor.updatedAt},` +
+        `and(updated_at.eq.${cursor.updatedAt},print_id_numeric.gt.${cursor.printId})`
+      );
+    } else {
+      query = query
+        .eq('status', 'PENDING')
+        .gt('expires_at', now.toISOString());
+    }
+
+    const { data: jobs, error } = await query;
+
+    if (error) {
+      console.error('[Kiosk API] Error fetching job index:', error);
+      return NextResponse.json(
+        { success: false, error: 'Failed to fetch job index' },
+        { status: 500 }
+      );
+    }
+
+    // A full sync continues from now: changes made during it arrive in the
+    // next delta (print IDs are never 0, so "_0" includes every row at now)
+    const rows = jobs || [];
+    const last = rows[rows.length - 1];
+    const cursor = last
+      ? `${timestampToMicros(last.updated_at)}_${last.print_id_numeric}`
+      : since || `${BigInt(now.getTime()) * BigInt(1000)}_0`;
+
+    return NextResponse.json(
+      {
+        success: true,
+        server_time: Math.floor(now.getTime() / 1000),
+        cursor,
+        more: rows.length === limit,
+        jobs: rows.map(j => ({
+          id: j.print_id_numeric,
+          status: j.status,
+          files: j.file_count || 0,
+          expires: Math.floor(new Date(j.expires_at).getTime() / 1000),
+        })),
+      },
+      { status: 200 }
+    );
+  } catch (error: any) {
+    console.error('[Kiosk API] Error in job index sync:', error);
+    return NextResponse.json(
+      { success: false, error: 'Internal server error' },
+      { status: 500 }
+    );
+  }
+}
@@ -4,8 +4,16 @@
  * 
  * Downloads the actual file for printing from Supabase Storage
  * Called by ESP32 kiosk to retrieve document
+ *
+ * ?raw=1 returns the bytes as application/octet-stream instead of base64
+ * JSON, with X-Content-SHA256 and X-Page-Count headers, so the kiosk can
+ * stream the body straight to flash and recognise content it already has.
+ * Raw downloads honour "Range: bytes=<first>-[<last>]" (206 with
+ * Content-Range), so a download that broke off resumes instead of starting
+ * over; If-Range is checked against the ETag (the content hash).
  */
 
+import { createHash } from 'crypto';
 import { NextRequest, NextResponse } from 'next/server';
 import { supabase } from '@/lib/supabase';
 
@@ -16,6 +24,7 @@ export async function GET(
   try {
     const printId = params.id;
     const fileIndex = request.nextUrl.searchParams.get('fileIndex') || '0';
+    const raw = request.nextUrl.searchParams.get('raw') === '1';
 
     console.log(`[Kiosk API] Downloading file for print job ${printId}, index ${fileIndex}`);
 
@@ -76,9 +85,54 @@ export async function GET(
       );
     }
 
-    // Convert to base64 for transmission
     const arrayBuffer = await fileData.arrayBuffer();
     const buffer = Buffer.from(arrayBuffer);
+
+    if (raw) {
+      const hash = createHash('sha256').update(buffer).digest('hex');
+      const headers: Record<string, string> = {
+        'Content-Type': 'application/octet-stream',
+        'Accept-Ranges': 'bytes',
+        'ETag': `"${hash}"`,
+        'X-Content-SHA256': hash,
+        'X-Page-Count': String(file.page_count || 0),
+      };
+
+      // A stale If-Range means the content changed: send all of it
+      const ifRange = request.headers.get('if-range');
+      const range = request.headers.get('range');
+      const match = range && (!ifRange || ifRange === headers['ETag'])
+        ? /^bytes=(\d+)-(\d*)$/.exec(range.trim())
+        : null;
+
+      if (match) {
+        const first = parseInt(match[1]);
+        const last = match[2] ? Math.min(parseInt(match[2]), buffer.length - 1) : buffer.length - 1;
+        if (first >= buffer.length || first > last) {
+          return new NextResponse(null, {
+            status: 416,
+            headers: { 'Content-Range': `bytes */${buffer.length}` },
+          });
+        }
+        console.log(`[Kiosk API] Resuming raw file: ${file.file_name} at ${first} of ${buffer.length} bytes`);
+        return new NextResponse(buffer.subarray(first, last + 1), {
+          status: 206,
+          headers: {
+            ...headers,
+            'Content-Length': String(last - first + 1),
+            'Content-Range': `bytes ${first}-${last}/${buffer.length}`,
+          },
+        });
+      }
+
+      console.log(`[Kiosk API] Sending raw file: ${file.file_name} (${buffer.length} bytes)`);
+      return new NextResponse(buffer, {
+        status: 200,
+        headers: { ...headers, 'Content-Length': String(buffer.length) },
+      });
+    }
+
+    // Convert to base64 for transmission
     const base64 = buffer.toString('base64');
 
     console.log(`[Kiosk API] Successfully downloaded file: ${file.file_name} (${buffer.length} bytes)`);
@@ -7,13 +7,7 @@
  */
 
 import { NextRequest, NextResponse } from 'next/server';
-import { supabase } from '@/lib/supabase';
-
-interface StatusUpdateRequest {
-  status: 'PRINTING' | 'COMPLETED' | 'ERROR' | 'PENDING';
-  error_message?: string;
-  pages_printed?: number;
-}
+import { applyJobStatusUpdate, JobStatusUpdate } from '@/lib/jobStatus';
 
 export async function PUT(
   request: NextRequest,
@@ -21,72 +15,18 @@ export async function PUT(
 ) {
   try {
     const printId = params.id;
-    const body: StatusUpdateRequest = await request.json();
+    const body: JobStatusUpdate = await request.json();
 
     console.log(`[Kiosk API] Updating print job ${printId} status:`, body.status);
 
-    // Validate status
-    const validStatuses = ['PRINTING', 'COMPLETED', 'ERROR', 'PENDING'];
-    if (!validStatuses.includes(body.status)) {
-      return NextResponse.json(
-        { success: false, error: 'Invalid status' },
-        { status: 400 }
-      );
-    }
-
-    // Get print job
-    const { data: printJob, error: jobError } = await supabase
-      .from('print_jobs')
-      .select('*')
-      .eq('print_id_numeric', parseInt(printId))
-      .single();
-
-    if (jobError || !printJob) {
-      console.error('[Kiosk API] Print job not found:', jobError);
-      return NextResponse.json(
-        { success: false, error: 'Print job not found' },
-        { status: 404 }
-      );
-    }
-
-    // Build update object
-    const updateData: any = {
-      status: body.status,
-      updated_at: new Date().toISOString(),
-    };
-
-    if (body.error_message && body.status === 'ERROR') {
-      updateData.error_message = body.error_message;
-    }
-
-    if (body.pages_printed) {
-      updateData.pages_printed = body.pages_printed;
-    }
-
-    // Update print job
-    const { error: updateError } = await supabase
-      .from('print_jobs')
-      .update(updateData)
-      .eq('id', printJob.id);
-
-    if (updateError) {
-      console.error('[Kiosk API] Error updating print job:', updateError);
+    const result = await applyJobStatusUpdate(printId, body);
+    if (!result.success) {
       return NextResponse.json(
-        { success: false, error: 'Failed to update status' },
-        { status: 500 }
+        { success: false, error: result.error },
+        { status: result.httpStatus }
       );
     }
 
-    // Log activity
-    await supabase
-      .from('activity_logs')
-      .insert([{
-        job_id: printJob.id,
-        action: `Print ${body.status}`,
-        details: body.error_message || `Job ${body.status}`,
-        timestamp: new Date().toISOString(),
-      }]);
-
     console.log(`[Kiosk API] Successfully updated print job ${printId} to ${body.status}`);
 
     return NextResponse.json(
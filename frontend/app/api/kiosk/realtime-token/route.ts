@@ -0,0 +1,67 @@
+/**
+ * Printosk Kiosk API - Realtime Access Token
+ * GET /api/kiosk/realtime-token
+ * Kiosk devices only (X-Kiosk-Key)
+ *
+ * The kiosk-jobs broadcast channel is private: Realtime lets a socket join
+ * only if its access token passes the realtime.messages policy
+ * (backend/supabase/migrations/002_kiosk_job_broadcast.sql), which checks
+ * the kiosk_device claim minted here. Short-lived; the kiosk fetches a new
+ * one before it expires and on every reconnect.
+ *
+ * { success, access_token, expires_in }   // expires_in in seconds
+ */
+
+import { NextRequest, NextResponse } from 'next/server';
+import crypto from 'crypto';
+import { requireKioskDevice } from '@/lib/kioskAuth';
+
+const TOKEN_TTL_SECONDS = 3600;
+
+function base64url(data: string | Buffer): string {
+  return Buffer.from(data).toString('base64url');
+}
+
+/**
+ * HS256 JWT signed with the project's JWT secret, as Realtime verifies it
+ */
+function signToken(claims: Record<string, unknown>, secret: string): string {
+  const header = base64url(JSON.stringify({ alg: 'HS256', typ: 'JWT' }));
+  const payload = base64url(JSON.stringify(claims));
+  const signature = crypto.createHmac('sha256', secret).update(`${header}.${payload}`).digest();
+  return `${header}.${payload}.${base64url(signature)}`;
+}
+
+export async function GET(request: NextRequest) {
+  const unauthorized = requireKioskDevice(request);
+  if (unauthorized) {
+    return unauthorized;
+  }
+
+  const secret = process.env.SUPABASE_JWT_SECRET;
+  if (!secret) {
+    console.error('[Kiosk API] SUPABASE_JWT_SECRET not configured');
+    return NextResponse.json(
+      { success: false, error: 'Realtime tokens not configured' },
+      { status: 500 }
+    );
+  }
+
+  const now = Math.floor(Date.now() / 1000);
+  const accessToken = signToken(
+    {
+      aud: 'authenticated',
+      role: 'authenticated',
+      sub: 'kiosk-device',
+      kiosk_device: true,
+      iat: now,
+      exp: now + TOKEN_TTL_SECONDS,
+    },
+    secret
+  );
+
+  return NextResponse.json(
+    { success: true, access_token: accessToken, expires_in: TOKEN_TTL_SECONDS },
+    { status: 200 }
+  );
+}
@@ -0,0 +1,78 @@
+/**
+ * Printosk Kiosk API - Batch Update Print Job Status
+ * POST /api/kiosk/status-batch
+ *
+ * Applies several status updates in one request
+ * Called by the ESP32 kiosk when its status outbox holds updates for more
+ * than one job (e.g. after a WiFi outage), to stay within the per-device
+ * rate limit
+ */
+
+import { NextRequest, NextResponse } from 'next/server';
+import { applyJobStatusUpdate, JobStatusUpdate } from '@/lib/jobStatus';
+
+interface StatusUpdate extends JobStatusUpdate {
+  print_id: string;
+}
+
+interface BatchStatusUpdateRequest {
+  updates: StatusUpdate[];
+}
+
+interface StatusUpdateResult {
+  print_id: string;
+  success: boolean;
+  error?: string;
+}
+
+const MAX_BATCH_SIZE = 16;
+
+async function applyUpdate(update: StatusUpdate): Promise<StatusUpdateResult> {
+  const result = await applyJobStatusUpdate(update.print_id, update);
+  return { print_id: update.print_id, success: result.success, error: result.error };
+}
+
+export async function POST(request: NextRequest) {
+  try {
+    const body: BatchStatusUpdateRequest = await request.json();
+
+    if (!Array.isArray(body.updates) || body.updates.length === 0 ||
+        body.updates.length > MAX_BATCH_SIZE) {
+      return NextResponse.json(
+        { success: false, error: `updates must hold 1-${MAX_BATCH_SIZE} entries` },
+        { status: 400 }
+      );
+    }
+
+    console.log(`[Kiosk API] Batch status update: ${body.updates.length} jobs`);
+
+    // Sequential: one kiosk's updates are few, and order is preserved
+    const results: StatusUpdateResult[] = [];
+    for (const update of body.updates) {
+      results.push(await applyUpdate(update));
+    }
+
+    // A database failure is worth retrying; per-job rejections are not
+    const retryable = results.some((r) => r.error === 'Failed to update status');
+    if (retryable) {
+      return NextResponse.json(
+        { success: false, error: 'Failed to update status', results },
+        { status: 500 }
+      );
+    }
+
+    return NextResponse.json(
+      {
+        success: results.every((r) => r.success),
+        results,
+      },
+      { status: 200 }
+    );
+  } catch (error: any) {
+    console.error('[Kiosk API] Error in batch status update:', error);
+    return NextResponse.json(
+      { success: false, error: 'Internal server error' },
+      { status: 500 }
+    );
+  }
+}
@@ -0,0 +1,89 @@
+/**
+ * Print job status updates reported by kiosks
+ * Shared by PUT /api/kiosk/print-job/:id/status and
+ * POST /api/kiosk/status-batch, so both accept and record the same thing.
+ */
+
+import { supabase } from '@/lib/supabase';
+
+export type KioskJobStatus = 'PRINTING' | 'COMPLETED' | 'ERROR' | 'CANCELLED' | 'PENDING';
+
+export const VALID_KIOSK_STATUSES: KioskJobStatus[] = [
+  'PRINTING',
+  'COMPLETED',
+  'ERROR',
+  'CANCELLED',
+  'PENDING',
+];
+
+export interface JobStatusUpdate {
+  status: KioskJobStatus;
+  error_message?: string;
+  pages_printed?: number;
+}
+
+export interface JobStatusResult {
+  success: boolean;
+  error?: string;
+  httpStatus: number;   // What a single-job request answers with
+}
+
+/**
+ * Validate and apply one update to the job with this Print ID, and log it
+ */
+export async function applyJobStatusUpdate(
+  printId: string,
+  update: JobStatusUpdate
+): Promise<JobStatusResult> {
+  if (!VALID_KIOSK_STATUSES.includes(update.status)) {
+    return { success: false, error: 'Invalid status', httpStatus: 400 };
+  }
+
+  // Get print job
+  const { data: printJob, error: jobError } = await supabase
+    .from('print_jobs')
+    .select('*')
+    .eq('print_id_numeric', parseInt(printId))
+    .single();
+
+  if (jobError || !printJob) {
+    console.error(`[Kiosk API] Print job ${printId} not found:`, jobError);
+    return { success: false, error: 'Print job not found', httpStatus: 404 };
+  }
+
+  // Build update object
+  const updateData: any = {
+    status: update.status,
+    updated_at: new Date().toISOString(),
+  };
+
+  if (update.error_message && update.status === 'ERROR') {
+    updateData.error_message = update.error_message;
+  }
+
+  if (update.pages_printed) {
+    updateData.pages_printed = update.pages_printed;
+  }
+
+  const { error: updateError } = await supabase
+    .from('print_jobs')
+    .update(updateData)
+    .eq('id', printJob.id);
+
+  if (updateError) {
+    console.error('[Kiosk API] Error updating print job:', updateError);
+    return { success: false, error: 'Failed to update status', httpStatus: 500 };
+  }
+
+  // Log activity
+  await supabase
+    .from('activity_logs')
+    .insert([{
+      job_id: printJob.id,
+      action: `Print ${update.status}`,
+      details: update.error_message || `Job ${update.status}`,
+      timestamp: new Date().toISOString(),
+    }]);
+
+  return { success: true, httpStatus: 200 };
+}
@@ -0,0 +1,36 @@
+/**
+ * Kiosk device authentication
+ * Endpoints that list jobs (rather than fetch one by its Print ID) are
+ * limited to kiosks: each device sends the shared KIOSK_DEVICE_KEY in the
+ * X-Kiosk-Key header.
+ */
+
+import { NextRequest, NextResponse } from 'next/server';
+import crypto from 'crypto';
+
+/**
+ * Returns an error response to send back, or null if the caller is a kiosk
+ */
+export function requireKioskDevice(request: NextRequest): NextResponse | null {
+  const deviceKey = process.env.KIOSK_DEVICE_KEY;
+  if (!deviceKey) {
+    console.error('[Kiosk API] KIOSK_DEVICE_KEY not configured');
+    return NextResponse.json(
+      { success: false, error: 'Kiosk authentication not configured' },
+      { status: 500 }
+    );
+  }
+
+  // Compare digests: equal length, so timingSafeEqual never throws
+  const presented = request.headers.get('x-kiosk-key') || '';
+  const expected = crypto.createHash('sha256').update(deviceKey).digest();
+  const actual = crypto.createHash('sha256').update(presented).digest();
+  if (!crypto.timingSafeEqual(expected, actual)) {
+    return NextResponse.json(
+      { success: false, error: 'Unauthorized' },
+      { status: 401 }
+    );
+  }
+
+  return null;
+}